@@ -29,4 +29,5 @@
 //Physics
 #include "Molecular/Physics/SimulationSpace.h"
 #include "Molecular/Physics/Atom.h"
+#include "Molecular/Physics/TrajectoryReader.h"
 #include "Molecular/Physics3D/SubatomicParticle.h"
@@ -4,33 +4,17 @@
 #include <glm.hpp>
 
 namespace Molecular{
+    // Value description of one atom: what goes into an AtomStore and what comes
+    // back out of a snapshot. Bonds are not part of it; they live in the store.
+    // Per-element properties are read from elementTable through the element id.
     class Atom{
     public:
-        Atom(glm::dvec2 position, glm::dvec2 velocity, double mass,
-             double vanDerWaalsRadius, double bondLength, double epsilon, double sigma, double electronegativity, int valence, glm::vec4 color)
-                : m_position(position), m_velocity(velocity), m_mass(mass),
-                  m_vanDerWaalsRadius(vanDerWaalsRadius), m_CovalentBondLength(bondLength),
-                  m_epsilon(epsilon), m_sigma(sigma),m_electronegativity(electronegativity), m_valence(valence), m_color(color) {}
+        Atom(ElementId element, glm::dvec2 position, glm::dvec2 velocity = {0.0, 0.0})
+                : m_position(position), m_velocity(velocity), m_previousPosition(position), m_element(element) {}
 
-        Atom(const std::string& element, glm::dvec2 position, glm::dvec2 velocity = {0.0f, 0.0f})
-        {
-            if (elementData.find(element) != elementData.end()) {
-                const auto& data = elementData[element];
-                m_mass = data.mass;
-                m_vanDerWaalsRadius = data.vanDerWaalsRadius;
-                m_CovalentBondLength = data.bondLength;
-                m_epsilon = data.epsilon;
-                m_sigma = data.sigma;
-                m_electronegativity = data.electronegativity;
-                m_valence = data.valence;
-                m_color = data.color;
-            } else {
-                throw std::runtime_error("Unknown element type: " + element);
-            }
-            m_element = element;
-            m_position = position;
-            m_velocity = velocity;
-        }
+        // Symbol lookup; throws std::runtime_error for an unknown element
+        Atom(std::string_view element, glm::dvec2 position, glm::dvec2 velocity = {0.0, 0.0})
+                : Atom(ElementFromSymbol(element), position, velocity) {}
 
         // === Floating-point ===
         glm::vec2 GetPosition() const { return glm::vec2(m_position); }
@@ -39,7 +23,7 @@ namespace Molecular{
         void SetPosition(const glm::vec2& position) { m_position = glm::dvec2(position); }
         void SetVelocity(const glm::vec2& velocity) { m_velocity = glm::dvec2(velocity); }
 
-        float GetVanDerWaalsRadius() const { return static_cast<float>(m_vanDerWaalsRadius); }
+        float GetVanDerWaalsRadius() const { return static_cast<float>(GetProperties().vanDerWaalsRadius); }
 
         // === Double-precision ===
 
@@ -52,55 +36,28 @@ namespace Molecular{
         void SetVelocity(const glm::dvec2& velocity) { m_velocity = velocity; }
         void SetCharge(double charge) { m_charge = charge; }
 
-        void TryFormBond(Atom *other);
-        void BreakBond(Atom *other);
-        void AddBond(Atom *other);
-
-        double GetMassD() const { return m_mass; }
-        double GetVanDerWaalsRadiusD() const { return m_vanDerWaalsRadius; }
-        double GetCovalentBondLengthD() const { return m_CovalentBondLength; }
-        double GetEpsilonD() const { return m_epsilon; }
-        double GetSigmaD() const { return m_sigma; }
-        double GetElectronegativity() const { return m_electronegativity; }
+        double GetMassD() const { return GetProperties().mass; }
+        double GetVanDerWaalsRadiusD() const { return GetProperties().vanDerWaalsRadius; }
+        double GetCovalentBondLengthD() const { return GetProperties().bondLength; }
+        double GetEpsilonD() const { return GetProperties().epsilon; }
+        double GetSigmaD() const { return GetProperties().sigma; }
+        double GetElectronegativity() const { return GetProperties().electronegativity; }
         double GetCharge() const { return m_charge; }
 
-        int GetValence() const { return m_valence; }
-        int GetBondCount() const { return m_bond_count; }
-
-        bool CanFormBond() const { return m_bondedAtoms.size() < static_cast<size_t>(m_valence);}
-        bool CanBondWith(const Atom* other) const;
-        bool CanFormBondWith(const Atom* other) const;
-        bool IsBondedTo(const Atom* other) const;
-        bool IsWithinBondingRange(const Atom* other) const;
-        bool ShouldBreakBondWith(const Atom* other) const;
+        int GetValence() const { return GetProperties().valence; }
 
-        glm::vec4 GetColor() const { return m_color; }
+        glm::vec4 GetColor() const { return GetProperties().color; }
 
-        std::string GetElement() const { return m_element;}
-
-        const std::vector<Atom*>& GetBonds() const { return m_bondedAtoms; }
-        std::vector<Atom*>& GetBondedAtoms() { return m_bondedAtoms; }
+        ElementId GetElementId() const { return m_element; }
+        std::string_view GetElement() const { return GetElementSymbol(m_element); }
+        const AtomProperties& GetProperties() const { return GetElementProperties(m_element); }
 
     private:
         glm::dvec2 m_position;
         glm::dvec2 m_velocity;
         glm::dvec2 m_previousPosition;
 
-        glm::vec4 m_color;
-
-        double m_mass;                  // Atomic mass (amu)
-        double m_vanDerWaalsRadius;     // Non-bonded interaction distance (nm)
-        double m_CovalentBondLength;    // Bonding interaction distance (nm)
-        double m_epsilon;               // Interaction strength (eV)
-        double m_sigma;                 // Distance where potential is zero (nm)
-        double m_electronegativity;     // Bonding preference
         double m_charge = 0.0;          // Net charge (in elementary charge units, default is neutral)
-        unsigned int m_valence;         // Max number of bonds allowed (valence rule)
-        unsigned int m_bond_count;      // Current number of bonds
-
-        std::vector<Atom*> m_bondedAtoms;
-
-        std::string m_element;
-
+        ElementId m_element;            // Row of elementTable
     };
 }
@@ -3,8 +3,22 @@
 #include "molpch.h"
 #include <glm.hpp>
 
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
 namespace Molecular {
+    // Compact element identifier; indexes elementTable
+    enum class ElementId : uint8_t {
+        H,
+        O,
+        C,
+        N
+    };
+
     struct AtomProperties {
+        std::string_view symbol;
         double mass;
         double vanDerWaalsRadius;
         double bondLength;
@@ -17,10 +31,60 @@ namespace Molecular {
         glm::vec4 color;
     };
 
-    static inline std::unordered_map<std::string, AtomProperties> elementData = {
-            {"H",  {1.008 , 0.12 , 0.074, 0.028, 0.2958, 2.2 , 1, glm::vec4(1.0f, 0.0f, 1.0f, 1.0f)}},
-            {"O",  {15.999, 0.152, 0.121, 0.095, 0.3165, 3.44, 2, glm::vec4(0.0f, 1.0f, 0.0f, 1.0f)}},
-            {"C",  {12.011, 0.17 , 0.154, 0.12 , 0.34  , 2.55, 4, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)}},
-            {"N",  {14.007, 0.155, 0.145, 0.07 , 0.325 , 3.04, 3, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)}},
-    };
-}
\ No newline at end of file
+    // Ordered like ElementId
+    inline constexpr std::array<AtomProperties, 4> elementTable = {{
+            {"H", 1.008 , 0.12 , 0.074, 0.028, 0.2958, 2.2 , 1, glm::vec4(1.0f, 0.0f, 1.0f, 1.0f)},
+            {"O", 15.999, 0.152, 0.121, 0.095, 0.3165, 3.44, 2, glm::vec4(0.0f, 1.0f, 0.0f, 1.0f)},
+            {"C", 12.011, 0.17 , 0.154, 0.12 , 0.34  , 2.55, 4, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)},
+            {"N", 14.007, 0.155, 0.145, 0.07 , 0.325 , 3.04, 3, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)},
+    }};
+
+    inline constexpr size_t ElementCount = elementTable.size();
+
+    // Largest valence in the table; sizes the inline bond slots
+    inline constexpr size_t MaxValence = [] {
+        size_t maxValence = 0;
+        for (const auto& properties : elementTable) {
+            if (static_cast<size_t>(properties.valence) > maxValence) {
+                maxValence = static_cast<size_t>(properties.valence);
+            }
+        }
+        return maxValence;
+    }();
+
+    // Longest covalent bond length in the table; bounds the bonding search radius
+    inline constexpr double MaxBondLength = [] {
+        double maxBondLength = 0.0;
+        for (const auto& properties : elementTable) {
+            if (properties.bondLength > maxBondLength) {
+                maxBondLength = properties.bondLength;
+            }
+        }
+        return maxBondLength;
+    }();
+
+    constexpr const AtomProperties& GetElementProperties(const ElementId element) {
+        return elementTable[static_cast<size_t>(element)];
+    }
+
+    constexpr std::string_view GetElementSymbol(const ElementId element) {
+        return GetElementProperties(element).symbol;
+    }
+
+    // Symbol lookup, for the API boundary (UI, files); everything inside works on ElementId
+    constexpr std::optional<ElementId> FindElement(const std::string_view symbol) {
+        for (size_t i = 0; i < ElementCount; ++i) {
+            if (elementTable[i].symbol == symbol) {
+                return static_cast<ElementId>(i);
+            }
+        }
+        return std::nullopt;
+    }
+
+    inline ElementId ElementFromSymbol(const std::string_view symbol) {
+        if (const auto element = FindElement(symbol)) {
+            return *element;
+        }
+        throw std::runtime_error("Unknown element type: " + std::string(symbol));
+    }
+}
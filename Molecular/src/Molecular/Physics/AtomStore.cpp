@@ -0,0 +1,291 @@
+#include "AtomStore.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace Molecular
+{
+    size_t AtomStore::Add(const Atom& atom)
+    {
+        const glm::dvec2 position = atom.GetPositionD();
+        const glm::dvec2 velocity = atom.GetVelocityD();
+        const size_t index = size();
+
+        m_x.push_back(position.x);
+        m_y.push_back(position.y);
+        m_vx.push_back(velocity.x);
+        m_vy.push_back(velocity.y);
+        m_fx.push_back(0.0);
+        m_fy.push_back(0.0);
+        m_previousX.push_back(position.x);
+        m_previousY.push_back(position.y);
+        m_mass.push_back(atom.GetMassD());
+        m_inverseMass.push_back(1.0 / atom.GetMassD());
+        m_charge.push_back(atom.GetCharge());
+        m_element.push_back(atom.GetElementId());
+        m_bonds.emplace_back();
+        m_id.push_back(AcquireSlot(index));
+
+        return index;
+    }
+
+    void AtomStore::Remove(const size_t index)
+    {
+        if (index >= size()) return;
+
+        // Drop every bond to the atom, then shift indices above it down by one
+        for (const uint32_t bonded : BondSlots(m_bonds[index])) {
+            BreakBond(index, bonded);
+        }
+        for (auto& bonds : m_bonds) {
+            for (auto& bonded : bonds) {
+                if (bonded > index) --bonded;
+            }
+        }
+
+        ReleaseSlot(m_id[index]);
+        m_bondEdgesDirty = true;
+        ForEachArray([index](auto& values) { values.erase(values.begin() + static_cast<std::ptrdiff_t>(index)); });
+        for (size_t i = index; i < size(); ++i) {
+            m_slotIndex[m_id[i]] = static_cast<uint32_t>(i);
+        }
+    }
+
+    void AtomStore::SwapRemove(const size_t index)
+    {
+        if (index >= size()) return;
+
+        for (const uint32_t bonded : BondSlots(m_bonds[index])) {
+            BreakBond(index, bonded);
+        }
+        ReleaseSlot(m_id[index]);
+        m_bondEdgesDirty = true;
+
+        const size_t last = size() - 1;
+        if (index != last) {
+            // Only the partners of the moved atom hold its old index
+            for (const uint32_t bonded : m_bonds[last]) {
+                m_bonds[bonded].Replace(static_cast<uint32_t>(last), static_cast<uint32_t>(index));
+            }
+            ForEachArray([index, last](auto& values) { values[index] = std::move(values[last]); });
+            m_slotIndex[m_id[index]] = static_cast<uint32_t>(index);
+        }
+        ForEachArray([](auto& values) { values.pop_back(); });
+    }
+
+    void AtomStore::Permute(const std::vector<uint32_t>& order)
+    {
+        const size_t count = size();
+        if (order.size() != count) {
+            throw std::invalid_argument("AtomStore::Permute: order has " + std::to_string(order.size()) +
+                                        " entries for " + std::to_string(count) + " atoms");
+        }
+
+        std::vector<uint32_t> oldToNew(count, NoIndex);
+        for (size_t k = 0; k < count; ++k) {
+            if (order[k] >= count || oldToNew[order[k]] != NoIndex) {
+                throw std::invalid_argument("AtomStore::Permute: order is not a permutation");
+            }
+            oldToNew[order[k]] = static_cast<uint32_t>(k);
+        }
+
+        ForEachArray([&order, count](auto& values) {
+            std::decay_t<decltype(values)> permuted(count);
+            for (size_t k = 0; k < count; ++k) {
+                permuted[k] = std::move(values[order[k]]);
+            }
+            values.swap(permuted);
+        });
+
+        for (size_t k = 0; k < count; ++k) {
+            for (auto& bonded : m_bonds[k]) {
+                bonded = oldToNew[bonded];
+            }
+            m_slotIndex[m_id[k]] = static_cast<uint32_t>(k);
+        }
+        m_bondEdgesDirty = true;
+    }
+
+    void AtomStore::Clear()
+    {
+        for (const uint32_t id : m_id) {
+            ReleaseSlot(id);
+        }
+        ForEachArray([](auto& values) { values.clear(); });
+        m_bondCount = 0;
+        m_bondEdgesDirty = true;
+    }
+
+    void AtomStore::Reserve(const size_t capacity)
+    {
+        ForEachArray([capacity](auto& values) { values.reserve(capacity); });
+    }
+
+    Atom AtomStore::GetAtom(const size_t index) const
+    {
+        Atom atom(m_element[index], GetPosition(index), GetVelocity(index));
+        atom.SetPreviousPosition(GetPreviousPosition(index));
+        atom.SetCharge(m_charge[index]);
+        return atom;
+    }
+
+    // === Stable identity ===
+
+    std::optional<size_t> AtomStore::Resolve(const AtomHandle handle) const
+    {
+        if (handle.slot >= m_slotIndex.size()) return std::nullopt;
+        if (m_slotGeneration[handle.slot] != handle.generation) return std::nullopt;
+        if (m_slotIndex[handle.slot] == NoIndex) return std::nullopt;
+        return m_slotIndex[handle.slot];
+    }
+
+    void AtomStore::RestoreIds(const uint32_t* ids)
+    {
+        // Ids come from files; bound them before they size the slot table
+        const size_t idLimit = 4 * size() + 64;
+        size_t slotCount = m_slotIndex.size();
+        for (size_t i = 0; i < size(); ++i) {
+            if (ids[i] >= idLimit) {
+                throw std::invalid_argument("AtomStore::RestoreIds: id " + std::to_string(ids[i]) + " out of range");
+            }
+            slotCount = std::max<size_t>(slotCount, ids[i] + size_t{1});
+        }
+        std::vector<uint32_t> slotIndex(slotCount, NoIndex);
+        for (size_t i = 0; i < size(); ++i) {
+            if (slotIndex[ids[i]] != NoIndex) {
+                throw std::invalid_argument("AtomStore::RestoreIds: duplicate id " + std::to_string(ids[i]));
+            }
+            slotIndex[ids[i]] = static_cast<uint32_t>(i);
+        }
+
+        // Generations carry over, so handles to atoms that were live stop resolving
+        for (size_t slot = 0; slot < m_slotIndex.size(); ++slot) {
+            if (m_slotIndex[slot] != NoIndex) ++m_slotGeneration[slot];
+        }
+        m_slotGeneration.resize(slotCount, 0);
+        m_slotIndex.swap(slotIndex);
+        m_freeSlots.clear();
+        for (size_t slot = slotCount; slot-- > 0;) {
+            if (m_slotIndex[slot] == NoIndex) m_freeSlots.push_back(static_cast<uint32_t>(slot));
+        }
+        std::copy(ids, ids + size(), m_id.begin());
+    }
+
+    uint32_t AtomStore::AcquireSlot(const size_t index)
+    {
+        uint32_t slot;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(m_slotIndex.size());
+            m_slotIndex.push_back(NoIndex);
+            m_slotGeneration.push_back(0);
+        }
+        m_slotIndex[slot] = static_cast<uint32_t>(index);
+        return slot;
+    }
+
+    void AtomStore::ReleaseSlot(const uint32_t slot)
+    {
+        m_slotIndex[slot] = NoIndex;
+        ++m_slotGeneration[slot];
+        m_freeSlots.push_back(slot);
+    }
+
+    // === Bonds ===
+
+    bool AtomStore::CanFormBond(const size_t i) const
+    {
+        return m_bonds[i].size() < static_cast<size_t>(GetProperties(i).valence);
+    }
+
+    bool AtomStore::CanBondWith(const size_t i, const size_t j) const
+    {
+        if (i == j) return false;
+        if (!CanFormBond(i) || !CanFormBond(j)) return false;
+
+        const double deltaEN = std::abs(GetProperties(i).electronegativity - GetProperties(j).electronegativity);
+        return deltaEN <= 1.7; // Simple covalent bond rule
+    }
+
+    bool AtomStore::CanFormBondWith(const size_t i, const size_t j) const
+    {
+        if (i == j) return false;
+        if (IsBondedTo(i, j)) return false; // Already bonded
+        if (!IsWithinBondingRange(i, j)) return false;
+
+        return CanBondWith(i, j);
+    }
+
+    bool AtomStore::IsWithinBondingRange(const size_t i, const size_t j) const
+    {
+        if (i == j) return false;
+
+        const double distance = glm::length(GetPosition(i) - GetPosition(j));
+        const double bondingDistance = (GetProperties(i).bondLength + GetProperties(j).bondLength) * BondingRangeFactor;
+
+        return distance <= bondingDistance;
+    }
+
+    bool AtomStore::ShouldBreakBond(const size_t i, const size_t j) const
+    {
+        if (!IsBondedTo(i, j)) return false;
+
+        const double distance = glm::length(GetPosition(i) - GetPosition(j));
+        const double maxBondDistance = (GetProperties(i).bondLength + GetProperties(j).bondLength) * BondBreakFactor;
+
+        return distance > maxBondDistance;
+    }
+
+    bool AtomStore::AddBond(const size_t i, const size_t j)
+    {
+        if (!CanBondWith(i, j) || IsBondedTo(i, j)) return false;
+
+        m_bonds[i].Add(static_cast<uint32_t>(j));
+        m_bonds[j].Add(static_cast<uint32_t>(i));
+        ++m_bondCount;
+        m_bondEdgesDirty = true;
+        return true;
+    }
+
+    bool AtomStore::TryFormBond(const size_t i, const size_t j)
+    {
+        return CanFormBondWith(i, j) && AddBond(i, j);
+    }
+
+    void AtomStore::BreakBond(const size_t i, const size_t j)
+    {
+        if (m_bonds[i].Remove(static_cast<uint32_t>(j))) {
+            m_bonds[j].Remove(static_cast<uint32_t>(i));
+            --m_bondCount;
+            m_bondEdgesDirty = true;
+        }
+    }
+
+    void AtomStore::ClearBonds()
+    {
+        for (auto& bonds : m_bonds) {
+            bonds.Clear();
+        }
+        m_bondCount = 0;
+        m_bondEdgesDirty = true;
+    }
+
+    const std::vector<BondEdge>& AtomStore::GetBondEdges() const
+    {
+        if (m_bondEdgesDirty) {
+            m_bondEdges.clear();
+            m_bondEdges.reserve(m_bondCount);
+            for (size_t i = 0; i < m_bonds.size(); ++i) {
+                for (const uint32_t j : m_bonds[i]) {
+                    if (j > i) m_bondEdges.push_back({static_cast<uint32_t>(i), j});
+                }
+            }
+            m_bondEdgesDirty = false;
+        }
+        return m_bondEdges;
+    }
+}
@@ -0,0 +1,445 @@
+#pragma once
+
+#include "Atom.h"
+
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+namespace Molecular
+{
+    // Hands out storage aligned to a cache line, so every array starts on a SIMD boundary
+    template<typename T, size_t Alignment = 64>
+    struct AlignedAllocator
+    {
+        using value_type = T;
+
+        template<typename U>
+        struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+        AlignedAllocator() noexcept = default;
+        template<typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+        T* allocate(const size_t count)
+        {
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+        }
+
+        void deallocate(T* pointer, size_t) noexcept
+        {
+            ::operator delete(pointer, std::align_val_t{Alignment});
+        }
+
+        template<typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+        template<typename U>
+        bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+    };
+
+    template<typename T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+    class AtomStore;
+
+    // Bond partners of one atom, stored inline (no allocation). Unused slots hold
+    // NoPartner, so Contains compares every slot without a data-dependent loop.
+    class BondSlots
+    {
+    public:
+        static constexpr uint32_t NoPartner = std::numeric_limits<uint32_t>::max();
+
+        BondSlots() { m_partners.fill(NoPartner); }
+
+        [[nodiscard]] size_t size() const { return m_count; }
+        [[nodiscard]] bool empty() const { return m_count == 0; }
+        [[nodiscard]] bool full() const { return m_count == MaxValence; }
+        [[nodiscard]] uint32_t operator[](const size_t k) const { return m_partners[k]; }
+
+        [[nodiscard]] const uint32_t* begin() const { return m_partners.data(); }
+        [[nodiscard]] const uint32_t* end() const { return m_partners.data() + m_count; }
+        [[nodiscard]] uint32_t* begin() { return m_partners.data(); }
+        [[nodiscard]] uint32_t* end() { return m_partners.data() + m_count; }
+
+        [[nodiscard]] bool Contains(const uint32_t partner) const
+        {
+            bool found = false;
+            for (size_t k = 0; k < MaxValence; ++k) {
+                found |= m_partners[k] == partner;
+            }
+            return found;
+        }
+
+        // Returns false when every slot is taken
+        bool Add(const uint32_t partner)
+        {
+            if (full()) return false;
+            m_partners[m_count++] = partner;
+            return true;
+        }
+
+        // Removes the partner if present, keeping the others in bond order
+        bool Remove(const uint32_t partner)
+        {
+            size_t k = 0;
+            while (k < m_count && m_partners[k] != partner) ++k;
+            if (k == m_count) return false;
+            for (; k + 1 < m_count; ++k) {
+                m_partners[k] = m_partners[k + 1];
+            }
+            m_partners[--m_count] = NoPartner;
+            return true;
+        }
+
+        void Replace(const uint32_t from, const uint32_t to)
+        {
+            for (size_t k = 0; k < m_count; ++k) {
+                if (m_partners[k] == from) m_partners[k] = to;
+            }
+        }
+
+        void Clear()
+        {
+            m_partners.fill(NoPartner);
+            m_count = 0;
+        }
+
+    private:
+        std::array<uint32_t, MaxValence> m_partners;
+        uint8_t m_count = 0;
+    };
+
+    // One bond, stored once with first < second
+    struct BondEdge
+    {
+        uint32_t first;
+        uint32_t second;
+    };
+
+    // Stable reference to an atom. Survives reordering and swap-removal; the slot
+    // is reused once its atom is removed, the generation tells old handles apart.
+    struct AtomHandle
+    {
+        static constexpr uint32_t InvalidSlot = std::numeric_limits<uint32_t>::max();
+
+        uint32_t slot = InvalidSlot;
+        uint32_t generation = 0;
+
+        [[nodiscard]] bool IsValid() const { return slot != InvalidSlot; }
+        bool operator==(const AtomHandle& other) const { return slot == other.slot && generation == other.generation; }
+        bool operator!=(const AtomHandle& other) const { return !(*this == other); }
+    };
+
+    // Handle to one atom inside an AtomStore. Cheap to copy; only valid while the
+    // store is not resized. Mirrors the Atom getters so UI code reads the same.
+    template<typename StoreT>
+    class BasicAtomView
+    {
+    public:
+        BasicAtomView(StoreT& store, const size_t index) : m_store(&store), m_index(index) {}
+
+        // A mutable view converts to a read-only one
+        template<typename OtherT, typename = std::enable_if_t<std::is_const_v<StoreT> && !std::is_const_v<OtherT>>>
+        BasicAtomView(const BasicAtomView<OtherT>& other) : m_store(&other.GetStore()), m_index(other.GetIndex()) {}
+
+        [[nodiscard]] StoreT& GetStore() const { return *m_store; }
+        [[nodiscard]] size_t GetIndex() const { return m_index; }
+        [[nodiscard]] AtomHandle GetHandle() const;
+
+        // === Floating-point ===
+        [[nodiscard]] glm::vec2 GetPosition() const { return glm::vec2(GetPositionD()); }
+        [[nodiscard]] glm::vec2 GetVelocity() const { return glm::vec2(GetVelocityD()); }
+        [[nodiscard]] float GetVanDerWaalsRadius() const { return static_cast<float>(GetVanDerWaalsRadiusD()); }
+
+        // === Double-precision ===
+        [[nodiscard]] glm::dvec2 GetPositionD() const;
+        [[nodiscard]] glm::dvec2 GetVelocityD() const;
+        [[nodiscard]] glm::dvec2 GetPreviousPosition() const;
+        [[nodiscard]] glm::dvec2 GetForceD() const;
+
+        [[nodiscard]] double GetMassD() const;
+        [[nodiscard]] double GetCharge() const;
+        [[nodiscard]] double GetVanDerWaalsRadiusD() const;
+        [[nodiscard]] double GetCovalentBondLengthD() const;
+        [[nodiscard]] double GetEpsilonD() const;
+        [[nodiscard]] double GetSigmaD() const;
+        [[nodiscard]] double GetElectronegativity() const;
+
+        [[nodiscard]] int GetValence() const;
+        [[nodiscard]] int GetBondCount() const;
+        [[nodiscard]] bool CanFormBond() const;
+        [[nodiscard]] bool IsBondedTo(size_t other) const;
+        [[nodiscard]] const BondSlots& GetBonds() const;
+
+        [[nodiscard]] glm::vec4 GetColor() const;
+        [[nodiscard]] ElementId GetElementId() const;
+        [[nodiscard]] std::string_view GetElement() const;
+
+        // Standalone copy of this atom's state (no bonds)
+        [[nodiscard]] Atom ToAtom() const;
+
+        // Mutators, only available on views of a non-const store
+        void SetPosition(const glm::dvec2& position) const;
+        void SetVelocity(const glm::dvec2& velocity) const;
+        void SetCharge(double charge) const;
+
+    private:
+        StoreT* m_store;
+        size_t m_index;
+    };
+
+    using AtomView = BasicAtomView<AtomStore>;
+    using ConstAtomView = BasicAtomView<const AtomStore>;
+
+    template<typename StoreT>
+    class BasicAtomIterator
+    {
+    public:
+        BasicAtomIterator(StoreT& store, const size_t index) : m_store(&store), m_index(index) {}
+
+        BasicAtomView<StoreT> operator*() const { return {*m_store, m_index}; }
+        BasicAtomIterator& operator++() { ++m_index; return *this; }
+        bool operator==(const BasicAtomIterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const BasicAtomIterator& other) const { return m_index != other.m_index; }
+
+    private:
+        StoreT* m_store;
+        size_t m_index;
+    };
+
+    // Structure-of-arrays storage for the 2D engine.
+    //
+    // The per-step state (position, velocity, force, Verlet x_prev), mass and
+    // charge live in separate 64-byte aligned arrays so force and integration
+    // loops only touch the bytes they use. Everything shared by an element
+    // (radii, LJ parameters, valence, colour, name) is read from elementTable
+    // through the one-byte element id. Bonds are inline partner-index slots,
+    // cold and per atom.
+    //
+    // Indices are dense and may change: Remove, SwapRemove and Permute remap the
+    // bond lists as they go. Code that has to follow an atom across those holds
+    // an AtomHandle (or the atom's id) instead of its index.
+    class AtomStore
+    {
+    public:
+        // Copies the atom's state in and returns its index
+        size_t Add(const Atom& atom);
+        // Removes one atom; later atoms shift down and bond indices follow them. O(N + B)
+        void Remove(size_t index);
+        // Removes one atom by moving the last atom into its place. O(valence)
+        void SwapRemove(size_t index);
+        // Reorders every array so new index k holds the atom that was at order[k],
+        // remapping bond indices on the way. O(N + B)
+        void Permute(const std::vector<uint32_t>& order);
+        void Clear();
+        void Reserve(size_t capacity);
+
+        [[nodiscard]] size_t size() const { return m_x.size(); }
+        [[nodiscard]] bool empty() const { return m_x.empty(); }
+
+        [[nodiscard]] AtomView operator[](const size_t index) { return {*this, index}; }
+        [[nodiscard]] ConstAtomView operator[](const size_t index) const { return {*this, index}; }
+
+        [[nodiscard]] BasicAtomIterator<AtomStore> begin() { return {*this, 0}; }
+        [[nodiscard]] BasicAtomIterator<AtomStore> end() { return {*this, size()}; }
+        [[nodiscard]] BasicAtomIterator<const AtomStore> begin() const { return {*this, 0}; }
+        [[nodiscard]] BasicAtomIterator<const AtomStore> end() const { return {*this, size()}; }
+
+        [[nodiscard]] Atom GetAtom(size_t index) const;
+
+        // === Stable identity ===
+        [[nodiscard]] AtomHandle GetHandle(const size_t i) const { return {m_id[i], m_slotGeneration[m_id[i]]}; }
+        // Current index of the atom, or nothing if it has been removed
+        [[nodiscard]] std::optional<size_t> Resolve(AtomHandle handle) const;
+        // Per-atom slot ids: unique among live atoms and unchanged by reordering
+        [[nodiscard]] const uint32_t* GetIds() const { return m_id.data(); }
+        [[nodiscard]] uint32_t GetId(const size_t i) const { return m_id[i]; }
+        // Gives the atoms these ids (one per atom, all distinct, below 4 * size() + 64),
+        // e.g. when loading a checkpoint; existing handles are invalidated. Throws
+        // std::invalid_argument and leaves the store unchanged.
+        void RestoreIds(const uint32_t* ids);
+
+        // === Hot arrays ===
+        [[nodiscard]] double* GetX() { return m_x.data(); }
+        [[nodiscard]] double* GetY() { return m_y.data(); }
+        [[nodiscard]] double* GetVX() { return m_vx.data(); }
+        [[nodiscard]] double* GetVY() { return m_vy.data(); }
+        [[nodiscard]] double* GetFX() { return m_fx.data(); }
+        [[nodiscard]] double* GetFY() { return m_fy.data(); }
+        [[nodiscard]] double* GetPreviousX() { return m_previousX.data(); }
+        [[nodiscard]] double* GetPreviousY() { return m_previousY.data(); }
+
+        [[nodiscard]] const double* GetX() const { return m_x.data(); }
+        [[nodiscard]] const double* GetY() const { return m_y.data(); }
+        [[nodiscard]] const double* GetVX() const { return m_vx.data(); }
+        [[nodiscard]] const double* GetVY() const { return m_vy.data(); }
+        [[nodiscard]] const double* GetFX() const { return m_fx.data(); }
+        [[nodiscard]] const double* GetFY() const { return m_fy.data(); }
+        [[nodiscard]] const double* GetPreviousX() const { return m_previousX.data(); }
+        [[nodiscard]] const double* GetPreviousY() const { return m_previousY.data(); }
+
+        [[nodiscard]] const double* GetMasses() const { return m_mass.data(); }
+        [[nodiscard]] const double* GetInverseMasses() const { return m_inverseMass.data(); }
+        [[nodiscard]] const double* GetCharges() const { return m_charge.data(); }
+        [[nodiscard]] const ElementId* GetElementIds() const { return m_element.data(); }
+
+        // === Per-atom access for non-hot code ===
+        [[nodiscard]] glm::dvec2 GetPosition(const size_t i) const { return {m_x[i], m_y[i]}; }
+        [[nodiscard]] glm::dvec2 GetVelocity(const size_t i) const { return {m_vx[i], m_vy[i]}; }
+        [[nodiscard]] glm::dvec2 GetForce(const size_t i) const { return {m_fx[i], m_fy[i]}; }
+        [[nodiscard]] glm::dvec2 GetPreviousPosition(const size_t i) const { return {m_previousX[i], m_previousY[i]}; }
+
+        void SetPosition(const size_t i, const glm::dvec2& position) { m_x[i] = position.x; m_y[i] = position.y; }
+        void SetVelocity(const size_t i, const glm::dvec2& velocity) { m_vx[i] = velocity.x; m_vy[i] = velocity.y; }
+        void SetPreviousPosition(const size_t i, const glm::dvec2& position) { m_previousX[i] = position.x; m_previousY[i] = position.y; }
+        void SetCharge(const size_t i, const double charge) { m_charge[i] = charge; }
+
+        // === Element properties ===
+        [[nodiscard]] ElementId GetElementId(const size_t i) const { return m_element[i]; }
+        [[nodiscard]] const AtomProperties& GetProperties(const size_t i) const { return GetElementProperties(m_element[i]); }
+        [[nodiscard]] std::string_view GetElement(const size_t i) const { return GetElementSymbol(m_element[i]); }
+
+        // === Bonds ===
+        // Bonds form within BondingRangeFactor and break beyond BondBreakFactor
+        // times the sum of the two covalent bond lengths
+        static constexpr double BondingRangeFactor = 1.5;
+        static constexpr double BondBreakFactor = 2.0;
+        // No pair further apart than this can form a bond
+        static constexpr double MaxBondingRange = BondingRangeFactor * 2.0 * MaxBondLength;
+
+        [[nodiscard]] const BondSlots& GetBonds(const size_t i) const { return m_bonds[i]; }
+        [[nodiscard]] size_t GetTotalBondCount() const { return m_bondCount; }
+        // Every bond once, ordered by first atom then bond order; a flat array the
+        // renderer can upload. Rebuilt in O(N + B) only after the topology changed.
+        [[nodiscard]] const std::vector<BondEdge>& GetBondEdges() const;
+        // O(1): compares the MaxValence inline slots of atom i
+        [[nodiscard]] bool IsBondedTo(const size_t i, const size_t j) const { return m_bonds[i].Contains(static_cast<uint32_t>(j)); }
+        [[nodiscard]] bool CanFormBond(size_t i) const;
+        [[nodiscard]] bool CanBondWith(size_t i, size_t j) const;
+        [[nodiscard]] bool CanFormBondWith(size_t i, size_t j) const;
+        [[nodiscard]] bool IsWithinBondingRange(size_t i, size_t j) const;
+        [[nodiscard]] bool ShouldBreakBond(size_t i, size_t j) const;
+
+        // Both return true if a bond was added
+        bool AddBond(size_t i, size_t j);
+        bool TryFormBond(size_t i, size_t j);
+        void BreakBond(size_t i, size_t j);
+        void ClearBonds();
+
+    private:
+        // Hot per-atom state
+        AlignedVector<double> m_x, m_y;
+        AlignedVector<double> m_vx, m_vy;
+        AlignedVector<double> m_fx, m_fy;
+        AlignedVector<double> m_previousX, m_previousY;
+        AlignedVector<double> m_mass, m_inverseMass;
+        AlignedVector<double> m_charge;
+        AlignedVector<ElementId> m_element;
+
+        // Cold data
+        std::vector<BondSlots> m_bonds;
+        std::vector<uint32_t> m_id;
+
+        // Bond topology summary: exact count, and an edge list cached until the bonds change
+        size_t m_bondCount = 0;
+        mutable std::vector<BondEdge> m_bondEdges;
+        mutable bool m_bondEdgesDirty = false;
+
+        // Slot table behind AtomHandle: slot -> current index (or NoIndex) and generation
+        static constexpr uint32_t NoIndex = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> m_slotIndex;
+        std::vector<uint32_t> m_slotGeneration;
+        std::vector<uint32_t> m_freeSlots;
+
+        uint32_t AcquireSlot(size_t index);
+        void ReleaseSlot(uint32_t slot);
+
+        // Applies f to every per-atom array, so they cannot drift out of step
+        template<typename F>
+        void ForEachArray(F&& f)
+        {
+            f(m_x); f(m_y);
+            f(m_vx); f(m_vy);
+            f(m_fx); f(m_fy);
+            f(m_previousX); f(m_previousY);
+            f(m_mass); f(m_inverseMass);
+            f(m_charge);
+            f(m_element);
+            f(m_bonds);
+            f(m_id);
+        }
+    };
+
+    // === BasicAtomView ===
+
+    template<typename StoreT>
+    AtomHandle BasicAtomView<StoreT>::GetHandle() const { return m_store->GetHandle(m_index); }
+
+    template<typename StoreT>
+    glm::dvec2 BasicAtomView<StoreT>::GetPositionD() const { return m_store->GetPosition(m_index); }
+    template<typename StoreT>
+    glm::dvec2 BasicAtomView<StoreT>::GetVelocityD() const { return m_store->GetVelocity(m_index); }
+    template<typename StoreT>
+    glm::dvec2 BasicAtomView<StoreT>::GetPreviousPosition() const { return m_store->GetPreviousPosition(m_index); }
+    template<typename StoreT>
+    glm::dvec2 BasicAtomView<StoreT>::GetForceD() const { return m_store->GetForce(m_index); }
+
+    template<typename StoreT>
+    double BasicAtomView<StoreT>::GetMassD() const { return m_store->GetMasses()[m_index]; }
+    template<typename StoreT>
+    double BasicAtomView<StoreT>::GetCharge() const { return m_store->GetCharges()[m_index]; }
+    template<typename StoreT>
+    double BasicAtomView<StoreT>::GetVanDerWaalsRadiusD() const { return m_store->GetProperties(m_index).vanDerWaalsRadius; }
+    template<typename StoreT>
+    double BasicAtomView<StoreT>::GetCovalentBondLengthD() const { return m_store->GetProperties(m_index).bondLength; }
+    template<typename StoreT>
+    double BasicAtomView<StoreT>::GetEpsilonD() const { return m_store->GetProperties(m_index).epsilon; }
+    template<typename StoreT>
+    double BasicAtomView<StoreT>::GetSigmaD() const { return m_store->GetProperties(m_index).sigma; }
+    template<typename StoreT>
+    double BasicAtomView<StoreT>::GetElectronegativity() const { return m_store->GetProperties(m_index).electronegativity; }
+
+    template<typename StoreT>
+    int BasicAtomView<StoreT>::GetValence() const { return m_store->GetProperties(m_index).valence; }
+    template<typename StoreT>
+    int BasicAtomView<StoreT>::GetBondCount() const { return static_cast<int>(m_store->GetBonds(m_index).size()); }
+    template<typename StoreT>
+    bool BasicAtomView<StoreT>::CanFormBond() const { return m_store->CanFormBond(m_index); }
+    template<typename StoreT>
+    bool BasicAtomView<StoreT>::IsBondedTo(const size_t other) const { return m_store->IsBondedTo(m_index, other); }
+    template<typename StoreT>
+    const BondSlots& BasicAtomView<StoreT>::GetBonds() const { return m_store->GetBonds(m_index); }
+
+    template<typename StoreT>
+    glm::vec4 BasicAtomView<StoreT>::GetColor() const { return m_store->GetProperties(m_index).color; }
+    template<typename StoreT>
+    ElementId BasicAtomView<StoreT>::GetElementId() const { return m_store->GetElementId(m_index); }
+    template<typename StoreT>
+    std::string_view BasicAtomView<StoreT>::GetElement() const { return m_store->GetElement(m_index); }
+
+    template<typename StoreT>
+    Atom BasicAtomView<StoreT>::ToAtom() const { return m_store->GetAtom(m_index); }
+
+    template<typename StoreT>
+    void BasicAtomView<StoreT>::SetPosition(const glm::dvec2& position) const
+    {
+        static_assert(!std::is_const_v<StoreT>, "Cannot modify an atom through a ConstAtomView");
+        m_store->SetPosition(m_index, position);
+    }
+
+    template<typename StoreT>
+    void BasicAtomView<StoreT>::SetVelocity(const glm::dvec2& velocity) const
+    {
+        static_assert(!std::is_const_v<StoreT>, "Cannot modify an atom through a ConstAtomView");
+        m_store->SetVelocity(m_index, velocity);
+    }
+
+    template<typename StoreT>
+    void BasicAtomView<StoreT>::SetCharge(const double charge) const
+    {
+        static_assert(!std::is_const_v<StoreT>, "Cannot modify an atom through a ConstAtomView");
+        m_store->SetCharge(m_index, charge);
+    }
+}
@@ -0,0 +1,158 @@
+#include "BondTracker.h"
+#include "MoleculeTracker.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Molecular
+{
+    bool BondTracker::Update(AtomStore& atoms, const uint64_t step, MoleculeTracker* molecules)
+    {
+        if (m_callCounter++ % m_settings.interval != 0) {
+            return false;
+        }
+
+        // Break stretched bonds: O(N * valence)
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            for (const uint32_t j : BondSlots(atoms.GetBonds(i))) {
+                if (j > i && atoms.ShouldBreakBond(i, j)) {
+                    atoms.BreakBond(i, j);
+                    RecordEvent(atoms, BondEvent::Type::Broken, i, j, step);
+                    if (molecules) molecules->OnBondBroken(atoms, i, j);
+                }
+            }
+        }
+
+        // Form new bonds: propose (parallel), then accept shortest first
+        if (NeedsRebuild(atoms)) {
+            RebuildCandidates(atoms);
+        }
+        ProposeBonds(atoms);
+        for (const Proposal& proposal : m_proposals) {
+            // AddBond re-checks valence, which earlier acceptances may have used up
+            if (atoms.AddBond(proposal.i, proposal.j)) {
+                RecordEvent(atoms, BondEvent::Type::Formed, proposal.i, proposal.j, step);
+                if (molecules) molecules->OnBondFormed(proposal.i, proposal.j);
+            }
+        }
+        return true;
+    }
+
+    void BondTracker::Invalidate()
+    {
+        m_candidatesValid = false;
+        m_callCounter = 0;
+    }
+
+    void BondTracker::SetSettings(const BondUpdateSettings& settings)
+    {
+        if (settings.interval < 1 || settings.skin < 0.0) {
+            throw std::invalid_argument("BondUpdateSettings: interval must be >= 1 and skin >= 0");
+        }
+        m_settings = settings;
+        Invalidate();
+    }
+
+    std::vector<BondEvent> BondTracker::ConsumeEvents()
+    {
+        std::vector<BondEvent> events;
+        events.swap(m_events);
+        return events;
+    }
+
+    bool BondTracker::NeedsRebuild(const AtomStore& atoms) const
+    {
+        if (!m_candidatesValid || m_referencePositions.size() != atoms.size()) {
+            return true;
+        }
+
+        const double* x = atoms.GetX();
+        const double* y = atoms.GetY();
+        const double limit = 0.5 * m_settings.skin;
+        const double limitSquared = limit * limit;
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            const double dx = x[i] - m_referencePositions[i].x;
+            const double dy = y[i] - m_referencePositions[i].y;
+            if (dx * dx + dy * dy > limitSquared) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void BondTracker::RebuildCandidates(const AtomStore& atoms)
+    {
+        const double range = AtomStore::MaxBondingRange + m_settings.skin;
+        const double rangeSquared = range * range;
+        const double* x = atoms.GetX();
+        const double* y = atoms.GetY();
+
+        m_grid.Build(atoms, range);
+        m_candidates.clear();
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            m_nearby.clear();
+            m_grid.ForEachNearby(i, [&](const size_t j) {
+                const double dx = x[j] - x[i];
+                const double dy = y[j] - y[i];
+                if (j > i && dx * dx + dy * dy <= rangeSquared) {
+                    m_nearby.push_back(static_cast<uint32_t>(j));
+                }
+            });
+            std::sort(m_nearby.begin(), m_nearby.end());
+            for (const uint32_t j : m_nearby) {
+                m_candidates.emplace_back(static_cast<uint32_t>(i), j);
+            }
+        }
+
+        m_referencePositions.resize(atoms.size());
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            m_referencePositions[i] = {x[i], y[i]};
+        }
+        m_candidatesValid = true;
+        ++m_rebuildCount;
+    }
+
+    void BondTracker::ProposeBonds(const AtomStore& atoms)
+    {
+        const double* x = atoms.GetX();
+        const double* y = atoms.GetY();
+
+        // Read-only against the store; each chunk fills its own list
+        const auto propose = [&](const size_t begin, const size_t end, const size_t chunk) {
+            auto& proposals = m_chunkProposals[chunk];
+            for (size_t k = begin; k < end; ++k) {
+                const auto [i, j] = m_candidates[k];
+                if (atoms.CanFormBondWith(i, j)) {
+                    const double dx = x[j] - x[i];
+                    const double dy = y[j] - y[i];
+                    proposals.push_back({dx * dx + dy * dy, i, j});
+                }
+            }
+        };
+
+        m_chunkProposals.resize(m_pool ? m_pool->GetThreadCount() : 1);
+        for (auto& proposals : m_chunkProposals) {
+            proposals.clear();
+        }
+        if (m_pool) {
+            m_pool->ParallelFor(m_candidates.size(), m_minCandidatesPerThread, propose);
+        } else {
+            propose(0, m_candidates.size(), 0);
+        }
+
+        m_proposals.clear();
+        for (const auto& proposals : m_chunkProposals) {
+            m_proposals.insert(m_proposals.end(), proposals.begin(), proposals.end());
+        }
+        std::sort(m_proposals.begin(), m_proposals.end());
+    }
+
+    void BondTracker::RecordEvent(const AtomStore& atoms, const BondEvent::Type type, const size_t i, const size_t j, const uint64_t step)
+    {
+        if (m_events.size() >= m_maxPendingEvents) {
+            m_events.erase(m_events.begin(), m_events.begin() + static_cast<std::ptrdiff_t>(m_maxPendingEvents / 2));
+        }
+        m_events.push_back({type, atoms.GetId(i), atoms.GetId(j), step});
+    }
+}
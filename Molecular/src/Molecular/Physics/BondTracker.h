@@ -0,0 +1,110 @@
+#pragma once
+
+#include "AtomStore.h"
+#include "CellGrid.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Molecular
+{
+    class MoleculeTracker;
+    class ThreadPool;
+
+    struct BondEvent
+    {
+        enum class Type : uint8_t { Formed, Broken };
+
+        Type type;
+        uint32_t firstId;   // AtomStore ids, so events stay meaningful after reordering
+        uint32_t secondId;
+        uint64_t step;
+    };
+
+    struct BondUpdateSettings
+    {
+        // Bonds are re-examined on every interval-th call to Update
+        int interval = 5;
+        // Extra search radius around MaxBondingRange; candidates are rebuilt once
+        // any atom has moved more than half of it
+        double skin = 0.1;
+    };
+
+    // Keeps the bond topology of an AtomStore up to date between steps.
+    //
+    // Bonds form within BondingRangeFactor and break beyond BondBreakFactor times
+    // the summed bond lengths; the gap between the two is a hysteresis band, so a
+    // pair hovering at one threshold does not flicker. Formation only tests a
+    // candidate list of pairs within MaxBondingRange + skin, built on a CellGrid
+    // and reused until some atom has moved skin / 2 (Verlet-list style), so a
+    // typical update is O(N) for the displacement check plus O(B + candidates).
+    //
+    // Formation runs in two phases. Proposing tests every candidate against the
+    // bonding rules read-only, in parallel when a ThreadPool is set. Accepting
+    // then walks the proposals shortest first (ties by index) and adds each one
+    // that still fits both atoms' valence, so the topology never depends on the
+    // thread count.
+    class BondTracker
+    {
+    public:
+        // Returns true if the bonds were re-examined on this call. Each change is
+        // also passed on to molecules, if given, to keep it in step.
+        bool Update(AtomStore& atoms, uint64_t step, MoleculeTracker* molecules = nullptr);
+        // Makes the next Update run and rebuild its candidates; call after atoms
+        // were added, removed, reordered or teleported
+        void Invalidate();
+
+        // Workers for the proposal phase; nullptr runs it on the calling thread
+        void SetThreadPool(ThreadPool* pool) { m_pool = pool; }
+
+        void SetSettings(const BondUpdateSettings& settings);
+        [[nodiscard]] const BondUpdateSettings& GetSettings() const { return m_settings; }
+        // Calls since the last Invalidate; a checkpoint keeps it so the cadence resumes in phase
+        [[nodiscard]] int GetCallCounter() const { return m_callCounter; }
+        void SetCallCounter(const int calls) { m_callCounter = calls; }
+
+        // Formed/broken events since the last call, oldest first
+        [[nodiscard]] std::vector<BondEvent> ConsumeEvents();
+        [[nodiscard]] size_t GetCandidateRebuildCount() const { return m_rebuildCount; }
+
+    private:
+        [[nodiscard]] bool NeedsRebuild(const AtomStore& atoms) const;
+        void RebuildCandidates(const AtomStore& atoms);
+        void ProposeBonds(const AtomStore& atoms);
+        void RecordEvent(const AtomStore& atoms, BondEvent::Type type, size_t i, size_t j, uint64_t step);
+
+        // Unconsumed events beyond this are dropped, oldest first
+        static constexpr size_t m_maxPendingEvents = 4096;
+
+        struct Proposal
+        {
+            double distanceSquared;
+            uint32_t i, j;
+
+            bool operator<(const Proposal& other) const
+            {
+                if (distanceSquared != other.distanceSquared) return distanceSquared < other.distanceSquared;
+                if (i != other.i) return i < other.i;
+                return j < other.j;
+            }
+        };
+
+        // Below this many candidates per thread the proposal phase stays serial
+        static constexpr size_t m_minCandidatesPerThread = 512;
+
+        BondUpdateSettings m_settings;
+        ThreadPool* m_pool = nullptr;
+        int m_callCounter = 0;
+        bool m_candidatesValid = false;
+        size_t m_rebuildCount = 0;
+
+        CellGrid m_grid;
+        std::vector<std::pair<uint32_t, uint32_t>> m_candidates;  // i < j, ascending
+        std::vector<uint32_t> m_nearby;
+        std::vector<glm::dvec2> m_referencePositions;
+        std::vector<BondEvent> m_events;
+        std::vector<std::vector<Proposal>> m_chunkProposals;
+        std::vector<Proposal> m_proposals;
+    };
+}
@@ -0,0 +1,59 @@
+#include "CellGrid.h"
+
+#include <algorithm>
+
+namespace Molecular
+{
+    void CellGrid::Build(const AtomStore& atoms, const double cellSize)
+    {
+        const size_t count = atoms.size();
+        m_cellOfAtom.resize(count);
+        m_atomsByCell.resize(count);
+        if (count == 0) {
+            m_columns = m_rows = 0;
+            m_cellStart.assign(1, 0);
+            return;
+        }
+
+        const double* x = atoms.GetX();
+        const double* y = atoms.GetY();
+
+        double minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+        for (size_t i = 1; i < count; ++i) {
+            minX = std::min(minX, x[i]);
+            maxX = std::max(maxX, x[i]);
+            minY = std::min(minY, y[i]);
+            maxY = std::max(maxY, y[i]);
+        }
+
+        // A sparse system spread over a large area would need far more cells than
+        // atoms; widening the cells keeps the grid O(N) and the search still exact
+        m_cellSize = cellSize;
+        const double maxCells = 4.0 * static_cast<double>(count) + 64.0;
+        while (((maxX - minX) / m_cellSize + 1.0) * ((maxY - minY) / m_cellSize + 1.0) > maxCells) {
+            m_cellSize *= 2.0;
+        }
+
+        m_originX = minX;
+        m_originY = minY;
+        m_columns = static_cast<int>((maxX - minX) / m_cellSize) + 1;
+        m_rows = static_cast<int>((maxY - minY) / m_cellSize) + 1;
+
+        // Counting sort: cell sizes, prefix sums, then scatter in index order
+        m_cellStart.assign(static_cast<size_t>(m_columns) * static_cast<size_t>(m_rows) + 1, 0);
+        for (size_t i = 0; i < count; ++i) {
+            const int column = std::min(static_cast<int>((x[i] - m_originX) / m_cellSize), m_columns - 1);
+            const int row = std::min(static_cast<int>((y[i] - m_originY) / m_cellSize), m_rows - 1);
+            m_cellOfAtom[i] = static_cast<uint32_t>(row * m_columns + column);
+            ++m_cellStart[m_cellOfAtom[i] + 1];
+        }
+        for (size_t cell = 1; cell < m_cellStart.size(); ++cell) {
+            m_cellStart[cell] += m_cellStart[cell - 1];
+        }
+
+        m_fillCursor.assign(m_cellStart.begin(), m_cellStart.end() - 1);
+        for (size_t i = 0; i < count; ++i) {
+            m_atomsByCell[m_fillCursor[m_cellOfAtom[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+}
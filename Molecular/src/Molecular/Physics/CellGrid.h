@@ -0,0 +1,55 @@
+#pragma once
+
+#include "AtomStore.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Molecular
+{
+    // Uniform cell list over the atoms' current positions.
+    //
+    // Atoms are binned into square cells at least cellSize wide, stored cell by
+    // cell (counting sort, no per-cell allocation). Any two atoms closer than
+    // cellSize are then in the same or adjacent cells, so a short-range search
+    // only visits the 3x3 block around an atom. Rebuild after atoms move.
+    class CellGrid
+    {
+    public:
+        void Build(const AtomStore& atoms, double cellSize);
+
+        // Calls f(j) for every atom j in the 3x3 cells around atom i, i itself included
+        template<typename F>
+        void ForEachNearby(size_t i, F&& f) const;
+
+        [[nodiscard]] double GetCellSize() const { return m_cellSize; }
+        [[nodiscard]] size_t GetCellCount() const { return m_cellStart.empty() ? 0 : m_cellStart.size() - 1; }
+
+    private:
+        double m_cellSize = 0.0;
+        double m_originX = 0.0, m_originY = 0.0;
+        int m_columns = 0, m_rows = 0;
+
+        std::vector<uint32_t> m_cellStart;     // Offsets into m_atomsByCell, one past per cell
+        std::vector<uint32_t> m_atomsByCell;
+        std::vector<uint32_t> m_cellOfAtom;
+        std::vector<uint32_t> m_fillCursor;
+    };
+
+    template<typename F>
+    void CellGrid::ForEachNearby(const size_t i, F&& f) const
+    {
+        const int column = static_cast<int>(m_cellOfAtom[i] % static_cast<uint32_t>(m_columns));
+        const int row = static_cast<int>(m_cellOfAtom[i] / static_cast<uint32_t>(m_columns));
+
+        for (int y = std::max(row - 1, 0); y <= std::min(row + 1, m_rows - 1); ++y) {
+            for (int x = std::max(column - 1, 0); x <= std::min(column + 1, m_columns - 1); ++x) {
+                const size_t cell = static_cast<size_t>(y) * static_cast<size_t>(m_columns) + static_cast<size_t>(x);
+                for (uint32_t k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+                    f(static_cast<size_t>(m_atomsByCell[k]));
+                }
+            }
+        }
+    }
+}
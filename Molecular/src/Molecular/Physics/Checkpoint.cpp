@@ -0,0 +1,232 @@
+#include "Checkpoint.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+namespace Molecular
+{
+    namespace
+    {
+        constexpr size_t Alignment = 8;
+
+        size_t PaddingFor(const size_t bytes)
+        {
+            return (Alignment - bytes % Alignment) % Alignment;
+        }
+
+        struct FileCloser
+        {
+            void operator()(std::FILE* file) const { std::fclose(file); }
+        };
+        using FilePointer = std::unique_ptr<std::FILE, FileCloser>;
+
+        // Pushes the written data from the OS cache to the disk, so the rename
+        // that follows cannot land before the contents
+        bool SyncToDisk(std::FILE* file)
+        {
+            if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+            return _commit(_fileno(file)) == 0;
+#else
+            return fsync(fileno(file)) == 0;
+#endif
+        }
+    }
+
+    void CheckpointEncoder::PutBytes(const void* data, const size_t bytes)
+    {
+        const auto* begin = static_cast<const uint8_t*>(data);
+        m_buffer.insert(m_buffer.end(), begin, begin + bytes);
+        m_buffer.resize(m_buffer.size() + PaddingFor(bytes), 0);
+    }
+
+    const uint8_t* CheckpointDecoder::Take(const size_t bytes)
+    {
+        const size_t padded = bytes + PaddingFor(bytes);
+        if (padded < bytes || padded > static_cast<size_t>(m_end - m_data)) {
+            throw std::runtime_error("Corrupt checkpoint: unexpected end of data");
+        }
+        const uint8_t* start = m_data;
+        m_data += padded;
+        return start;
+    }
+
+    std::string CheckpointDecoder::GetString()
+    {
+        std::vector<char> characters;
+        GetArray(characters);
+        return {characters.begin(), characters.end()};
+    }
+
+    uint64_t CheckpointChecksum(const uint8_t* data, const size_t size)
+    {
+        // FNV-1a, 64-bit
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ data[i]) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    void WriteCheckpointFile(const std::string& path, const std::vector<uint8_t>& payload)
+    {
+        using namespace CheckpointFormat;
+
+        FileHeader header{};
+        std::memcpy(header.magic, FileMagic, sizeof(header.magic));
+        header.byteOrderMark = ByteOrderMark;
+        header.version = Version;
+        header.payloadBytes = payload.size();
+        header.checksum = CheckpointChecksum(payload.data(), payload.size());
+
+        const std::string temporaryPath = path + ".tmp";
+        {
+            FilePointer file(std::fopen(temporaryPath.c_str(), "wb"));
+            if (!file) {
+                throw std::runtime_error("Could not create checkpoint file '" + temporaryPath + "'");
+            }
+            const bool written = std::fwrite(&header, sizeof(header), 1, file.get()) == 1 &&
+                                 std::fwrite(payload.data(), 1, payload.size(), file.get()) == payload.size() &&
+                                 SyncToDisk(file.get());
+            if (!written || std::fclose(file.release()) != 0) {
+                std::remove(temporaryPath.c_str());
+                throw std::runtime_error("Failed to write checkpoint file '" + temporaryPath + "'");
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error) {
+            std::remove(temporaryPath.c_str());
+            throw std::runtime_error("Could not replace checkpoint '" + path + "': " + error.message());
+        }
+    }
+
+    std::vector<uint8_t> ReadCheckpointFile(const std::string& path)
+    {
+        using namespace CheckpointFormat;
+
+        FilePointer file(std::fopen(path.c_str(), "rb"));
+        if (!file) {
+            throw std::runtime_error("Could not open checkpoint '" + path + "'");
+        }
+
+        FileHeader header{};
+        if (std::fread(&header, sizeof(header), 1, file.get()) != 1 ||
+            std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) != 0) {
+            throw std::runtime_error("'" + path + "' is not a checkpoint file");
+        }
+        if (header.byteOrderMark != ByteOrderMark) {
+            throw std::runtime_error("'" + path + "' was written with a different byte order");
+        }
+        if (header.version != Version) {
+            throw std::runtime_error("'" + path + "' has unsupported checkpoint version " + std::to_string(header.version));
+        }
+
+        // Size the buffer from the file, not the header, so a damaged header cannot
+        // ask for an arbitrary allocation
+        std::error_code error;
+        const uintmax_t fileSize = std::filesystem::file_size(path, error);
+        if (error || fileSize != sizeof(FileHeader) + header.payloadBytes) {
+            throw std::runtime_error("Corrupt checkpoint '" + path + "': size does not match its header");
+        }
+
+        std::vector<uint8_t> payload(static_cast<size_t>(header.payloadBytes));
+        if (std::fread(payload.data(), 1, payload.size(), file.get()) != payload.size()) {
+            throw std::runtime_error("Could not read checkpoint '" + path + "'");
+        }
+        if (CheckpointChecksum(payload.data(), payload.size()) != header.checksum) {
+            throw std::runtime_error("Corrupt checkpoint '" + path + "': checksum mismatch");
+        }
+        return payload;
+    }
+
+    CheckpointWriter::~CheckpointWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        if (m_ioThread.joinable()) {
+            m_ioThread.join();      // Finishes the checkpoint in flight first
+        }
+    }
+
+    bool CheckpointWriter::Submit(const std::string& path, std::vector<uint8_t>& payload)
+    {
+        RethrowIoError();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_hasPending) return false;
+            m_path = path;
+            m_pending.swap(payload);
+            m_hasPending = true;
+        }
+        if (!m_ioThread.joinable()) {
+            m_ioThread = std::thread(&CheckpointWriter::IoLoop, this);
+        }
+        m_wake.notify_one();
+        return true;
+    }
+
+    void CheckpointWriter::Wait()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_written.wait(lock, [this] { return !m_hasPending; });
+        }
+        RethrowIoError();
+    }
+
+    bool CheckpointWriter::IsBusy()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_hasPending;
+    }
+
+    void CheckpointWriter::IoLoop()
+    {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stopping || m_hasPending; });
+                if (!m_hasPending) return;
+            }
+
+            // m_path and m_pending are ours until m_hasPending is cleared
+            std::exception_ptr error;
+            try {
+                WriteCheckpointFile(m_path, m_pending);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (error && !m_error) {
+                    m_error = error;
+                }
+                m_hasPending = false;
+            }
+            m_written.notify_all();
+        }
+    }
+
+    void CheckpointWriter::RethrowIoError()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_error) {
+            std::exception_ptr error = m_error;
+            m_error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+}
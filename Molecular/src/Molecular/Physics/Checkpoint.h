@@ -0,0 +1,158 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Molecular
+{
+    // On-disk layout of a checkpoint file (.molckpt), in native byte order:
+    //
+    //   FileHeader
+    //   payload: payloadBytes written by a CheckpointEncoder
+    //
+    // The header carries an FNV-1a checksum of the payload. Files are written to
+    // "<path>.tmp", flushed to disk and renamed over <path>, so a crash leaves
+    // either the previous checkpoint or the new one, never a torn file.
+    namespace CheckpointFormat
+    {
+        constexpr char FileMagic[8] = {'M', 'O', 'L', 'C', 'K', 'P', 'T', '\0'};
+        constexpr uint32_t ByteOrderMark = 0x01020304;
+        constexpr uint32_t Version = 4;
+
+        struct FileHeader
+        {
+            char magic[8];
+            uint32_t byteOrderMark;
+            uint32_t version;
+            uint64_t payloadBytes;
+            uint64_t checksum;
+        };
+    }
+
+    // Appends values and arrays to a checkpoint payload. Each item is padded to
+    // 8 bytes, so arrays stay aligned in the loaded buffer.
+    class CheckpointEncoder
+    {
+    public:
+        explicit CheckpointEncoder(std::vector<uint8_t>& buffer) : m_buffer(buffer) {}
+
+        template<typename T>
+        void Put(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            PutBytes(&value, sizeof(T));
+        }
+
+        // Element count, then the elements
+        template<typename T>
+        void PutArray(const T* data, const size_t count)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            Put(static_cast<uint64_t>(count));
+            PutBytes(data, count * sizeof(T));
+        }
+
+        void PutString(const std::string& text) { PutArray(text.data(), text.size()); }
+
+    private:
+        void PutBytes(const void* data, size_t bytes);
+
+        std::vector<uint8_t>& m_buffer;
+    };
+
+    // Reads a payload back in the order it was encoded. Throws std::runtime_error
+    // instead of reading past the end.
+    class CheckpointDecoder
+    {
+    public:
+        CheckpointDecoder(const uint8_t* data, const size_t size) : m_data(data), m_end(data + size) {}
+
+        template<typename T>
+        T Get()
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            T value;
+            std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        // Any resizable contiguous container (std::vector, AlignedVector)
+        template<typename Container>
+        void GetArray(Container& out)
+        {
+            using T = typename Container::value_type;
+            static_assert(std::is_trivially_copyable_v<T>);
+            const auto count = Get<uint64_t>();
+            if (count > static_cast<uint64_t>(m_end - m_data) / sizeof(T)) {
+                throw std::runtime_error("Corrupt checkpoint: array runs past the end");
+            }
+            out.resize(static_cast<size_t>(count));
+            const size_t bytes = out.size() * sizeof(T);
+            if (bytes > 0) {
+                std::memcpy(out.data(), Take(bytes), bytes);
+            }
+        }
+
+        std::string GetString();
+        [[nodiscard]] bool AtEnd() const { return m_data == m_end; }
+
+    private:
+        const uint8_t* Take(size_t bytes);
+
+        const uint8_t* m_data;
+        const uint8_t* m_end;
+    };
+
+    uint64_t CheckpointChecksum(const uint8_t* data, size_t size);
+
+    // Writes header and payload to `path` atomically (see CheckpointFormat).
+    // Throws std::runtime_error on any I/O failure; `path` is then untouched.
+    void WriteCheckpointFile(const std::string& path, const std::vector<uint8_t>& payload);
+
+    // Reads the payload in one read and verifies it against the header. Throws
+    // std::runtime_error for a missing, truncated, corrupt or foreign file.
+    std::vector<uint8_t> ReadCheckpointFile(const std::string& path);
+
+    // Writes checkpoints on a background thread, one at a time.
+    class CheckpointWriter
+    {
+    public:
+        CheckpointWriter() = default;
+        ~CheckpointWriter();
+
+        CheckpointWriter(const CheckpointWriter&) = delete;
+        CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+        // Swaps the payload into the I/O thread (the caller gets an old buffer
+        // back to refill). Returns false and keeps the payload while the previous
+        // checkpoint is still being written. Rethrows that write's error.
+        bool Submit(const std::string& path, std::vector<uint8_t>& payload);
+        // Waits for the checkpoint in flight; rethrows its error
+        void Wait();
+        [[nodiscard]] bool IsBusy();
+
+    private:
+        void IoLoop();
+        void RethrowIoError();
+
+        std::thread m_ioThread;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_written;
+
+        // Guarded by m_mutex
+        std::string m_path;
+        std::vector<uint8_t> m_pending;
+        bool m_hasPending = false;
+        bool m_stopping = false;
+        std::exception_ptr m_error;
+    };
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace Molecular
+{
+    // Counter-based random number generator (Philox4x32-10, Salmon et al. 2011).
+    //
+    // There is no mutable generator state: every draw is a pure function of
+    // (seed, stream, counter). Using the atom index as the stream and the step
+    // index as the counter gives each atom its own independent sequence, so
+    // the numbers an atom sees never depend on which thread integrates it or
+    // in which order atoms are visited.
+    class CounterRng
+    {
+    public:
+        using Block = std::array<uint32_t, 4>;
+
+        explicit CounterRng(const uint64_t seed = 0)
+            : m_key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)} {}
+
+        void SetSeed(const uint64_t seed) { m_key = {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}; }
+        [[nodiscard]] uint64_t GetSeed() const { return (static_cast<uint64_t>(m_key[1]) << 32) | m_key[0]; }
+
+        // Four independent 32-bit words for the given (stream, counter) pair
+        [[nodiscard]] Block Generate(const uint64_t stream, const uint64_t counter) const
+        {
+            Block ctr = {static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+                         static_cast<uint32_t>(stream),  static_cast<uint32_t>(stream >> 32)};
+            std::array<uint32_t, 2> key = m_key;
+
+            for (int round = 0; round < 10; ++round) {
+                ctr = Round(ctr, key);
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+            }
+            return ctr;
+        }
+
+        // Two standard-normal deviates (Box-Muller on two 53-bit uniforms)
+        [[nodiscard]] std::array<double, 2> Gaussian2(const uint64_t stream, const uint64_t counter) const
+        {
+            constexpr double twoPi = 6.28318530717958647692;
+
+            const Block bits = Generate(stream, counter);
+            const double u1 = ToUnitOpen(bits[0], bits[1]);   // (0, 1]
+            const double u2 = ToUnitOpen(bits[2], bits[3]);
+
+            const double radius = std::sqrt(-2.0 * std::log(u1));
+            const double angle = twoPi * u2;
+            return {radius * std::cos(angle), radius * std::sin(angle)};
+        }
+
+    private:
+        static Block Round(const Block& ctr, const std::array<uint32_t, 2>& key)
+        {
+            constexpr uint64_t m0 = 0xD2511F53u;
+            constexpr uint64_t m1 = 0xCD9E8D57u;
+
+            const uint64_t p0 = m0 * ctr[0];
+            const uint64_t p1 = m1 * ctr[2];
+
+            return {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+                    static_cast<uint32_t>(p1),
+                    static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+                    static_cast<uint32_t>(p0)};
+        }
+
+        // Map 64 random bits to a double in (0, 1], never returning 0 so log() stays finite
+        static double ToUnitOpen(const uint32_t lo, const uint32_t hi)
+        {
+            const uint64_t bits = ((static_cast<uint64_t>(hi) << 32) | lo) >> 11;
+            return (static_cast<double>(bits) + 1.0) * (1.0 / 9007199254740992.0);
+        }
+
+        std::array<uint32_t, 2> m_key;
+    };
+}
@@ -0,0 +1,117 @@
+#include "Determinism.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+namespace Molecular
+{
+    namespace
+    {
+        constexpr uint64_t HashBasis = 0xCBF29CE484222325ull;
+        constexpr uint64_t HashPrime = 0x100000001B3ull;
+
+        // FNV-1a over whole 64-bit words rather than bytes: one multiply per value
+        // keeps hashing every step cheap next to the force pass
+        void Mix(uint64_t& hash, const uint64_t word)
+        {
+            hash = (hash ^ word) * HashPrime;
+        }
+
+        void MixArray(uint64_t& hash, const double* values, const size_t count)
+        {
+            for (size_t i = 0; i < count; ++i) {
+                uint64_t bits;
+                std::memcpy(&bits, &values[i], sizeof(bits));
+                Mix(hash, bits);
+            }
+        }
+
+        struct FileCloser
+        {
+            void operator()(std::FILE* file) const { std::fclose(file); }
+        };
+        using FilePointer = std::unique_ptr<std::FILE, FileCloser>;
+    }
+
+    uint64_t HashState(const AtomStore& atoms)
+    {
+        const size_t count = atoms.size();
+        uint64_t hash = HashBasis;
+        Mix(hash, count);
+        MixArray(hash, atoms.GetX(), count);
+        MixArray(hash, atoms.GetY(), count);
+        MixArray(hash, atoms.GetVX(), count);
+        MixArray(hash, atoms.GetVY(), count);
+        // Position Verlet carries its velocity here
+        MixArray(hash, atoms.GetPreviousX(), count);
+        MixArray(hash, atoms.GetPreviousY(), count);
+
+        const uint32_t* ids = atoms.GetIds();
+        for (size_t i = 0; i < count; ++i) {
+            Mix(hash, ids[i]);
+        }
+        for (const BondEdge& edge : atoms.GetBondEdges()) {
+            Mix(hash, (static_cast<uint64_t>(edge.first) << 32) | edge.second);
+        }
+        return hash;
+    }
+
+    Divergence FindFirstDivergence(const std::vector<StateHashEntry>& first,
+                                   const std::vector<StateHashEntry>& second)
+    {
+        Divergence divergence;
+        const size_t common = std::min(first.size(), second.size());
+        for (size_t k = 0; k < common; ++k) {
+            if (first[k].step != second[k].step || first[k].hash != second[k].hash) {
+                divergence.diverged = true;
+                divergence.step = std::min(first[k].step, second[k].step);
+                divergence.comparedSteps = k;
+                return divergence;
+            }
+        }
+        divergence.comparedSteps = common;
+        if (first.size() != second.size()) {
+            divergence.diverged = true;
+            divergence.step = (first.size() > common ? first : second)[common].step;
+        }
+        return divergence;
+    }
+
+    void WriteStateHashLog(const std::string& path, const std::vector<StateHashEntry>& entries)
+    {
+        FilePointer file(std::fopen(path.c_str(), "w"));
+        if (!file) {
+            throw std::runtime_error("Could not create state hash log '" + path + "'");
+        }
+        for (const StateHashEntry& entry : entries) {
+            std::fprintf(file.get(), "%" PRIu64 " %016" PRIx64 "\n", entry.step, entry.hash);
+        }
+        if (std::fclose(file.release()) != 0) {
+            throw std::runtime_error("Failed to write state hash log '" + path + "'");
+        }
+    }
+
+    std::vector<StateHashEntry> ReadStateHashLog(const std::string& path)
+    {
+        FilePointer file(std::fopen(path.c_str(), "r"));
+        if (!file) {
+            throw std::runtime_error("Could not open state hash log '" + path + "'");
+        }
+
+        std::vector<StateHashEntry> entries;
+        StateHashEntry entry;
+        int fields;
+        while ((fields = std::fscanf(file.get(), "%" SCNu64 " %" SCNx64, &entry.step, &entry.hash)) == 2) {
+            entries.push_back(entry);
+        }
+        if (fields != EOF) {
+            throw std::runtime_error("Malformed state hash log '" + path + "' after " +
+                                     std::to_string(entries.size()) + " entries");
+        }
+        return entries;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "AtomStore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Molecular
+{
+    // Hash of the full dynamic state after one step
+    struct StateHashEntry
+    {
+        uint64_t step = 0;
+        uint64_t hash = 0;
+    };
+
+    // Bit-level hash of positions, velocities, ids and bonds, in store order. Two
+    // runs that agree on every bit (including atom order) hash the same; any
+    // difference, even in the last bit of one coordinate, almost surely does not.
+    [[nodiscard]] uint64_t HashState(const AtomStore& atoms);
+
+    // First step at which two hash logs disagree
+    struct Divergence
+    {
+        bool diverged = false;
+        uint64_t step = 0;          // First step that differs, or that only one log has
+        size_t comparedSteps = 0;   // Steps both logs agree on before it
+    };
+
+    [[nodiscard]] Divergence FindFirstDivergence(const std::vector<StateHashEntry>& first,
+                                                 const std::vector<StateHashEntry>& second);
+
+    // One "step hash" line per entry, hash in hex. Both throw std::runtime_error
+    // when the file cannot be written or read.
+    void WriteStateHashLog(const std::string& path, const std::vector<StateHashEntry>& entries);
+    std::vector<StateHashEntry> ReadStateHashLog(const std::string& path);
+}
@@ -1,10 +1,41 @@
 #include "ForceCalculator.h"
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include "gtx/norm.hpp"
+#include "PairKernel.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace Molecular
 {
+    namespace
+    {
+        struct PairParameters {
+            double epsilon;
+            double sigma;
+        };
+
+        // Mixed Lennard-Jones parameters for every element pair, built at compile time
+        constexpr auto MakePairTable()
+        {
+            std::array<std::array<PairParameters, ElementCount>, ElementCount> table{};
+            for (size_t a = 0; a < ElementCount; ++a) {
+                for (size_t b = 0; b < ElementCount; ++b) {
+                    table[a][b] = {(elementTable[a].epsilon + elementTable[b].epsilon) / 2.0,
+                                   (elementTable[a].sigma + elementTable[b].sigma) / 2.0};
+                }
+            }
+            return table;
+        }
+
+        constexpr auto pairTable = MakePairTable();
+
+        constexpr const PairParameters& GetPairParameters(const ElementId a, const ElementId b)
+        {
+            return pairTable[static_cast<size_t>(a)][static_cast<size_t>(b)];
+        }
+    }
+
     ForceCalculator::ForceCalculator(const double energyLossFactor)
         : m_energyLossFactor(energyLossFactor) {
     }
@@ -14,7 +45,8 @@ namespace Molecular
         const double epsilon = (a.GetEpsilonD() + b.GetEpsilonD()) / 2.0;
         const double sigma = (a.GetSigmaD() + b.GetSigmaD()) / 2.0;
 
-        const glm::dvec2 r = b.GetPositionD() - a.GetPositionD();
+        // Separation from b to a: a positive (repulsive) magnitude pushes a away from b
+        const glm::dvec2 r = a.GetPositionD() - b.GetPositionD();
         constexpr double softening = 1e-2;
         const double r_len = glm::length(r) + softening;
 
@@ -39,7 +71,8 @@ namespace Molecular
         constexpr double softening = 1e-10;     // Softens singularity at r ≈ 0
         constexpr double dielectric = 1.0;      // Relative permittivity (1.0 = vacuum)
 
-        const glm::dvec2 r = b.GetPositionD() - a.GetPositionD();
+        // Separation from b to a: like charges (q1*q2 > 0) push a away from b
+        const glm::dvec2 r = a.GetPositionD() - b.GetPositionD();
         const double r_len = glm::length(r);
 
         if (r_len < 1e-10) return glm::dvec2(0.0);
@@ -56,76 +89,158 @@ namespace Molecular
         return glm::normalize(r) * forceMagnitude;
     }
 
-    glm::dvec2 ForceCalculator::CalculateTotalForce(const Atom& atom, const std::vector<Atom>& allAtoms, const size_t atomIndex) const
+    double ForceCalculator::CalculateForces(AtomStore& atoms) const
     {
-        glm::dvec2 totalForce(0.0);
+        const size_t count = atoms.size();
+        const double* x = atoms.GetX();
+        const double* y = atoms.GetY();
+        const double* charge = atoms.GetCharges();
+        const ElementId* element = atoms.GetElementIds();
+        double* fx = atoms.GetFX();
+        double* fy = atoms.GetFY();
+
+        // The virial rides along for the pressure observable. It is summed per fixed
+        // block of rows and the blocks are added in order, so the total does not
+        // depend on how the rows were spread over threads.
+        const size_t blockCount = (count + m_forceRowBlock - 1) / m_forceRowBlock;
+        m_virialBlocks.assign(blockCount, 0.0);
+
+        if (m_pool != nullptr && blockCount >= m_minBlocksPerThread * m_pool->GetThreadCount()) {
+            // Whole rows per thread: each atom sums its own partners in ascending
+            // index, negating pair(j, i) for j < i, which is the exact sequence the
+            // pair loop below adds into it. Forces match the serial pass bit for bit
+            // at the price of evaluating every pair twice.
+            m_pool->ParallelFor(blockCount, m_minBlocksPerThread, [&](const size_t begin, const size_t end, size_t) {
+                for (size_t block = begin; block < end; ++block) {
+                    double virial = 0.0;
+                    for (size_t i = block * m_forceRowBlock; i < std::min(count, (block + 1) * m_forceRowBlock); ++i) {
+                        double forceX = 0.0, forceY = 0.0;
+                        for (size_t j = 0; j < i; ++j) {
+                            const PairParameters& pair = GetPairParameters(element[j], element[i]);
+                            double pairX, pairY;
+                            PairKernel::Force(x[j] - x[i], y[j] - y[i], pair.epsilon, pair.sigma,
+                                              charge[j] * charge[i], m_maxForce, pairX, pairY);
+                            forceX -= pairX;
+                            forceY -= pairY;
+                        }
+                        for (size_t j = i + 1; j < count; ++j) {
+                            const PairParameters& pair = GetPairParameters(element[i], element[j]);
+                            const double dx = x[i] - x[j];
+                            const double dy = y[i] - y[j];
+                            double pairX, pairY;
+                            PairKernel::Force(dx, dy, pair.epsilon, pair.sigma,
+                                              charge[i] * charge[j], m_maxForce, pairX, pairY);
+                            forceX += pairX;
+                            forceY += pairY;
+                            virial += dx * pairX + dy * pairY;
+                        }
+                        fx[i] = forceX;
+                        fy[i] = forceY;
+                    }
+                    m_virialBlocks[block] = virial;
+                }
+            });
+        } else {
+            std::fill(fx, fx + count, 0.0);
+            std::fill(fy, fy + count, 0.0);
+
+            // Each pair once; the pair terms are antisymmetric, so j gets the opposite force
+            for (size_t i = 0; i < count; ++i) {
+                double& virial = m_virialBlocks[i / m_forceRowBlock];
+                for (size_t j = i + 1; j < count; ++j) {
+                    const PairParameters& pair = GetPairParameters(element[i], element[j]);
+
+                    const double dx = x[i] - x[j];
+                    const double dy = y[i] - y[j];
+                    double pairX, pairY;
+                    PairKernel::Force(dx, dy, pair.epsilon, pair.sigma,
+                                      charge[i] * charge[j], m_maxForce, pairX, pairY);
+                    fx[i] += pairX;
+                    fy[i] += pairY;
+                    fx[j] -= pairX;
+                    fy[j] -= pairY;
+                    virial += dx * pairX + dy * pairY;
+                }
+            }
+        }
 
-        // Calculate pairwise forces
-        for (size_t j = 0; j < allAtoms.size(); ++j) {
-            if (atomIndex != j) {
-                totalForce += CalculateVanDerWaalsForce(atom, allAtoms[j]);
-                totalForce += CalculateCoulombForce(atom, allAtoms[j]);
+        double virial = 0.0;
+        for (const double blockVirial : m_virialBlocks) {
+            virial += blockVirial;
+        }
+        m_lastVirial = virial;
+
+        // Clamp each total force to prevent numerical instability
+        double maxForce = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            const double magnitude = std::sqrt(fx[i] * fx[i] + fy[i] * fy[i]);
+            if (magnitude > m_maxForce) {
+                fx[i] *= m_maxForce / magnitude;
+                fy[i] *= m_maxForce / magnitude;
             }
+            maxForce = std::max(maxForce, std::min(magnitude, m_maxForce));
         }
 
-        return ClampForce(totalForce);
+        return maxForce;
     }
 
-    double ForceCalculator::CalculateTotalEnergy(const std::vector<Atom>& atoms) {
+    double ForceCalculator::CalculateTotalEnergy(const AtomStore& atoms) {
         return CalculateKineticEnergy(atoms) + CalculatePotentialEnergy(atoms);
     }
 
-    double ForceCalculator::CalculateKineticEnergy(const std::vector<Atom>& atoms) {
-        double totalKineticEnergy = 0.0;
+    double ForceCalculator::CalculateKineticEnergy(const AtomStore& atoms) {
+        const double* vx = atoms.GetVX();
+        const double* vy = atoms.GetVY();
+        const double* mass = atoms.GetMasses();
 
-        for (const auto& atom : atoms) {
-            const double speedSquared = glm::length2(atom.GetVelocityD()); // v^2
-            totalKineticEnergy += 0.5 * atom.GetMassD() * speedSquared;
+        double totalKineticEnergy = 0.0;
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            totalKineticEnergy += 0.5 * mass[i] * (vx[i] * vx[i] + vy[i] * vy[i]);
         }
 
         return totalKineticEnergy;
     }
 
-    double ForceCalculator::CalculatePotentialEnergy(const std::vector<Atom>& atoms) {
+    double ForceCalculator::CalculateTemperature(const AtomStore& atoms) {
+        if (atoms.empty()) return 0.0;
+
+        // <KE> = N * (2 * 1/2 * k_B*T)
+        return CalculateKineticEnergy(atoms) / static_cast<double>(atoms.size());
+    }
+
+    double ForceCalculator::CalculatePotentialEnergy(const AtomStore& atoms) {
+        const double* x = atoms.GetX();
+        const double* y = atoms.GetY();
+        const ElementId* element = atoms.GetElementIds();
+
         double totalPotentialEnergy = 0.0;
 
         // Potential Energy Calculation (Pairwise)
         for (size_t i = 0; i < atoms.size(); ++i) {
             for (size_t j = i + 1; j < atoms.size(); ++j) {
-                const Atom& a = atoms[i];
-                const Atom& b = atoms[j];
-
-                const double epsilon = (a.GetEpsilonD() + b.GetEpsilonD()) / 2.0;
-                const double sigma = (a.GetSigmaD() + b.GetSigmaD()) / 2.0;
-
-                glm::dvec2 r = b.GetPositionD() - a.GetPositionD();
-
-                if (const double r_len = glm::length(r); r_len > 1e-10) { // Avoid division by zero
-                    const double r6 = glm::pow(sigma / r_len, 6);
-                    const double r12 = r6 * r6;
-                    totalPotentialEnergy += 4.0 * epsilon * (r12 - r6);
-                }
+                const PairParameters& pair = GetPairParameters(element[i], element[j]);
+                totalPotentialEnergy += PairKernel::Energy(x[j] - x[i], y[j] - y[i], pair.epsilon, pair.sigma);
             }
         }
 
         return totalPotentialEnergy;
     }
 
-    void ForceCalculator::HandleCollision(Atom& a, Atom& b) const
+    void ForceCalculator::HandleCollision(AtomStore& atoms, const size_t i, const size_t j) const
     {
         // Calculate the vector between the two atoms' positions
-        const glm::dvec2 r = b.GetPositionD() - a.GetPositionD();
+        const glm::dvec2 r = atoms.GetPosition(j) - atoms.GetPosition(i);
         const double r_len = glm::length(r);
 
         // Calculate minimum distance based on bond status
 
-        if (const double minDistance = CalculateMinDistance(a, b); r_len < minDistance && r_len > 1e-10) {
+        if (const double minDistance = CalculateMinDistance(atoms, i, j); r_len < minDistance && r_len > 1e-10) {
             // Calculate the normal vector between atoms
-            const glm::dvec2 normal = glm::normalize(r);
+            const glm::dvec2 normal = r / r_len;
 
             // Get current velocities
-            const glm::dvec2 velocityA = a.GetVelocityD();
-            const glm::dvec2 velocityB = b.GetVelocityD();
+            const glm::dvec2 velocityA = atoms.GetVelocity(i);
+            const glm::dvec2 velocityB = atoms.GetVelocity(j);
 
             // Reflection formula: v' = v - 2 * (v . n) * n
             const double dotProductA = glm::dot(velocityA, normal);
@@ -140,28 +255,37 @@ namespace Molecular
 
             // Adjust positions to prevent overlap
             const glm::dvec2 displacement = normal * (minDistance - r_len) * 0.5;
-            a.SetPosition(a.GetPositionD() - displacement);
-            b.SetPosition(b.GetPositionD() + displacement);
+            atoms.SetPosition(i, atoms.GetPosition(i) - displacement);
+            atoms.SetPosition(j, atoms.GetPosition(j) + displacement);
 
             // Set the new velocities
-            a.SetVelocity(reflectedVelocityA);
-            b.SetVelocity(reflectedVelocityB);
+            atoms.SetVelocity(i, reflectedVelocityA);
+            atoms.SetVelocity(j, reflectedVelocityB);
         }
     }
 
-    double ForceCalculator::CalculateMinDistance(const Atom& a, const Atom& b) {
-        if (a.IsBondedTo(&b)) {
-            return (a.GetCovalentBondLengthD() + b.GetCovalentBondLengthD()) * 0.5;
-        } else {
-            return (a.GetVanDerWaalsRadiusD() + b.GetVanDerWaalsRadiusD()) * 0.9;
+    void ForceCalculator::ResolveOverlap(AtomStore& atoms, const size_t i, const size_t j)
+    {
+        const glm::dvec2 r = atoms.GetPosition(j) - atoms.GetPosition(i);
+        const double r_len = glm::length(r);
+
+        if (const double minDistance = CalculateMinDistance(atoms, i, j); r_len < minDistance && r_len > 1e-10) {
+            // Push both atoms apart symmetrically; the implicit velocity (x - x_prev)/dt
+            // picks up the correction, which is the position-based collision response
+            const glm::dvec2 displacement = r / r_len * (minDistance - r_len) * 0.5;
+            atoms.SetPosition(i, atoms.GetPosition(i) - displacement);
+            atoms.SetPosition(j, atoms.GetPosition(j) + displacement);
         }
     }
 
-    glm::dvec2 ForceCalculator::ClampForce(const glm::dvec2& force) const
-    {
-        if (const double magnitude = glm::length(force); magnitude > m_maxForce) {
-            return glm::normalize(force) * m_maxForce;
+    double ForceCalculator::CalculateMinDistance(const AtomStore& atoms, const size_t i, const size_t j) {
+        const AtomProperties& a = atoms.GetProperties(i);
+        const AtomProperties& b = atoms.GetProperties(j);
+
+        if (atoms.IsBondedTo(i, j)) {
+            return (a.bondLength + b.bondLength) * 0.5;
+        } else {
+            return (a.vanDerWaalsRadius + b.vanDerWaalsRadius) * 0.9;
         }
-        return force;
     }
-}
+}
\ No newline at end of file
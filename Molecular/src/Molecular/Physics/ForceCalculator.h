@@ -1,9 +1,14 @@
 #pragma once
 
 #include "Atom.h"
+#include "AtomStore.h"
+
+#include <vector>
 
 namespace Molecular
 {
+    class ThreadPool;
+
     class ForceCalculator
     {
     public:
@@ -11,25 +16,43 @@ namespace Molecular
 
         [[nodiscard]] glm::dvec2 CalculateVanDerWaalsForce(const Atom& a, const Atom& b) const;
         [[nodiscard]] glm::dvec2 CalculateCoulombForce(const Atom& a, const Atom& b) const;
-        [[nodiscard]] glm::dvec2 CalculateTotalForce(const Atom& atom, const std::vector<Atom>& allAtoms, size_t atomIndex) const;
-
-        static double CalculateTotalEnergy(const std::vector<Atom>& atoms);
-        static double CalculateKineticEnergy(const std::vector<Atom>& atoms);
-        static double CalculatePotentialEnergy(const std::vector<Atom>& atoms);
-
-        void HandleCollision(Atom& a, Atom& b) const;
+        // Full force pass over the store: fills its force arrays, one evaluation per
+        // pair (Newton's third law), then clamps each total. Returns the largest |F_i|.
+        // With a thread pool, large stores are split by rows; the result is bit-identical
+        // to the serial pass for any thread count.
+        double CalculateForces(AtomStore& atoms) const;
+
+        static double CalculateTotalEnergy(const AtomStore& atoms);
+        static double CalculateKineticEnergy(const AtomStore& atoms);
+        static double CalculatePotentialEnergy(const AtomStore& atoms);
+        // Instantaneous k_B*T from equipartition (2 degrees of freedom per atom in 2D)
+        static double CalculateTemperature(const AtomStore& atoms);
+
+        void HandleCollision(AtomStore& atoms, size_t i, size_t j) const;
+        // Position-only overlap separation for schemes that carry no velocity (position Verlet)
+        static void ResolveOverlap(AtomStore& atoms, size_t i, size_t j);
 
         void SetEnergyLossFactor(const double factor) { m_energyLossFactor = factor; }
         void SetMaxForce(const double maxForce) { m_maxForce = maxForce; }
+        // Workers for CalculateForces; nullptr runs it on the calling thread
+        void SetThreadPool(ThreadPool* pool) { m_pool = pool; }
 
         [[nodiscard]] double GetEnergyLossFactor() const { return m_energyLossFactor; }
         [[nodiscard]] double GetMaxForce() const { return m_maxForce; }
+        // Σ r_ij·F_ij over all pairs from the most recent CalculateForces (unclamped totals)
+        [[nodiscard]] double GetLastVirial() const { return m_lastVirial; }
 
     private:
         double m_energyLossFactor;
         double m_maxForce = 1e3;
+        mutable double m_lastVirial = 0.0;
+
+        // Rows per virial partial sum, and the fewest blocks worth a thread
+        static constexpr size_t m_forceRowBlock = 32;
+        static constexpr size_t m_minBlocksPerThread = 2;
+        ThreadPool* m_pool = nullptr;
+        mutable std::vector<double> m_virialBlocks;
 
-        static double CalculateMinDistance(const Atom& a, const Atom& b);
-        [[nodiscard]] glm::dvec2 ClampForce(const glm::dvec2& force) const;
+        static double CalculateMinDistance(const AtomStore& atoms, size_t i, size_t j);
     };
 }
\ No newline at end of file
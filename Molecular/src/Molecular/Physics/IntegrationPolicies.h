@@ -0,0 +1,90 @@
+#pragma once
+
+#include "AtomStore.h"
+#include "BoundingBox.h"
+#include "ForceCalculator.h"
+#include "CounterRng.h"
+
+#include <variant>
+
+namespace Molecular
+{
+    enum class IntegrationMethod {
+        Euler,
+        RungeKutta4,
+        LeapFrog,
+        VelocityVerlet,
+        Langevin,
+        Verlet
+    };
+
+    // Langevin thermostat parameters. Temperature is k_B*T in the same energy
+    // units as ForceCalculator::CalculateKineticEnergy; friction is in 1/s.
+    struct ThermostatSettings {
+        double targetTemperature = 1.0;
+        double friction = 1.0;
+    };
+
+    // Everything a policy may use during one step, shared by all atoms
+    struct StepContext {
+        const BoundingBox& boundingBox;
+        const ForceCalculator& forceCalc;
+        const ThermostatSettings& thermostat;
+        const CounterRng& rng;
+        uint64_t stepIndex;
+        // Reusable per-step work arrays (RK4 stage state)
+        std::vector<double>& scratch;
+    };
+
+    // Integration policies. Each one advances the whole store by dt, looping over
+    // the position/velocity/force arrays; the step in Integrator is instantiated
+    // once per policy, so there is no per-atom dispatch. Before Advance the step
+    // resolves overlaps (with velocity reflection, or by moving positions only
+    // when the policy carries no velocity: PositionOnlyCollisions) and fills the
+    // force arrays for the current positions. Policies that need forces at new
+    // positions run further force passes themselves.
+    //
+    // Adding a method means adding a policy here and listing it in
+    // IntegrationPolicy below.
+
+    struct EulerPolicy {
+        static constexpr IntegrationMethod Method = IntegrationMethod::Euler;
+        static constexpr bool PositionOnlyCollisions = false;
+        static void Advance(AtomStore& atoms, double dt, const StepContext& ctx);
+    };
+
+    struct RungeKutta4Policy {
+        static constexpr IntegrationMethod Method = IntegrationMethod::RungeKutta4;
+        static constexpr bool PositionOnlyCollisions = false;
+        static void Advance(AtomStore& atoms, double dt, const StepContext& ctx);
+    };
+
+    struct LeapFrogPolicy {
+        static constexpr IntegrationMethod Method = IntegrationMethod::LeapFrog;
+        static constexpr bool PositionOnlyCollisions = false;
+        static void Advance(AtomStore& atoms, double dt, const StepContext& ctx);
+    };
+
+    struct VelocityVerletPolicy {
+        static constexpr IntegrationMethod Method = IntegrationMethod::VelocityVerlet;
+        static constexpr bool PositionOnlyCollisions = false;
+        static void Advance(AtomStore& atoms, double dt, const StepContext& ctx);
+    };
+
+    // BAOAB splitting with an exact Ornstein-Uhlenbeck step
+    struct LangevinPolicy {
+        static constexpr IntegrationMethod Method = IntegrationMethod::Langevin;
+        static constexpr bool PositionOnlyCollisions = false;
+        static void Advance(AtomStore& atoms, double dt, const StepContext& ctx);
+    };
+
+    // Position (Stormer) Verlet on (x, x_prev): one force evaluation, no velocity
+    struct VerletPolicy {
+        static constexpr IntegrationMethod Method = IntegrationMethod::Verlet;
+        static constexpr bool PositionOnlyCollisions = true;
+        static void Advance(AtomStore& atoms, double dt, const StepContext& ctx);
+    };
+
+    using IntegrationPolicy = std::variant<EulerPolicy, RungeKutta4Policy, LeapFrogPolicy,
+                                           VelocityVerletPolicy, LangevinPolicy, VerletPolicy>;
+}
@@ -1,224 +1,348 @@
 #include "Integrator.h"
 
 #include <algorithm>
+#include <cmath>
 
 namespace Molecular
 {
-    Integrator::Integrator(const IntegrationMethod method)
-        : m_method(method) {
-    }
-
-    void Integrator::Integrate(Atom& atom, const size_t atomIndex, const double dt,
-                              const std::vector<Atom>& allAtoms,
-                              const BoundingBox& boundingBox,
-                              ForceCalculator& forceCalc) const
+    namespace
     {
-        double actualDt = dt;
+        void HandleCollisions(AtomStore& atoms, const ForceCalculator& forceCalc)
+        {
+            // Each overlapping pair is resolved once per step
+            for (size_t i = 0; i < atoms.size(); ++i) {
+                for (size_t j = i + 1; j < atoms.size(); ++j) {
+                    forceCalc.HandleCollision(atoms, i, j);
+                }
+            }
+        }
 
-        // Use adaptive time stepping if enabled
-        if (m_useAdaptiveTimeStep) {
-            actualDt = AdaptiveTimeStep(atom, atomIndex, dt, allAtoms, forceCalc);
+        void ResolveOverlaps(AtomStore& atoms)
+        {
+            for (size_t i = 0; i < atoms.size(); ++i) {
+                for (size_t j = i + 1; j < atoms.size(); ++j) {
+                    ForceCalculator::ResolveOverlap(atoms, i, j);
+                }
+            }
         }
 
-        switch (m_method) {
-        case IntegrationMethod::Euler:
-            EulerStep(atom, atomIndex, actualDt, allAtoms, boundingBox, forceCalc);
-            break;
-        case IntegrationMethod::RungeKutta4:
-            RungeKutta4Step(atom, atomIndex, actualDt, allAtoms, boundingBox, forceCalc);
-            break;
-        case IntegrationMethod::LeapFrog:
-            LeapFrogStep(atom, atomIndex, actualDt, allAtoms, boundingBox, forceCalc);
-            break;
-        default:
-            VelocityVerletStep(atom, atomIndex, actualDt, allAtoms, boundingBox, forceCalc);
-            break;
+        // Writes (x, y, vx, vy) of atom i back after reflecting off the walls
+        void StoreWithWalls(AtomStore& atoms, const size_t i, glm::dvec2 position, glm::dvec2 velocity,
+                            const BoundingBox& boundingBox)
+        {
+            Integrator::HandleBoundaryCollision(position, velocity, boundingBox);
+            atoms.SetPosition(i, position);
+            atoms.SetVelocity(i, velocity);
+        }
+
+        // Finds the policy whose Method matches, walking the variant's alternatives
+        template<size_t Index = 0>
+        IntegrationPolicy MakePolicy(const IntegrationMethod method)
+        {
+            if constexpr (Index < std::variant_size_v<IntegrationPolicy>) {
+                using Policy = std::variant_alternative_t<Index, IntegrationPolicy>;
+                if (Policy::Method == method) {
+                    return Policy{};
+                }
+                return MakePolicy<Index + 1>(method);
+            } else {
+                return VelocityVerletPolicy{};
+            }
         }
     }
 
-    void Integrator::InitializeVerlet(std::vector<Atom>& atoms, const double dt,
-                                     const BoundingBox& boundingBox,
-                                     const ForceCalculator& forceCalc)
-    {
-        // Initialize previous positions for Verlet method
-        for (size_t i = 0; i < atoms.size(); ++i) {
-            Atom& atom = atoms[i];
+    // === Integration policies ===
 
-            // Calculate initial acceleration
-            const glm::dvec2 initialAcceleration = ComputeAcceleration(atom, i,
-                                                                      atom.GetPositionD(),
-                                                                      atom.GetVelocityD(),
-                                                                      atoms, forceCalc);
+    void EulerPolicy::Advance(AtomStore& atoms, const double dt, const StepContext& ctx)
+    {
+        const double* x = atoms.GetX();
+        const double* y = atoms.GetY();
+        const double* vx = atoms.GetVX();
+        const double* vy = atoms.GetVY();
+        const double* fx = atoms.GetFX();
+        const double* fy = atoms.GetFY();
+        const double* inverseMass = atoms.GetInverseMasses();
 
-            // Set previous position using: x(t-dt) = x(t) - v(t)*dt + 0.5*a(t)*dt^2
-            const glm::dvec2 previousPosition = atom.GetPositionD() - atom.GetVelocityD() * dt +
-                                               0.5 * initialAcceleration * dt * dt;
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            // Euler integration: v(t+dt) = v(t) + a(t)*dt, x(t+dt) = x(t) + v(t)*dt
+            const glm::dvec2 newVelocity(vx[i] + fx[i] * inverseMass[i] * dt, vy[i] + fy[i] * inverseMass[i] * dt);
+            const glm::dvec2 newPosition(x[i] + vx[i] * dt, y[i] + vy[i] * dt);
 
-            atom.SetPreviousPosition(previousPosition);
+            StoreWithWalls(atoms, i, newPosition, newVelocity, ctx.boundingBox);
         }
     }
 
-    void Integrator::EulerStep(Atom& atom, const size_t atomIndex, const double dt,
-                              const std::vector<Atom>& allAtoms,
-                              const BoundingBox& boundingBox,
-                              const ForceCalculator& forceCalc)
+    void RungeKutta4Policy::Advance(AtomStore& atoms, const double dt, const StepContext& ctx)
     {
-        // Handle collisions first
-        HandleCollisions(atom, atomIndex, allAtoms, forceCalc);
+        const size_t count = atoms.size();
+        double* x = atoms.GetX();
+        double* y = atoms.GetY();
+        double* vx = atoms.GetVX();
+        double* vy = atoms.GetVY();
+        const double* fx = atoms.GetFX();
+        const double* fy = atoms.GetFY();
+        const double* inverseMass = atoms.GetInverseMasses();
+
+        // Stage state: x(t), the previous stage's dx/dt, and the weighted sums of
+        // dx/dt and dv/dt. v(t) stays in the velocity arrays until the end, and the
+        // force arrays hold the previous stage's dv/dt * m.
+        ctx.scratch.resize(8 * count);
+        double* x0 = ctx.scratch.data();
+        double* y0 = x0 + count;
+        double* kx = y0 + count;
+        double* ky = kx + count;
+        double* sumX = ky + count;
+        double* sumY = sumX + count;
+        double* sumVX = sumY + count;
+        double* sumVY = sumVX + count;
+
+        // k1: derivatives at t (forces were computed by the step)
+        for (size_t i = 0; i < count; ++i) {
+            x0[i] = x[i];
+            y0[i] = y[i];
+            kx[i] = vx[i];
+            ky[i] = vy[i];
+            sumX[i] = kx[i];
+            sumY[i] = ky[i];
+            sumVX[i] = fx[i] * inverseMass[i];
+            sumVY[i] = fy[i] * inverseMass[i];
+        }
 
-        // Calculate total force and acceleration
-        const glm::dvec2 totalForce = forceCalc.CalculateTotalForce(atom, allAtoms, atomIndex);
-        const glm::dvec2 acceleration = totalForce / atom.GetMassD();
+        // k2, k3 at t + dt/2 and k4 at t + dt, each from the previous stage
+        constexpr double stageFraction[3] = {0.5, 0.5, 1.0};
+        constexpr double stageWeight[3] = {2.0, 2.0, 1.0};
+
+        for (int stage = 0; stage < 3; ++stage) {
+            const double h = stageFraction[stage] * dt;
+            const double w = stageWeight[stage];
+
+            for (size_t i = 0; i < count; ++i) {
+                x[i] = x0[i] + kx[i] * h;
+                y[i] = y0[i] + ky[i] * h;
+                kx[i] = vx[i] + fx[i] * inverseMass[i] * h;
+                ky[i] = vy[i] + fy[i] * inverseMass[i] * h;
+                sumX[i] += w * kx[i];
+                sumY[i] += w * ky[i];
+            }
 
-        // Euler integration: v(t+dt) = v(t) + a(t)*dt, x(t+dt) = x(t) + v(t)*dt
-        glm::dvec2 newVelocity = atom.GetVelocityD() + acceleration * dt;
-        glm::dvec2 newPosition = atom.GetPositionD() + atom.GetVelocityD() * dt;
+            ctx.forceCalc.CalculateForces(atoms);
 
-        // Handle boundary collisions
-        HandleBoundaryCollision(newPosition, newVelocity, boundingBox);
+            for (size_t i = 0; i < count; ++i) {
+                sumVX[i] += w * fx[i] * inverseMass[i];
+                sumVY[i] += w * fy[i] * inverseMass[i];
+            }
+        }
 
-        // Update atom state
-        atom.SetVelocity(newVelocity);
-        atom.SetPosition(newPosition);
-    }
+        // Final RK4 update
+        for (size_t i = 0; i < count; ++i) {
+            const glm::dvec2 newVelocity(vx[i] + sumVX[i] * dt / 6.0, vy[i] + sumVY[i] * dt / 6.0);
+            const glm::dvec2 newPosition(x0[i] + sumX[i] * dt / 6.0, y0[i] + sumY[i] * dt / 6.0);
 
+            StoreWithWalls(atoms, i, newPosition, newVelocity, ctx.boundingBox);
+        }
+    }
 
-    void Integrator::RungeKutta4Step(Atom& atom, const size_t atomIndex, const double dt,
-                                    const std::vector<Atom>& allAtoms,
-                                    const BoundingBox& boundingBox,
-                                    ForceCalculator& forceCalc)
+    void LeapFrogPolicy::Advance(AtomStore& atoms, const double dt, const StepContext& ctx)
     {
-        // Store initial state
-        const glm::dvec2 initialPosition = atom.GetPositionD();
-        const glm::dvec2 initialVelocity = atom.GetVelocityD();
-
-        // Handle collisions first
-        HandleCollisions(atom, atomIndex, allAtoms, forceCalc);
-
-        // RK4 integration steps
-        // k1: derivatives at t
-        const glm::dvec2 k1v = ComputeAcceleration(atom, atomIndex, initialPosition, initialVelocity, allAtoms, forceCalc);
-        const glm::dvec2 k1x = initialVelocity;
-
-        // k2: derivatives at t + dt/2
-        const glm::dvec2 k2v = ComputeAcceleration(atom, atomIndex,
-                                                  initialPosition + k1x * dt * 0.5,
-                                                  initialVelocity + k1v * dt * 0.5,
-                                                  allAtoms, forceCalc);
-        const glm::dvec2 k2x = initialVelocity + k1v * dt * 0.5;
-
-        // k3: derivatives at t + dt/2 (using k2)
-        const glm::dvec2 k3v = ComputeAcceleration(atom, atomIndex,
-                                                  initialPosition + k2x * dt * 0.5,
-                                                  initialVelocity + k2v * dt * 0.5,
-                                                  allAtoms, forceCalc);
-        const glm::dvec2 k3x = initialVelocity + k2v * dt * 0.5;
-
-        // k4: derivatives at t + dt
-        const glm::dvec2 k4v = ComputeAcceleration(atom, atomIndex,
-                                                  initialPosition + k3x * dt,
-                                                  initialVelocity + k3v * dt,
-                                                  allAtoms, forceCalc);
-        const glm::dvec2 k4x = initialVelocity + k3v * dt;
-
-        // Final RK4 update
-        glm::dvec2 newVelocity = initialVelocity + (k1v + 2.0 * k2v + 2.0 * k3v + k4v) * dt / 6.0;
-        glm::dvec2 newPosition = initialPosition + (k1x + 2.0 * k2x + 2.0 * k3x + k4x) * dt / 6.0;
+        const double* x = atoms.GetX();
+        const double* y = atoms.GetY();
+        const double* vx = atoms.GetVX();
+        const double* vy = atoms.GetVY();
+        const double* fx = atoms.GetFX();
+        const double* fy = atoms.GetFY();
+        const double* inverseMass = atoms.GetInverseMasses();
 
-        // Handle boundary collisions
-        HandleBoundaryCollision(newPosition, newVelocity, boundingBox);
+        // Leap-frog integration
+        // v(t+dt/2) = v(t-dt/2) + a(t)*dt
+        // x(t+dt) = x(t) + v(t+dt/2)*dt
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            const glm::dvec2 newVelocity(vx[i] + fx[i] * inverseMass[i] * dt, vy[i] + fy[i] * inverseMass[i] * dt);
+            const glm::dvec2 newPosition(x[i] + newVelocity.x * dt, y[i] + newVelocity.y * dt);
 
-        // Update atom state
-        atom.SetVelocity(newVelocity);
-        atom.SetPosition(newPosition);
+            StoreWithWalls(atoms, i, newPosition, newVelocity, ctx.boundingBox);
+        }
     }
 
-    void Integrator::LeapFrogStep(Atom& atom, const size_t atomIndex, const double dt,
-                                 const std::vector<Atom>& allAtoms,
-                                 const BoundingBox& boundingBox,
-                                 const ForceCalculator& forceCalc)
+    void VelocityVerletPolicy::Advance(AtomStore& atoms, const double dt, const StepContext& ctx)
     {
-        // Handle collisions first
-        HandleCollisions(atom, atomIndex, allAtoms, forceCalc);
+        const size_t count = atoms.size();
+        const double* x = atoms.GetX();
+        const double* y = atoms.GetY();
+        double* vx = atoms.GetVX();
+        double* vy = atoms.GetVY();
+        const double* fx = atoms.GetFX();
+        const double* fy = atoms.GetFY();
+        const double* inverseMass = atoms.GetInverseMasses();
+
+        // v(t+dt/2) = v(t) + 0.5*a(t)*dt, x(t+dt) = x(t) + v(t+dt/2)*dt
+        for (size_t i = 0; i < count; ++i) {
+            const glm::dvec2 halfVelocity(vx[i] + 0.5 * fx[i] * inverseMass[i] * dt,
+                                          vy[i] + 0.5 * fy[i] * inverseMass[i] * dt);
+            const glm::dvec2 newPosition(x[i] + halfVelocity.x * dt, y[i] + halfVelocity.y * dt);
+
+            StoreWithWalls(atoms, i, newPosition, halfVelocity, ctx.boundingBox);
+        }
 
-        // Calculate current acceleration
-        const glm::dvec2 totalForce = forceCalc.CalculateTotalForce(atom, allAtoms, atomIndex);
-        const glm::dvec2 acceleration = totalForce / atom.GetMassD();
+        // v(t+dt) = v(t+dt/2) + 0.5*a(t+dt)*dt
+        ctx.forceCalc.CalculateForces(atoms);
+        for (size_t i = 0; i < count; ++i) {
+            vx[i] += 0.5 * fx[i] * inverseMass[i] * dt;
+            vy[i] += 0.5 * fy[i] * inverseMass[i] * dt;
+        }
+    }
 
-        // Leap-frog integration
-        // v(t+dt/2) = v(t-dt/2) + a(t)*dt
-        // x(t+dt) = x(t) + v(t+dt/2)*dt
+    void LangevinPolicy::Advance(AtomStore& atoms, const double dt, const StepContext& ctx)
+    {
+        const size_t count = atoms.size();
+        const double* x = atoms.GetX();
+        const double* y = atoms.GetY();
+        double* vx = atoms.GetVX();
+        double* vy = atoms.GetVY();
+        const double* fx = atoms.GetFX();
+        const double* fy = atoms.GetFY();
+        const double* inverseMass = atoms.GetInverseMasses();
+        const uint32_t* ids = atoms.GetIds();
+
+        // c1 is exact for any dt, so the friction part stays stable at large steps
+        const double c1 = std::exp(-ctx.thermostat.friction * dt);
+        const double noiseVariance = (1.0 - c1 * c1) * ctx.thermostat.targetTemperature;
+
+        for (size_t i = 0; i < count; ++i) {
+            // B: half kick
+            glm::dvec2 velocity(vx[i] + 0.5 * dt * fx[i] * inverseMass[i],
+                                vy[i] + 0.5 * dt * fy[i] * inverseMass[i]);
+
+            // A: half drift
+            glm::dvec2 position = glm::dvec2(x[i], y[i]) + 0.5 * dt * velocity;
+
+            // O: exact Ornstein-Uhlenbeck update, v = c1*v + sqrt((1 - c1^2) * kT/m) * xi
+            const double noiseScale = std::sqrt(noiseVariance * inverseMass[i]);
+            const auto xi = ctx.rng.Gaussian2(ids[i], ctx.stepIndex);
+            velocity = c1 * velocity + noiseScale * glm::dvec2(xi[0], xi[1]);
+
+            // A: half drift
+            position += 0.5 * dt * velocity;
+            StoreWithWalls(atoms, i, position, velocity, ctx.boundingBox);
+        }
+
+        // B: half kick with the force at the new positions
+        ctx.forceCalc.CalculateForces(atoms);
+        for (size_t i = 0; i < count; ++i) {
+            vx[i] += 0.5 * dt * fx[i] * inverseMass[i];
+            vy[i] += 0.5 * dt * fy[i] * inverseMass[i];
+        }
+    }
 
-        // For the first step, we need to calculate v(t-dt/2) from v(t)
-        // This is already handled in velocity initialization
+    void VerletPolicy::Advance(AtomStore& atoms, const double dt, const StepContext& ctx)
+    {
+        double* x = atoms.GetX();
+        double* y = atoms.GetY();
+        double* previousX = atoms.GetPreviousX();
+        double* previousY = atoms.GetPreviousY();
+        const double* fx = atoms.GetFX();
+        const double* fy = atoms.GetFY();
+        const double* inverseMass = atoms.GetInverseMasses();
 
-        glm::dvec2 newVelocity = atom.GetVelocityD() + acceleration * dt;
-        glm::dvec2 newPosition = atom.GetPositionD() + newVelocity * dt;
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            // Stormer-Verlet: x(t+dt) = 2*x(t) - x(t-dt) + a(t)*dt^2
+            const glm::dvec2 currentPosition(x[i], y[i]);
+            glm::dvec2 newPosition(2.0 * x[i] - previousX[i] + fx[i] * inverseMass[i] * dt * dt,
+                                   2.0 * y[i] - previousY[i] + fy[i] * inverseMass[i] * dt * dt);
+
+            // Reflect off the walls through the implicit velocity, then store x_prev so
+            // that (x_new - x_prev)/dt carries the reflected velocity into the next step
+            glm::dvec2 implicitVelocity = (newPosition - currentPosition) / dt;
+            Integrator::HandleBoundaryCollision(newPosition, implicitVelocity, ctx.boundingBox);
+
+            previousX[i] = newPosition.x - implicitVelocity.x * dt;
+            previousY[i] = newPosition.y - implicitVelocity.y * dt;
+            x[i] = newPosition.x;
+            y[i] = newPosition.y;
+        }
+    }
 
-        // Handle boundary collisions
-        HandleBoundaryCollision(newPosition, newVelocity, boundingBox);
+    Integrator::Integrator(const IntegrationMethod method)
+        : m_method(method), m_policy(MakePolicy(method)) {
+    }
 
-        // Update atom state
-        atom.SetVelocity(newVelocity);
-        atom.SetPosition(newPosition);
+    void Integrator::SetIntegrationMethod(const IntegrationMethod method)
+    {
+        m_method = method;
+        m_policy = MakePolicy(method);
     }
 
-    void Integrator::VelocityVerletStep(Atom& atom, const size_t atomIndex, const double dt,
-                                       const std::vector<Atom>& allAtoms,
-                                       const BoundingBox& boundingBox,
-                                       const ForceCalculator& forceCalc)
+    void Integrator::Step(AtomStore& atoms, const double dt,
+                          const BoundingBox& boundingBox,
+                          const ForceCalculator& forceCalc)
     {
-        // Handle collisions first
-        HandleCollisions(atom, atomIndex, allAtoms, forceCalc);
+        ++m_stepIndex;
 
-        // Calculate current acceleration
-        const glm::dvec2 currentForce = forceCalc.CalculateTotalForce(atom, allAtoms, atomIndex);
-        const glm::dvec2 currentAcceleration = currentForce / atom.GetMassD();
+        const StepContext ctx{boundingBox, forceCalc, m_thermostat, m_rng, m_stepIndex, m_scratch};
 
-        // Store current state
-        const glm::dvec2 currentPosition = atom.GetPositionD();
-        const glm::dvec2 currentVelocity = atom.GetVelocityD();
+        // The only dispatch of the step: pick the loop compiled for this policy
+        std::visit([&](auto policy) {
+            using Policy = decltype(policy);
+            if (m_useAdaptiveTimeStep) {
+                StepAll<Policy, true>(atoms, dt, ctx);
+            } else {
+                StepAll<Policy, false>(atoms, dt, ctx);
+            }
+        }, m_policy);
+    }
 
-        // Velocity-Verlet integration (first half)
-        // x(t+dt) = x(t) + v(t)*dt + 0.5*a(t)*dt^2
-        glm::dvec2 newPosition = currentPosition + currentVelocity * dt + 0.5 * currentAcceleration * dt * dt;
+    template<typename Policy, bool Adaptive>
+    void Integrator::StepAll(AtomStore& atoms, const double dt, const StepContext& ctx) const
+    {
+        if constexpr (Policy::PositionOnlyCollisions) {
+            ResolveOverlaps(atoms);
+        } else {
+            HandleCollisions(atoms, ctx.forceCalc);
+        }
 
-        // Handle boundary collisions for position
-        glm::dvec2 tempVelocity = currentVelocity;
-        HandleBoundaryCollision(newPosition, tempVelocity, boundingBox);
+        ctx.forceCalc.CalculateForces(atoms);
 
-        // Update position temporarily to calculate a new force
-        atom.SetPosition(newPosition);
+        double actualDt = dt;
+        if constexpr (Adaptive) {
+            actualDt = AdaptiveTimeStep(atoms, dt);
+        }
 
-        // Calculate new acceleration at the new position
-        const glm::dvec2 newForce = forceCalc.CalculateTotalForce(atom, allAtoms, atomIndex);
-        const glm::dvec2 newAcceleration = newForce / atom.GetMassD();
+        Policy::Advance(atoms, actualDt, ctx);
+    }
 
-        // Velocity-Verlet integration (second half)
-        // v(t+dt) = v(t) + 0.5*[a(t) + a(t+dt)]*dt
-        glm::dvec2 newVelocity = currentVelocity + 0.5 * (currentAcceleration + newAcceleration) * dt;
+    void Integrator::InitializeVerlet(AtomStore& atoms, const double dt,
+                                     const BoundingBox& boundingBox,
+                                     const ForceCalculator& forceCalc)
+    {
+        forceCalc.CalculateForces(atoms);
 
-        // Handle boundary collisions for velocity
-        HandleBoundaryCollision(newPosition, newVelocity, boundingBox);
+        const double* inverseMass = atoms.GetInverseMasses();
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            // Set previous position using: x(t-dt) = x(t) - v(t)*dt + 0.5*a(t)*dt^2
+            const glm::dvec2 initialAcceleration = atoms.GetForce(i) * inverseMass[i];
+            atoms.SetPreviousPosition(i, atoms.GetPosition(i) - atoms.GetVelocity(i) * dt +
+                                         0.5 * initialAcceleration * dt * dt);
+        }
+    }
 
-        // Update atom state
-        atom.SetVelocity(newVelocity);
-        atom.SetPosition(newPosition);
+    void Integrator::ReconstructVerletVelocities(AtomStore& atoms, const double dt)
+    {
+        if (dt <= 0.0) return;
+
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            atoms.SetVelocity(i, (atoms.GetPosition(i) - atoms.GetPreviousPosition(i)) / dt);
+        }
     }
 
-    double Integrator::AdaptiveTimeStep(const Atom& atom, const size_t atomIndex, const double dt,
-                                       const std::vector<Atom>& allAtoms,
-                                       const ForceCalculator& forceCalc) const
+    double Integrator::AdaptiveTimeStep(const AtomStore& atoms, const double dt) const
     {
-        // Calculate current acceleration
-        const glm::dvec2 currentAcceleration = ComputeAcceleration(atom, atomIndex,
-                                                                  atom.GetPositionD(),
-                                                                  atom.GetVelocityD(),
-                                                                  allAtoms, forceCalc);
+        // The largest acceleration in the system limits the step for everyone
+        double accelerationMagnitude = 0.0;
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            accelerationMagnitude = std::max(accelerationMagnitude,
+                                             glm::length(atoms.GetForce(i)) * atoms.GetInverseMasses()[i]);
+        }
 
         // Estimate error based on acceleration magnitude
-        const double accelerationMagnitude = glm::length(currentAcceleration);
-
         if (accelerationMagnitude < 1e-15) {
             return m_maxTimeStep;
         }
@@ -236,38 +360,6 @@ namespace Molecular
         return adaptiveDt;
     }
 
-    glm::dvec2 Integrator::ComputeAcceleration(const Atom& atom, const size_t atomIndex,
-                                              const glm::dvec2& position, const glm::dvec2& velocity,
-                                              const std::vector<Atom>& allAtoms,
-                                              const ForceCalculator& forceCalc)
-    {
-        // Create a temporary atom with the given position and velocity for force calculation
-        Atom tempAtom = atom;
-        tempAtom.SetPosition(position);
-        tempAtom.SetVelocity(velocity);
-
-        // Calculate forces at this state
-        const glm::dvec2 totalForce = forceCalc.CalculateTotalForce(tempAtom, allAtoms, atomIndex);
-
-        // Return acceleration (F = ma, so a = F/m)
-        return totalForce / atom.GetMassD();
-    }
-
-    void Integrator::HandleCollisions(Atom& atom, const size_t atomIndex,
-                                     const std::vector<Atom>& allAtoms,
-                                     const ForceCalculator& forceCalc)
-    {
-        // Handle collisions with other atoms
-        for (size_t j = 0; j < allAtoms.size(); ++j) {
-            if (atomIndex != j) {
-                // Note: We need to cast away const to handle collisions
-                // This is a design limitation that could be improved
-                auto& otherAtom = const_cast<Atom&>(allAtoms[j]);
-                forceCalc.HandleCollision(atom, otherAtom);
-            }
-        }
-    }
-
     void Integrator::HandleBoundaryCollision(glm::dvec2& position, glm::dvec2& velocity,
                                             const BoundingBox& boundingBox, const double restitution)
     {
@@ -1,39 +1,38 @@
 #pragma once
 
-#include "Atom.h"
+#include "AtomStore.h"
 #include "BoundingBox.h"
 #include "ForceCalculator.h"
+#include "IntegrationPolicies.h"
 
 namespace Molecular
 {
-    enum class IntegrationMethod {
-        Euler,
-        RungeKutta4,
-        LeapFrog,
-        VelocityVerlet
-    };
-
     class Integrator
     {
     public:
         explicit Integrator(IntegrationMethod method = IntegrationMethod::VelocityVerlet);
 
-        void Integrate(Atom& atom, size_t atomIndex, double dt,
-                              const std::vector<Atom>& allAtoms,
-                              const BoundingBox& boundingBox,
-                              ForceCalculator& forceCalc) const;
+        // Advances every atom by one step. The policy is dispatched once here; the
+        // array loops underneath are compiled separately for each method.
+        void Step(AtomStore& atoms, double dt,
+                  const BoundingBox& boundingBox,
+                  const ForceCalculator& forceCalc);
 
-        static void InitializeVerlet(std::vector<Atom>& atoms, double dt,
+        static void InitializeVerlet(AtomStore& atoms, double dt,
                                      const BoundingBox& boundingBox,
                                      const ForceCalculator& forceCalc);
 
+        // Position Verlet carries no velocity; rebuild v = (x - x_prev)/dt (backward
+        // difference, i.e. v at t - dt/2) when observables need it
+        static void ReconstructVerletVelocities(AtomStore& atoms, double dt);
+
         static void HandleBoundaryCollision(glm::dvec2& position, glm::dvec2& velocity,
                                                   const BoundingBox& boundingBox, double restitution = 0.9);
 
-        void SetIntegrationMethod(IntegrationMethod method) { m_method = method; }
+        void SetIntegrationMethod(IntegrationMethod method);
         [[nodiscard]] IntegrationMethod GetIntegrationMethod() const { return m_method; }
 
-        // Adaptive time stepping
+        // Adaptive time stepping: one dt per step, chosen from the largest acceleration
         void SetAdaptiveTimeStep(bool adaptive) { m_useAdaptiveTimeStep = adaptive; }
         void SetMaxTimeStep(double maxDt) { m_maxTimeStep = maxDt; }
         void SetMinTimeStep(double minDt) { m_minTimeStep = minDt; }
@@ -44,54 +43,40 @@ namespace Molecular
         [[nodiscard]] double GetMinTimeStep() const { return m_minTimeStep; }
         [[nodiscard]] double GetErrorTolerance() const { return m_errorTolerance; }
 
+        // Langevin thermostat (BAOAB)
+        void SetTargetTemperature(double kT) { m_thermostat.targetTemperature = kT; }
+        void SetFriction(double gamma) { m_thermostat.friction = gamma; }
+        void SetRandomSeed(uint64_t seed) { m_rng.SetSeed(seed); }
+
+        [[nodiscard]] double GetTargetTemperature() const { return m_thermostat.targetTemperature; }
+        [[nodiscard]] double GetFriction() const { return m_thermostat.friction; }
+        [[nodiscard]] uint64_t GetRandomSeed() const { return m_rng.GetSeed(); }
+
+        // The step index is the counter of the per-atom random streams
+        void ResetStepCounter() { m_stepIndex = 0; }
+        void SetStepIndex(const uint64_t stepIndex) { m_stepIndex = stepIndex; }
+        [[nodiscard]] uint64_t GetStepIndex() const { return m_stepIndex; }
+
     private:
-        // Integration methods
-        static void EulerStep(Atom& atom, size_t atomIndex, double dt,
-                             const std::vector<Atom>& allAtoms,
-                             const BoundingBox& boundingBox,
-                             const ForceCalculator& forceCalc);
-
-        static void RungeKutta4Step(Atom& atom, size_t atomIndex, double dt,
-                                   const std::vector<Atom>& allAtoms,
-                                   const BoundingBox& boundingBox,
-                                   ForceCalculator& forceCalc);
-
-        static void VerletStep(Atom& atom, size_t atomIndex, double dt,
-                              const std::vector<Atom>& allAtoms,
-                              const BoundingBox& boundingBox,
-                              const ForceCalculator& forceCalc);
-
-        static void LeapFrogStep(Atom& atom, size_t atomIndex, double dt,
-                                const std::vector<Atom>& allAtoms,
-                                const BoundingBox& boundingBox,
-                                const ForceCalculator& forceCalc);
-
-        static void VelocityVerletStep(Atom& atom, size_t atomIndex, double dt,
-                                      const std::vector<Atom>& allAtoms,
-                                      const BoundingBox& boundingBox,
-                                      const ForceCalculator& forceCalc);
-
-        // Adaptive time stepping
-        [[nodiscard]] double AdaptiveTimeStep(const Atom& atom, size_t atomIndex, double dt,
-                               const std::vector<Atom>& allAtoms,
-                               const ForceCalculator& forceCalc) const;
-
-        // Helper methods
-        static glm::dvec2 ComputeAcceleration(const Atom& atom, size_t atomIndex,
-                                             const glm::dvec2& position,
-                                             const glm::dvec2& velocity,
-                                             const std::vector<Atom>& allAtoms,
-                                             const ForceCalculator& forceCalc);
-
-        static void HandleCollisions(Atom& atom, size_t atomIndex,
-                                    const std::vector<Atom>& allAtoms,
-                                    const ForceCalculator& forceCalc);
+        template<typename Policy, bool Adaptive>
+        void StepAll(AtomStore& atoms, double dt, const StepContext& ctx) const;
+
+        // Adaptive time stepping, from the forces already in the store
+        [[nodiscard]] double AdaptiveTimeStep(const AtomStore& atoms, double dt) const;
 
         // Member variables
         IntegrationMethod m_method;
+        IntegrationPolicy m_policy;
         bool m_useAdaptiveTimeStep = false;
         double m_maxTimeStep = 1e-12;
         double m_minTimeStep = 1e-16;
         double m_errorTolerance = 1e-10;
+
+        // Langevin thermostat
+        ThermostatSettings m_thermostat;
+        CounterRng m_rng{0x4D6F6C6563756C61ull};
+        uint64_t m_stepIndex = 0;
+
+        std::vector<double> m_scratch;
     };
 }
@@ -0,0 +1,124 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Molecular
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string& path)
+    {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Could not open '" + path + "'");
+        }
+        m_file = file;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            Unmap();
+            throw std::runtime_error("Could not read the size of '" + path + "'");
+        }
+        if (size.QuadPart == 0) {
+            Unmap();
+            throw std::runtime_error("'" + path + "' is empty");
+        }
+        m_size = static_cast<size_t>(size.QuadPart);
+
+        m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping == nullptr) {
+            Unmap();
+            throw std::runtime_error("Could not map '" + path + "'");
+        }
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (m_data == nullptr) {
+            Unmap();
+            throw std::runtime_error("Could not map '" + path + "'");
+        }
+    }
+
+    void MappedFile::Unmap()
+    {
+        if (m_data != nullptr) UnmapViewOfFile(m_data);
+        if (m_mapping != nullptr) CloseHandle(m_mapping);
+        if (m_file != nullptr) CloseHandle(m_file);
+        m_data = nullptr;
+        m_mapping = nullptr;
+        m_file = nullptr;
+        m_size = 0;
+    }
+#else
+    MappedFile::MappedFile(const std::string& path)
+    {
+        const int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            throw std::runtime_error("Could not open '" + path + "'");
+        }
+
+        struct stat status{};
+        if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+            close(descriptor);
+            throw std::runtime_error("Could not map '" + path + "' (unreadable or empty)");
+        }
+        m_size = static_cast<size_t>(status.st_size);
+
+        // The mapping keeps the file alive; the descriptor is no longer needed
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        close(descriptor);
+        if (data == MAP_FAILED) {
+            m_size = 0;
+            throw std::runtime_error("Could not map '" + path + "'");
+        }
+        m_data = static_cast<const uint8_t*>(data);
+    }
+
+    void MappedFile::Unmap()
+    {
+        if (m_data != nullptr) {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+        m_data = nullptr;
+        m_size = 0;
+    }
+#endif
+
+    MappedFile::~MappedFile()
+    {
+        Unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other) {
+            Unmap();
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+#ifdef _WIN32
+            std::swap(m_file, other.m_file);
+            std::swap(m_mapping, other.m_mapping);
+#endif
+        }
+        return *this;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Molecular
+{
+    // Read-only memory mapping of a whole file. Pages are loaded by the OS on
+    // first touch, so opening a large file costs nothing up front and resident
+    // memory follows what is actually read.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        // Throws std::runtime_error if the file cannot be opened or mapped
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] const uint8_t* data() const { return m_data; }
+        [[nodiscard]] size_t size() const { return m_size; }
+        [[nodiscard]] bool IsOpen() const { return m_data != nullptr; }
+
+    private:
+        void Unmap();
+
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void* m_file = nullptr;         // HANDLEs
+        void* m_mapping = nullptr;
+#endif
+    };
+}
@@ -0,0 +1,213 @@
+#include "Minimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Molecular
+{
+    namespace
+    {
+        double Dot(const std::vector<glm::dvec2>& a, const std::vector<glm::dvec2>& b)
+        {
+            double sum = 0.0;
+            for (size_t i = 0; i < a.size(); ++i) {
+                sum += glm::dot(a[i], b[i]);
+            }
+            return sum;
+        }
+
+        // Runs a force pass and copies the result out of the store's force arrays
+        double CalculateForces(AtomStore& atoms, const ForceCalculator& forceCalc, std::vector<glm::dvec2>& forces)
+        {
+            const double maxForce = forceCalc.CalculateForces(atoms);
+
+            forces.resize(atoms.size());
+            for (size_t i = 0; i < atoms.size(); ++i) {
+                forces[i] = atoms.GetForce(i);
+            }
+            return maxForce;
+        }
+
+        double MaxLength(const std::vector<glm::dvec2>& v)
+        {
+            double maxLength = 0.0;
+            for (const auto& x : v) {
+                maxLength = std::max(maxLength, glm::length(x));
+            }
+            return maxLength;
+        }
+    }
+
+    Minimizer::Minimizer(const MinimizerSettings& settings)
+        : m_settings(settings) {
+    }
+
+    MinimizerResult Minimizer::Minimize(AtomStore& atoms,
+                                        const BoundingBox& boundingBox,
+                                        const ForceCalculator& forceCalc) const
+    {
+        if (atoms.empty()) {
+            MinimizerResult result;
+            result.converged = true;
+            return result;
+        }
+
+        switch (m_settings.method) {
+        case MinimizerMethod::ConjugateGradient:
+            return MinimizeConjugateGradient(atoms, boundingBox, forceCalc);
+        default:
+            return MinimizeFIRE(atoms, boundingBox, forceCalc);
+        }
+    }
+
+    MinimizerResult Minimizer::MinimizeFIRE(AtomStore& atoms,
+                                            const BoundingBox& boundingBox,
+                                            const ForceCalculator& forceCalc) const
+    {
+        // Standard FIRE parameters (Bitzek et al., PRL 97, 170201)
+        constexpr int minStepsBeforeSpeedup = 5;
+        constexpr double timeStepIncrease = 1.1;
+        constexpr double timeStepDecrease = 0.5;
+        constexpr double alphaStart = 0.1;
+        constexpr double alphaDecrease = 0.99;
+
+        MinimizerResult result;
+        std::vector<glm::dvec2> forces;
+        std::vector<glm::dvec2> velocities(atoms.size(), glm::dvec2(0.0));
+
+        result.maxForce = CalculateForces(atoms, forceCalc, forces);
+        result.forceEvaluations = 1;
+
+        double dt = m_settings.initialTimeStep;
+        double alpha = alphaStart;
+        int stepsSinceUphill = 0;
+
+        while (result.maxForce > m_settings.forceTolerance && result.iterations < m_settings.maxIterations) {
+            ++result.iterations;
+
+            // Power P = F.v decides whether we are still going downhill
+            if (Dot(forces, velocities) > 0.0) {
+                // Steer the velocity towards the force direction
+                const double velocityNorm = std::sqrt(Dot(velocities, velocities));
+                const double forceNorm = std::sqrt(Dot(forces, forces));
+                for (size_t i = 0; i < atoms.size(); ++i) {
+                    velocities[i] = (1.0 - alpha) * velocities[i] + alpha * velocityNorm * forces[i] / forceNorm;
+                }
+
+                if (++stepsSinceUphill > minStepsBeforeSpeedup) {
+                    dt = std::min(dt * timeStepIncrease, m_settings.maxTimeStep);
+                    alpha *= alphaDecrease;
+                }
+            } else {
+                // Overshot: freeze and restart cautiously
+                stepsSinceUphill = 0;
+                dt *= timeStepDecrease;
+                alpha = alphaStart;
+                std::fill(velocities.begin(), velocities.end(), glm::dvec2(0.0));
+            }
+
+            // Semi-implicit Euler MD step, with the largest displacement capped
+            for (size_t i = 0; i < atoms.size(); ++i) {
+                velocities[i] += forces[i] * atoms.GetInverseMasses()[i] * dt;
+            }
+
+            const double maxStep = MaxLength(velocities) * dt;
+            const double scale = maxStep > m_settings.maxDisplacement ? m_settings.maxDisplacement / maxStep : 1.0;
+            Displace(atoms, velocities, dt * scale, boundingBox);
+
+            // Atoms pinned against a wall lose the velocity component into it
+            for (size_t i = 0; i < atoms.size(); ++i) {
+                const glm::dvec2 position = atoms.GetPosition(i);
+                for (int axis = 0; axis < 2; ++axis) {
+                    if (position[axis] <= boundingBox.GetMinPoint()[axis] ||
+                        position[axis] >= boundingBox.GetMaxPoint()[axis]) {
+                        velocities[i][axis] = 0.0;
+                    }
+                }
+            }
+
+            result.maxForce = CalculateForces(atoms, forceCalc, forces);
+            ++result.forceEvaluations;
+        }
+
+        result.converged = result.maxForce <= m_settings.forceTolerance;
+        return result;
+    }
+
+    MinimizerResult Minimizer::MinimizeConjugateGradient(AtomStore& atoms,
+                                                         const BoundingBox& boundingBox,
+                                                         const ForceCalculator& forceCalc) const
+    {
+        MinimizerResult result;
+        std::vector<glm::dvec2> forces;
+        std::vector<glm::dvec2> trialForces;
+        std::vector<glm::dvec2> startPositions(atoms.size());
+
+        result.maxForce = CalculateForces(atoms, forceCalc, forces);
+        result.forceEvaluations = 1;
+
+        // Search direction starts along steepest descent (the force is -grad E)
+        std::vector<glm::dvec2> direction = forces;
+
+        while (result.maxForce > m_settings.forceTolerance && result.iterations < m_settings.maxIterations) {
+            ++result.iterations;
+
+            double slope = Dot(forces, direction);
+            if (slope <= 0.0) {
+                direction = forces;
+                slope = Dot(forces, forces);
+            }
+
+            // Trial step: move the atom with the largest direction component by maxDisplacement
+            const double trialStep = m_settings.maxDisplacement / MaxLength(direction);
+
+            for (size_t i = 0; i < atoms.size(); ++i) {
+                startPositions[i] = atoms.GetPosition(i);
+            }
+            Displace(atoms, direction, trialStep, boundingBox);
+
+            result.maxForce = CalculateForces(atoms, forceCalc, trialForces);
+            ++result.forceEvaluations;
+
+            // Line search on the directional derivative F.d, which is what the
+            // force pass gives us directly. If it changed sign we stepped past the
+            // minimum along d, so interpolate back to the zero crossing (secant).
+            if (const double trialSlope = Dot(trialForces, direction); trialSlope < 0.0) {
+                const double step = trialStep * slope / (slope - trialSlope);
+
+                for (size_t i = 0; i < atoms.size(); ++i) {
+                    atoms.SetPosition(i, startPositions[i]);
+                }
+                Displace(atoms, direction, step, boundingBox);
+
+                result.maxForce = CalculateForces(atoms, forceCalc, trialForces);
+                ++result.forceEvaluations;
+            }
+
+            // Polak-Ribiere update, clamped at zero (automatic restart)
+            const double beta = std::max(0.0, (Dot(trialForces, trialForces) - Dot(trialForces, forces)) / Dot(forces, forces));
+            for (size_t i = 0; i < atoms.size(); ++i) {
+                direction[i] = trialForces[i] + beta * direction[i];
+            }
+
+            std::swap(forces, trialForces);
+        }
+
+        result.converged = result.maxForce <= m_settings.forceTolerance;
+        return result;
+    }
+
+    void Minimizer::Displace(AtomStore& atoms, const std::vector<glm::dvec2>& direction,
+                             const double step, const BoundingBox& boundingBox)
+    {
+        const glm::dvec2 minPoint = boundingBox.GetMinPoint();
+        const glm::dvec2 maxPoint = boundingBox.GetMaxPoint();
+
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            glm::dvec2 position = atoms.GetPosition(i) + step * direction[i];
+            position.x = std::clamp(position.x, minPoint.x, maxPoint.x);
+            position.y = std::clamp(position.y, minPoint.y, maxPoint.y);
+            atoms.SetPosition(i, position);
+        }
+    }
+}
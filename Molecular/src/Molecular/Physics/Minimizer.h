@@ -0,0 +1,61 @@
+#pragma once
+
+#include "AtomStore.h"
+#include "BoundingBox.h"
+#include "ForceCalculator.h"
+
+namespace Molecular
+{
+    enum class MinimizerMethod {
+        FIRE,
+        ConjugateGradient
+    };
+
+    struct MinimizerSettings {
+        MinimizerMethod method = MinimizerMethod::FIRE;
+        double forceTolerance = 1e-2;   // Converged once max |F_i| drops below this
+        int maxIterations = 10000;
+        double maxDisplacement = 0.01;  // Largest move of any atom per iteration (nm)
+
+        // FIRE time step bounds (Bitzek et al. 2006)
+        double initialTimeStep = 1e-3;
+        double maxTimeStep = 1e-2;
+    };
+
+    struct MinimizerResult {
+        int iterations = 0;
+        int forceEvaluations = 0;
+        double maxForce = 0.0;
+        bool converged = false;
+    };
+
+    // Relaxes atom positions to a local minimum of the force field before dynamics
+    // starts. Velocities are not touched; positions are kept inside the bounding box.
+    class Minimizer
+    {
+    public:
+        explicit Minimizer(const MinimizerSettings& settings = {});
+
+        MinimizerResult Minimize(AtomStore& atoms,
+                                 const BoundingBox& boundingBox,
+                                 const ForceCalculator& forceCalc) const;
+
+        void SetSettings(const MinimizerSettings& settings) { m_settings = settings; }
+        [[nodiscard]] const MinimizerSettings& GetSettings() const { return m_settings; }
+
+    private:
+        [[nodiscard]] MinimizerResult MinimizeFIRE(AtomStore& atoms,
+                                                   const BoundingBox& boundingBox,
+                                                   const ForceCalculator& forceCalc) const;
+
+        [[nodiscard]] MinimizerResult MinimizeConjugateGradient(AtomStore& atoms,
+                                                                const BoundingBox& boundingBox,
+                                                                const ForceCalculator& forceCalc) const;
+
+        // Moves every atom by step * direction[i], clamped to the box
+        static void Displace(AtomStore& atoms, const std::vector<glm::dvec2>& direction,
+                             double step, const BoundingBox& boundingBox);
+
+        MinimizerSettings m_settings;
+    };
+}
@@ -0,0 +1,174 @@
+#include "MoleculeTracker.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace Molecular
+{
+    std::string FormatSpecies(const SpeciesKey species)
+    {
+        // Hill order over the element table: carbon, hydrogen, then by symbol
+        std::array<ElementId, ElementCount> order{};
+        for (size_t e = 0; e < ElementCount; ++e) {
+            order[e] = static_cast<ElementId>(e);
+        }
+        std::sort(order.begin(), order.end(), [](const ElementId a, const ElementId b) {
+            auto rank = [](const ElementId element) {
+                return element == ElementId::C ? 0 : element == ElementId::H ? 1 : 2;
+            };
+            if (rank(a) != rank(b)) return rank(a) < rank(b);
+            return GetElementSymbol(a) < GetElementSymbol(b);
+        });
+
+        std::string formula;
+        for (const ElementId element : order) {
+            const uint32_t count = CountInSpecies(species, element);
+            if (count == 0) continue;
+            formula += GetElementSymbol(element);
+            if (count > 1) formula += std::to_string(count);
+        }
+        return formula;
+    }
+
+    void MoleculeTracker::Rebuild(const AtomStore& atoms)
+    {
+        const size_t count = atoms.size();
+        m_parent.resize(count);
+        std::iota(m_parent.begin(), m_parent.end(), 0u);
+        m_size.assign(count, 1);
+        m_species.resize(count);
+        m_speciesCounts.clear();
+        m_moleculeCount = count;
+
+        for (size_t i = 0; i < count; ++i) {
+            m_species[i] = SpeciesOf(atoms.GetElementId(i));
+            AddSpecies(m_species[i], 1);
+        }
+        m_bondCount = 0;
+        for (const BondEdge& edge : atoms.GetBondEdges()) {
+            OnBondFormed(edge.first, edge.second);
+        }
+
+        m_visitMark.assign(count, 0);
+        m_visitStamp = 0;
+        m_valid = true;
+    }
+
+    void MoleculeTracker::OnBondFormed(const size_t i, const size_t j)
+    {
+        ++m_bondCount;
+
+        uint32_t rootI = Find(static_cast<uint32_t>(i));
+        uint32_t rootJ = Find(static_cast<uint32_t>(j));
+        if (rootI == rootJ) return;     // Closes a ring
+
+        if (m_size[rootI] < m_size[rootJ]) std::swap(rootI, rootJ);
+
+        AddSpecies(m_species[rootI], -1);
+        AddSpecies(m_species[rootJ], -1);
+        m_parent[rootJ] = rootI;
+        m_size[rootI] += m_size[rootJ];
+        m_species[rootI] += m_species[rootJ];
+        AddSpecies(m_species[rootI], 1);
+        --m_moleculeCount;
+    }
+
+    void MoleculeTracker::OnBondBroken(const AtomStore& atoms, const size_t i, const size_t j)
+    {
+        --m_bondCount;
+        const uint32_t oldRoot = Find(static_cast<uint32_t>(i));
+
+        // Still connected through another path (a ring): same molecule
+        if (WalkMolecule(atoms, static_cast<uint32_t>(i), static_cast<uint32_t>(j))) return;
+
+        AddSpecies(m_species[oldRoot], -1);
+
+        SpeciesKey speciesI = 0;
+        for (const uint32_t k : m_component) speciesI += SpeciesOf(atoms.GetElementId(k));
+        Relabel(static_cast<uint32_t>(i), speciesI);
+
+        WalkMolecule(atoms, static_cast<uint32_t>(j), static_cast<uint32_t>(j));
+        SpeciesKey speciesJ = 0;
+        for (const uint32_t k : m_component) speciesJ += SpeciesOf(atoms.GetElementId(k));
+        Relabel(static_cast<uint32_t>(j), speciesJ);
+
+        ++m_moleculeCount;
+    }
+
+    uint32_t MoleculeTracker::GetMoleculeId(const size_t i)
+    {
+        return Find(static_cast<uint32_t>(i));
+    }
+
+    std::vector<MoleculeInfo> MoleculeTracker::CollectMolecules(const AtomStore& atoms)
+    {
+        std::vector<MoleculeInfo> molecules;
+        std::vector<uint32_t> slotOfRoot(atoms.size(), AtomHandle::InvalidSlot);
+
+        const double* mass = atoms.GetMasses();
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            const uint32_t root = Find(static_cast<uint32_t>(i));
+            if (slotOfRoot[root] == AtomHandle::InvalidSlot) {
+                slotOfRoot[root] = static_cast<uint32_t>(molecules.size());
+                molecules.push_back({root, m_species[root], 0, 0.0, glm::dvec2(0.0)});
+            }
+            MoleculeInfo& molecule = molecules[slotOfRoot[root]];
+            ++molecule.atomCount;
+            molecule.mass += mass[i];
+            molecule.centreOfMass += mass[i] * atoms.GetPosition(i);
+        }
+        for (auto& molecule : molecules) {
+            molecule.centreOfMass /= molecule.mass;
+        }
+        return molecules;
+    }
+
+    uint32_t MoleculeTracker::Find(uint32_t i)
+    {
+        // Path halving
+        while (m_parent[i] != i) {
+            m_parent[i] = m_parent[m_parent[i]];
+            i = m_parent[i];
+        }
+        return i;
+    }
+
+    void MoleculeTracker::AddSpecies(const SpeciesKey species, const int delta)
+    {
+        const int count = m_speciesCounts[species] += delta;
+        if (count == 0) m_speciesCounts.erase(species);
+    }
+
+    bool MoleculeTracker::WalkMolecule(const AtomStore& atoms, const uint32_t start, const uint32_t target)
+    {
+        if (++m_visitStamp == 0) {
+            std::fill(m_visitMark.begin(), m_visitMark.end(), 0);
+            m_visitStamp = 1;
+        }
+
+        m_component.clear();
+        m_component.push_back(start);
+        m_visitMark[start] = m_visitStamp;
+        for (size_t k = 0; k < m_component.size(); ++k) {
+            for (const uint32_t next : atoms.GetBonds(m_component[k])) {
+                if (next == target && target != start) return true;
+                if (m_visitMark[next] != m_visitStamp) {
+                    m_visitMark[next] = m_visitStamp;
+                    m_component.push_back(next);
+                }
+            }
+        }
+        return false;
+    }
+
+    void MoleculeTracker::Relabel(const uint32_t root, const SpeciesKey species)
+    {
+        for (const uint32_t k : m_component) {
+            m_parent[k] = root;
+        }
+        m_size[root] = static_cast<uint32_t>(m_component.size());
+        m_species[root] = species;
+        AddSpecies(species, 1);
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "AtomStore.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Molecular
+{
+    // Composition of a molecule packed as 16-bit atom counts per element, so
+    // merging two molecules is one addition and a species is a hashable integer
+    using SpeciesKey = uint64_t;
+    static_assert(ElementCount * 16 <= 64, "SpeciesKey packs 16 bits per element");
+
+    constexpr SpeciesKey SpeciesOf(const ElementId element)
+    {
+        return SpeciesKey{1} << (16 * static_cast<unsigned>(element));
+    }
+
+    constexpr uint32_t CountInSpecies(const SpeciesKey species, const ElementId element)
+    {
+        return static_cast<uint32_t>((species >> (16 * static_cast<unsigned>(element))) & 0xFFFF);
+    }
+
+    // Hill notation: C, then H, then the rest alphabetically ("CH4", "H2O", "O3")
+    [[nodiscard]] std::string FormatSpecies(SpeciesKey species);
+
+    struct MoleculeInfo
+    {
+        uint32_t id;            // Representative atom index, as GetMoleculeId returns
+        SpeciesKey species;
+        size_t atomCount;
+        double mass;
+        glm::dvec2 centreOfMass;
+    };
+
+    // Connected components of the bond graph ("molecules"; a free atom is its own).
+    //
+    // Union-find over atom indices: a formed bond is one union, a broken bond
+    // re-walks only the molecule it belonged to. Per-species molecule counts are
+    // kept up to date, so reading them is a hash lookup. Indices change when
+    // atoms are added, removed or reordered; Invalidate and Rebuild then.
+    class MoleculeTracker
+    {
+    public:
+        void Rebuild(const AtomStore& atoms);
+        void Invalidate() { m_valid = false; }
+        // False after Invalidate, or once the atom or bond count no longer matches the store
+        [[nodiscard]] bool IsValid(const AtomStore& atoms) const
+        {
+            return m_valid && m_parent.size() == atoms.size() && m_bondCount == atoms.GetTotalBondCount();
+        }
+
+        void OnBondFormed(size_t i, size_t j);
+        // Call after the bond has been removed from the store
+        void OnBondBroken(const AtomStore& atoms, size_t i, size_t j);
+
+        // Same value for every atom of one molecule
+        [[nodiscard]] uint32_t GetMoleculeId(size_t i);
+        [[nodiscard]] size_t GetMoleculeCount() const { return m_moleculeCount; }
+        [[nodiscard]] int GetSpeciesCount(const SpeciesKey species) const
+        {
+            const auto it = m_speciesCounts.find(species);
+            return it != m_speciesCounts.end() ? it->second : 0;
+        }
+        [[nodiscard]] const std::unordered_map<SpeciesKey, int>& GetSpeciesCounts() const { return m_speciesCounts; }
+
+        // One entry per molecule with its composition, mass and centre of mass. O(N)
+        [[nodiscard]] std::vector<MoleculeInfo> CollectMolecules(const AtomStore& atoms);
+
+    private:
+        uint32_t Find(uint32_t i);
+        void AddSpecies(SpeciesKey species, int delta);
+        // Collects the molecule containing start into m_component; returns true if it reaches target
+        bool WalkMolecule(const AtomStore& atoms, uint32_t start, uint32_t target);
+        void Relabel(uint32_t root, SpeciesKey species);
+
+        bool m_valid = false;
+        std::vector<uint32_t> m_parent;
+        std::vector<uint32_t> m_size;           // Valid at roots
+        std::vector<SpeciesKey> m_species;      // Valid at roots
+        size_t m_moleculeCount = 0;
+        size_t m_bondCount = 0;
+        std::unordered_map<SpeciesKey, int> m_speciesCounts;
+
+        // Scratch for the walk on bond breaking
+        std::vector<uint32_t> m_component;
+        std::vector<uint32_t> m_visitMark;
+        uint32_t m_visitStamp = 0;
+    };
+}
@@ -0,0 +1,255 @@
+#include "Observables.h"
+
+#include "ForceCalculator.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace Molecular
+{
+    void RunningStats::Add(const double value)
+    {
+        ++m_count;
+        const double delta = value - m_mean;
+        m_mean += delta / static_cast<double>(m_count);
+        m_m2 += delta * (value - m_mean);
+    }
+
+    double RunningStats::GetStandardDeviation() const
+    {
+        return std::sqrt(GetVariance());
+    }
+
+    ObservablePipeline::ObservablePipeline(const size_t historyCapacity)
+        : m_historyCapacity(historyCapacity)
+    {
+    }
+
+    ObservablePipeline::~ObservablePipeline()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        if (m_worker.joinable()) {
+            m_worker.join();
+        }
+    }
+
+    size_t ObservablePipeline::Register(std::string name, const int interval, ObservableFunction compute)
+    {
+        if (interval < 0) {
+            throw std::invalid_argument("Observable interval must not be negative");
+        }
+        if (!compute) {
+            throw std::invalid_argument("Observable '" + name + "' has no compute function");
+        }
+
+        // The worker reads m_observables; only grow it while the worker is idle
+        Flush();
+        m_observables.push_back({std::move(name), interval, std::move(compute), TimeSeries(m_historyCapacity, 1), {}});
+        return m_observables.size() - 1;
+    }
+
+    void ObservablePipeline::SetInterval(const size_t observable, const int interval)
+    {
+        if (interval < 0) {
+            throw std::invalid_argument("Observable interval must not be negative");
+        }
+        m_observables[observable].interval = interval;
+    }
+
+    std::optional<size_t> ObservablePipeline::Find(const std::string& name) const
+    {
+        for (size_t k = 0; k < m_observables.size(); ++k) {
+            if (m_observables[k].name == name) return k;
+        }
+        return std::nullopt;
+    }
+
+    bool ObservablePipeline::IsDue(const uint64_t sampleIndex) const
+    {
+        for (const Observable& observable : m_observables) {
+            if (observable.interval > 0 && sampleIndex % static_cast<uint64_t>(observable.interval) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::unique_ptr<ObservableState> ObservablePipeline::AcquireState()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_freeStates.empty()) {
+                std::unique_ptr<ObservableState> state = std::move(m_freeStates.back());
+                m_freeStates.pop_back();
+                return state;
+            }
+        }
+        return std::make_unique<ObservableState>();
+    }
+
+    void ObservablePipeline::Submit(std::unique_ptr<ObservableState> state)
+    {
+        // Which observables to evaluate is decided here, against the current intervals
+        Job job{std::move(state), {}};
+        for (size_t k = 0; k < m_observables.size(); ++k) {
+            const int interval = m_observables[k].interval;
+            if (interval > 0 && job.state->sampleIndex % static_cast<uint64_t>(interval) == 0) {
+                job.due.push_back(k);
+            }
+        }
+        if (job.due.empty()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_freeStates.push_back(std::move(job.state));
+            return;
+        }
+
+        if (!m_worker.joinable()) {
+            m_worker = std::thread([this] { WorkerLoop(); });
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock, [this] { return m_jobs.size() < m_maxPendingJobs; });
+            m_jobs.push_back(std::move(job));
+        }
+        m_wake.notify_one();
+    }
+
+    void ObservablePipeline::Collect()
+    {
+        std::vector<Result> results;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_error) {
+                std::exception_ptr error = m_error;
+                m_error = nullptr;
+                std::rethrow_exception(error);
+            }
+            results.swap(m_results);
+        }
+
+        for (const Result& result : results) {
+            Observable& observable = m_observables[result.observable];
+            const float value = static_cast<float>(result.value);
+            observable.series.Append(result.time, &value);
+            observable.statistics.Add(result.value);
+        }
+    }
+
+    void ObservablePipeline::Flush()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock, [this] { return m_jobs.empty() && !m_busy; });
+        }
+        Collect();
+    }
+
+    void ObservablePipeline::Clear()
+    {
+        Flush();
+        for (Observable& observable : m_observables) {
+            observable.series.Clear();
+            observable.statistics.Reset();
+        }
+    }
+
+    void ObservablePipeline::Restore(const size_t observable, const SeriesView<double> times,
+                                     const SeriesView<float> values, const RunningStats& statistics)
+    {
+        if (times.size() != values.size()) {
+            throw std::invalid_argument("Observable history needs one value per time");
+        }
+        Flush();
+        Observable& target = m_observables[observable];
+        target.series.Clear();
+        for (size_t k = 0; k < times.size(); ++k) {
+            target.series.Append(times[k], &values[k]);
+        }
+        target.statistics = statistics;
+    }
+
+    void ObservablePipeline::WorkerLoop()
+    {
+        std::vector<Result> results;
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+                if (m_stopping) return;
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+                m_busy = true;
+            }
+            m_idle.notify_all();
+
+            // Compute functions are only read here; Register waits for an idle worker
+            std::exception_ptr error;
+            results.clear();
+            try {
+                for (const size_t k : job.due) {
+                    results.push_back({k, job.state->time, m_observables[k].compute(*job.state)});
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_results.insert(m_results.end(), results.begin(), results.end());
+                if (error && !m_error) {
+                    m_error = error;
+                }
+                m_freeStates.push_back(std::move(job.state));
+                m_busy = false;
+            }
+            m_idle.notify_all();
+        }
+    }
+
+    void RegisterStandardObservables(ObservablePipeline& pipeline, const int interval)
+    {
+        auto momentum = [](const AtomStore& atoms, const double* velocity) {
+            const double* mass = atoms.GetMasses();
+            double sum = 0.0;
+            for (size_t i = 0; i < atoms.size(); ++i) {
+                sum += mass[i] * velocity[i];
+            }
+            return sum;
+        };
+
+        pipeline.Register("Total_Energy", interval, [](const ObservableState& state) {
+            return ForceCalculator::CalculateTotalEnergy(state.atoms);
+        });
+        pipeline.Register("Kinetic_Energy", interval, [](const ObservableState& state) {
+            return ForceCalculator::CalculateKineticEnergy(state.atoms);
+        });
+        pipeline.Register("Potential_Energy", interval, [](const ObservableState& state) {
+            return ForceCalculator::CalculatePotentialEnergy(state.atoms);
+        });
+        pipeline.Register("Temperature", interval, [](const ObservableState& state) {
+            return ForceCalculator::CalculateTemperature(state.atoms);
+        });
+        pipeline.Register("Momentum_X", interval, [momentum](const ObservableState& state) {
+            return momentum(state.atoms, state.atoms.GetVX());
+        });
+        pipeline.Register("Momentum_Y", interval, [momentum](const ObservableState& state) {
+            return momentum(state.atoms, state.atoms.GetVY());
+        });
+        // 2D virial pressure: P·A = N·k_B·T + ½·Σ r_ij·F_ij, with N·k_B·T = KE
+        pipeline.Register("Pressure", interval, [](const ObservableState& state) {
+            const glm::dvec2 extent = state.boundingBox.GetMaxPoint() - state.boundingBox.GetMinPoint();
+            const double area = extent.x * extent.y;
+            if (area <= 0.0) return 0.0;
+            return (ForceCalculator::CalculateKineticEnergy(state.atoms) + 0.5 * state.virial) / area;
+        });
+        pipeline.Register("Bond_Count", interval, [](const ObservableState& state) {
+            return static_cast<double>(state.atoms.GetTotalBondCount());
+        });
+    }
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "AtomStore.h"
+#include "BoundingBox.h"
+#include "MoleculeTracker.h"
+#include "TimeSeries.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Molecular
+{
+    // Streaming mean/variance (Welford): long-run averages without keeping samples
+    class RunningStats
+    {
+    public:
+        RunningStats() = default;
+        // Resumes from saved moments (see GetSquaredDeviationSum)
+        RunningStats(const uint64_t count, const double mean, const double squaredDeviationSum)
+            : m_count(count), m_mean(mean), m_m2(squaredDeviationSum) {}
+
+        void Add(double value);
+        void Reset() { *this = RunningStats(); }
+
+        [[nodiscard]] uint64_t GetCount() const { return m_count; }
+        [[nodiscard]] double GetMean() const { return m_mean; }
+        // Sample variance; 0 below two samples
+        [[nodiscard]] double GetVariance() const { return m_count > 1 ? m_m2 / static_cast<double>(m_count - 1) : 0.0; }
+        [[nodiscard]] double GetStandardDeviation() const;
+        [[nodiscard]] double GetSquaredDeviationSum() const { return m_m2; }
+
+    private:
+        uint64_t m_count = 0;
+        double m_mean = 0.0;
+        double m_m2 = 0.0;      // Sum of squared deviations from the running mean
+    };
+
+    // Copy of the simulation state that observables are computed from, off the
+    // stepping thread. virial is Σ r_ij·F_ij from the last force pass.
+    struct ObservableState
+    {
+        double time = 0.0;
+        uint64_t sampleIndex = 0;
+        AtomStore atoms;
+        BoundingBox boundingBox{{0.0, 0.0}, {0.0, 0.0}};
+        double virial = 0.0;
+        std::vector<std::pair<SpeciesKey, int>> speciesCounts;
+    };
+
+    using ObservableFunction = std::function<double(const ObservableState&)>;
+
+    // Indices of the observables every SimulationSpace registers, in this order
+    namespace StandardObservable {
+        constexpr size_t TotalEnergy = 0;
+        constexpr size_t KineticEnergy = 1;
+        constexpr size_t PotentialEnergy = 2;
+        constexpr size_t Temperature = 3;
+        constexpr size_t MomentumX = 4;
+        constexpr size_t MomentumY = 5;
+        constexpr size_t Pressure = 6;
+        constexpr size_t BondCount = 7;
+    }
+
+    // Registry of named per-step observables, each with its own sample interval,
+    // ring-buffer history and running statistics. Every history is a separate
+    // TimeSeries of historyCapacity samples costing ~31 bytes per sample when
+    // full, so keep the capacity modest; the statistics cover the whole run.
+    //
+    // The stepping thread hands over a snapshot when anything is due (Submit); a
+    // worker thread evaluates the due observables from it. Results are moved into
+    // the histories on the owner's thread by Collect, so readers never race the
+    // worker. Samples are processed in submission order.
+    class ObservablePipeline
+    {
+    public:
+        explicit ObservablePipeline(size_t historyCapacity);
+        ~ObservablePipeline();
+
+        ObservablePipeline(const ObservablePipeline&) = delete;
+        ObservablePipeline& operator=(const ObservablePipeline&) = delete;
+
+        // Returns the new observable's index; interval 0 registers it disabled
+        size_t Register(std::string name, int interval, ObservableFunction compute);
+        void SetInterval(size_t observable, int interval);
+
+        [[nodiscard]] size_t GetCount() const { return m_observables.size(); }
+        [[nodiscard]] const std::string& GetName(const size_t observable) const { return m_observables[observable].name; }
+        [[nodiscard]] int GetInterval(const size_t observable) const { return m_observables[observable].interval; }
+        [[nodiscard]] std::optional<size_t> Find(const std::string& name) const;
+        [[nodiscard]] const TimeSeries& GetSeries(const size_t observable) const { return m_observables[observable].series; }
+        [[nodiscard]] const RunningStats& GetStatistics(const size_t observable) const { return m_observables[observable].statistics; }
+
+        // Whether any observable samples at this index
+        [[nodiscard]] bool IsDue(uint64_t sampleIndex) const;
+
+        // A recycled state to fill and Submit
+        std::unique_ptr<ObservableState> AcquireState();
+        // Queues the state for the worker; blocks while the queue is full
+        void Submit(std::unique_ptr<ObservableState> state);
+
+        // Moves finished samples into the histories; rethrows a worker exception
+        void Collect();
+        // Waits for every submitted sample, then collects
+        void Flush();
+        // Waits for the worker, then drops all history and statistics
+        void Clear();
+        // Replaces one observable's history and statistics, e.g. from a checkpoint
+        void Restore(size_t observable, SeriesView<double> times, SeriesView<float> values,
+                     const RunningStats& statistics);
+
+    private:
+        struct Observable
+        {
+            std::string name;
+            int interval;
+            ObservableFunction compute;
+            TimeSeries series;
+            RunningStats statistics;
+        };
+
+        struct Job
+        {
+            std::unique_ptr<ObservableState> state;
+            std::vector<size_t> due;
+        };
+
+        struct Result
+        {
+            size_t observable;
+            double time;
+            double value;
+        };
+
+        static constexpr size_t m_maxPendingJobs = 4;
+
+        void WorkerLoop();
+
+        size_t m_historyCapacity;
+        std::vector<Observable> m_observables;
+
+        std::thread m_worker;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_idle;
+
+        // Guarded by m_mutex
+        std::deque<Job> m_jobs;
+        std::vector<Result> m_results;
+        std::vector<std::unique_ptr<ObservableState>> m_freeStates;
+        bool m_busy = false;
+        bool m_stopping = false;
+        std::exception_ptr m_error;
+    };
+
+    // Registers the StandardObservable set, all sampled every `interval` steps
+    void RegisterStandardObservables(ObservablePipeline& pipeline, int interval);
+}
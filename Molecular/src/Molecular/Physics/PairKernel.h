@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace Molecular::PairKernel
+{
+    // Scalar forms of the ForceCalculator pair terms on raw coordinates, for the
+    // array-based engines. Written branch-free (selects instead of early-outs) so
+    // loops over many pairs or replicas auto-vectorize.
+
+    constexpr double LennardJonesSoftening = 1e-2;
+    constexpr double CoulombSoftening = 1e-10;
+    // k_e * e^2: Coulomb's constant times the elementary charge squared (charges in e)
+    constexpr double CoulombFactor = 8.9875517873681764e9 * 1.602176634e-19 * 1.602176634e-19;
+
+    // Lennard-Jones + Coulomb force on atom a from atom b, where (dx, dy) = x_a - x_b.
+    // Each term is clamped to +-maxForce like ForceCalculator does; a positive
+    // magnitude pushes a away from b.
+    inline void Force(const double dx, const double dy,
+                      const double epsilon, const double sigma, const double chargeProduct,
+                      const double maxForce, double& fx, double& fy)
+    {
+        const double r = std::sqrt(dx * dx + dy * dy);
+        const double invR = r > 1e-10 ? 1.0 / r : 0.0;
+
+        const double rSoft = r + LennardJonesSoftening;
+        const double s2 = (sigma * sigma) / (rSoft * rSoft);
+        const double s6 = s2 * s2 * s2;
+        const double lennardJones = std::clamp(48.0 * epsilon * (s6 * s6 - 0.5 * s6) / (rSoft * rSoft), -maxForce, maxForce);
+
+        const double rCoulomb = r + CoulombSoftening;
+        const double coulomb = std::clamp(CoulombFactor * chargeProduct / (rCoulomb * rCoulomb), -maxForce, maxForce);
+
+        const double magnitude = (lennardJones + coulomb) * invR;
+        fx = magnitude * dx;
+        fy = magnitude * dy;
+    }
+
+    // Lennard-Jones pair energy 4*eps*[(s/r)^12 - (s/r)^6], as in ForceCalculator::CalculatePotentialEnergy
+    inline double Energy(const double dx, const double dy, const double epsilon, const double sigma)
+    {
+        const double r2 = dx * dx + dy * dy;
+        const double s2 = r2 > 1e-20 ? (sigma * sigma) / r2 : 0.0;
+        const double s6 = s2 * s2 * s2;
+        return 4.0 * epsilon * (s6 * s6 - s6);
+    }
+}
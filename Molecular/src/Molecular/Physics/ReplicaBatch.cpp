@@ -0,0 +1,265 @@
+#include "ReplicaBatch.h"
+
+#include "CounterRng.h"
+#include "PairKernel.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace Molecular
+{
+    ReplicaBatch::ReplicaBatch(const double energyLossFactor, const double maxForce)
+        : m_energyLossFactor(energyLossFactor), m_maxForce(maxForce) {
+    }
+
+    size_t ReplicaBatch::AddReplica(const std::vector<Atom>& atoms)
+    {
+        if (m_replicaCount > 0 && atoms.size() != m_atomsPerReplica) {
+            throw std::invalid_argument("All replicas in a batch must have the same number of atoms");
+        }
+
+        const size_t oldCount = m_replicaCount;
+        const size_t newCount = oldCount + 1;
+        m_atomsPerReplica = atoms.size();
+
+        // Re-stride every array from K to K+1 lanes and fill the new lane
+        auto widen = [&](std::vector<double>& values, auto&& newValue) {
+            std::vector<double> widened(m_atomsPerReplica * newCount);
+            for (size_t a = 0; a < m_atomsPerReplica; ++a) {
+                for (size_t k = 0; k < oldCount; ++k) {
+                    widened[a * newCount + k] = values[a * oldCount + k];
+                }
+                widened[a * newCount + oldCount] = newValue(atoms[a]);
+            }
+            values = std::move(widened);
+        };
+
+        widen(m_x, [](const Atom& atom) { return atom.GetPositionD().x; });
+        widen(m_y, [](const Atom& atom) { return atom.GetPositionD().y; });
+        widen(m_vx, [](const Atom& atom) { return atom.GetVelocityD().x; });
+        widen(m_vy, [](const Atom& atom) { return atom.GetVelocityD().y; });
+        widen(m_fx, [](const Atom&) { return 0.0; });
+        widen(m_fy, [](const Atom&) { return 0.0; });
+        widen(m_mass, [](const Atom& atom) { return atom.GetMassD(); });
+        widen(m_inverseMass, [](const Atom& atom) { return 1.0 / atom.GetMassD(); });
+        widen(m_epsilon, [](const Atom& atom) { return atom.GetEpsilonD(); });
+        widen(m_sigma, [](const Atom& atom) { return atom.GetSigmaD(); });
+        widen(m_charge, [](const Atom& atom) { return atom.GetCharge(); });
+        widen(m_vanDerWaalsRadius, [](const Atom& atom) { return atom.GetVanDerWaalsRadiusD(); });
+
+        m_replicaCount = newCount;
+        m_forcesValid = false;
+
+        // Keep every series on the shared time axis
+        m_energySeries = TimeSeries(m_maxEnergyHistory, m_replicaCount);
+        ClearEnergyHistory();
+
+        return oldCount;
+    }
+
+    void ReplicaBatch::Clear()
+    {
+        *this = ReplicaBatch(m_energyLossFactor, m_maxForce);
+    }
+
+    void ReplicaBatch::RandomizeVelocities(const double kT, const uint64_t seed)
+    {
+        const CounterRng rng(seed);
+
+        for (size_t a = 0; a < m_atomsPerReplica; ++a) {
+            for (size_t k = 0; k < m_replicaCount; ++k) {
+                const size_t i = Index(a, k);
+                const auto xi = rng.Gaussian2(k, a);
+                const double scale = std::sqrt(kT * m_inverseMass[i]);
+                m_vx[i] = scale * xi[0];
+                m_vy[i] = scale * xi[1];
+            }
+        }
+    }
+
+    void ReplicaBatch::Step(const double dt, const BoundingBox& boundingBox)
+    {
+        if (m_replicaCount == 0) return;
+
+        if (!m_forcesValid) {
+            ComputeForces();
+        }
+
+        const size_t count = m_x.size();
+        const double halfDt = 0.5 * dt;
+
+        // Half kick + drift over every atom of every replica in one flat pass
+        for (size_t i = 0; i < count; ++i) {
+            m_vx[i] += halfDt * m_fx[i] * m_inverseMass[i];
+            m_vy[i] += halfDt * m_fy[i] * m_inverseMass[i];
+            m_x[i] += dt * m_vx[i];
+            m_y[i] += dt * m_vy[i];
+        }
+
+        // Reflecting walls, same restitution as Integrator::HandleBoundaryCollision
+        constexpr double restitution = 0.9;
+        const glm::dvec2 minPoint = boundingBox.GetMinPoint();
+        const glm::dvec2 maxPoint = boundingBox.GetMaxPoint();
+        for (size_t i = 0; i < count; ++i) {
+            if (m_x[i] < minPoint.x || m_x[i] > maxPoint.x) {
+                m_x[i] = std::clamp(m_x[i], minPoint.x, maxPoint.x);
+                m_vx[i] = -m_vx[i] * restitution;
+            }
+            if (m_y[i] < minPoint.y || m_y[i] > maxPoint.y) {
+                m_y[i] = std::clamp(m_y[i], minPoint.y, maxPoint.y);
+                m_vy[i] = -m_vy[i] * restitution;
+            }
+        }
+
+        HandleCollisions();
+        ComputeForces();
+
+        // Second half kick with the new forces
+        for (size_t i = 0; i < count; ++i) {
+            m_vx[i] += halfDt * m_fx[i] * m_inverseMass[i];
+            m_vy[i] += halfDt * m_fy[i] * m_inverseMass[i];
+        }
+
+        m_accumulatedTime += dt;
+        if (m_recordCounter++ % m_energyRecordInterval == 0) {
+            RecordEnergyData();
+        }
+    }
+
+    void ReplicaBatch::ComputeForces()
+    {
+        const size_t K = m_replicaCount;
+        std::fill(m_fx.begin(), m_fx.end(), 0.0);
+        std::fill(m_fy.begin(), m_fy.end(), 0.0);
+
+        // Each pair is evaluated once (Newton's third law) across all K lanes
+        for (size_t a = 0; a < m_atomsPerReplica; ++a) {
+            for (size_t b = a + 1; b < m_atomsPerReplica; ++b) {
+                const size_t ia = a * K;
+                const size_t ib = b * K;
+
+                for (size_t k = 0; k < K; ++k) {
+                    const double epsilon = 0.5 * (m_epsilon[ia + k] + m_epsilon[ib + k]);
+                    const double sigma = 0.5 * (m_sigma[ia + k] + m_sigma[ib + k]);
+
+                    double fx, fy;
+                    PairKernel::Force(m_x[ia + k] - m_x[ib + k], m_y[ia + k] - m_y[ib + k],
+                                      epsilon, sigma, m_charge[ia + k] * m_charge[ib + k],
+                                      m_maxForce, fx, fy);
+
+                    m_fx[ia + k] += fx;
+                    m_fy[ia + k] += fy;
+                    m_fx[ib + k] -= fx;
+                    m_fy[ib + k] -= fy;
+                }
+            }
+        }
+
+        // Clamp the total force per atom, as ForceCalculator::ClampForce does
+        for (size_t i = 0; i < m_fx.size(); ++i) {
+            const double magnitude = std::sqrt(m_fx[i] * m_fx[i] + m_fy[i] * m_fy[i]);
+            const double scale = magnitude > m_maxForce ? m_maxForce / magnitude : 1.0;
+            m_fx[i] *= scale;
+            m_fy[i] *= scale;
+        }
+
+        m_forcesValid = true;
+    }
+
+    void ReplicaBatch::HandleCollisions()
+    {
+        const size_t K = m_replicaCount;
+
+        // Impulse reflection + separation of overlapping non-bonded pairs, as in
+        // ForceCalculator::HandleCollision
+        for (size_t a = 0; a < m_atomsPerReplica; ++a) {
+            for (size_t b = a + 1; b < m_atomsPerReplica; ++b) {
+                for (size_t k = 0; k < K; ++k) {
+                    const size_t ia = a * K + k;
+                    const size_t ib = b * K + k;
+
+                    const double dx = m_x[ib] - m_x[ia];
+                    const double dy = m_y[ib] - m_y[ia];
+                    const double r = std::sqrt(dx * dx + dy * dy);
+                    const double minDistance = (m_vanDerWaalsRadius[ia] + m_vanDerWaalsRadius[ib]) * 0.9;
+
+                    if (r >= minDistance || r <= 1e-10) continue;
+
+                    const double nx = dx / r;
+                    const double ny = dy / r;
+
+                    const double dotA = m_vx[ia] * nx + m_vy[ia] * ny;
+                    const double dotB = m_vx[ib] * nx + m_vy[ib] * ny;
+                    m_vx[ia] = (m_vx[ia] - 2.0 * dotA * nx) * m_energyLossFactor;
+                    m_vy[ia] = (m_vy[ia] - 2.0 * dotA * ny) * m_energyLossFactor;
+                    m_vx[ib] = (m_vx[ib] - 2.0 * dotB * nx) * m_energyLossFactor;
+                    m_vy[ib] = (m_vy[ib] - 2.0 * dotB * ny) * m_energyLossFactor;
+
+                    const double push = (minDistance - r) * 0.5;
+                    m_x[ia] -= nx * push;
+                    m_y[ia] -= ny * push;
+                    m_x[ib] += nx * push;
+                    m_y[ib] += ny * push;
+                }
+            }
+        }
+    }
+
+    glm::dvec2 ReplicaBatch::GetPosition(const size_t replica, const size_t atom) const
+    {
+        const size_t i = Index(atom, replica);
+        return {m_x[i], m_y[i]};
+    }
+
+    glm::dvec2 ReplicaBatch::GetVelocity(const size_t replica, const size_t atom) const
+    {
+        const size_t i = Index(atom, replica);
+        return {m_vx[i], m_vy[i]};
+    }
+
+    double ReplicaBatch::CalculateKineticEnergy(const size_t replica) const
+    {
+        double kinetic = 0.0;
+        for (size_t a = 0; a < m_atomsPerReplica; ++a) {
+            const size_t i = Index(a, replica);
+            kinetic += 0.5 * m_mass[i] * (m_vx[i] * m_vx[i] + m_vy[i] * m_vy[i]);
+        }
+        return kinetic;
+    }
+
+    double ReplicaBatch::CalculatePotentialEnergy(const size_t replica) const
+    {
+        double potential = 0.0;
+        for (size_t a = 0; a < m_atomsPerReplica; ++a) {
+            for (size_t b = a + 1; b < m_atomsPerReplica; ++b) {
+                const size_t ia = Index(a, replica);
+                const size_t ib = Index(b, replica);
+                potential += PairKernel::Energy(m_x[ib] - m_x[ia], m_y[ib] - m_y[ia],
+                                                0.5 * (m_epsilon[ia] + m_epsilon[ib]),
+                                                0.5 * (m_sigma[ia] + m_sigma[ib]));
+            }
+        }
+        return potential;
+    }
+
+    double ReplicaBatch::CalculateTotalEnergy(const size_t replica) const
+    {
+        return CalculateKineticEnergy(replica) + CalculatePotentialEnergy(replica);
+    }
+
+    void ReplicaBatch::ClearEnergyHistory()
+    {
+        m_energySeries.Clear();
+        m_accumulatedTime = 0.0;
+        m_recordCounter = 0;
+    }
+
+    void ReplicaBatch::RecordEnergyData()
+    {
+        m_energySample.resize(m_replicaCount);
+        for (size_t k = 0; k < m_replicaCount; ++k) {
+            m_energySample[k] = static_cast<float>(CalculateTotalEnergy(k));
+        }
+        m_energySeries.Append(m_accumulatedTime, m_energySample.data());
+    }
+}
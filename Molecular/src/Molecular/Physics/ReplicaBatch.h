@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Atom.h"
+#include "BoundingBox.h"
+#include "TimeSeries.h"
+
+namespace Molecular
+{
+    // Steps K independent small systems (replicas) together for ensemble statistics.
+    //
+    // All replicas must have the same number of atoms. Per-atom data lives in one
+    // structure-of-arrays block laid out atom-major, replica-minor (index a*K + k),
+    // so every pair kernel runs over K contiguous lanes and vectorizes across
+    // replicas. Replicas never interact.
+    //
+    // Dynamics: velocity Verlet with one force evaluation per step, Lennard-Jones +
+    // Coulomb (the PairKernel forms of the ForceCalculator terms), non-bonded
+    // collision response and reflecting walls. Bonding is not modelled.
+    class ReplicaBatch
+    {
+    public:
+        explicit ReplicaBatch(double energyLossFactor = 0.9, double maxForce = 1e3);
+
+        // Appends a replica; throws std::invalid_argument if its atom count differs
+        // from the replicas already in the batch. Returns the replica index.
+        size_t AddReplica(const std::vector<Atom>& atoms);
+        void Clear();
+
+        // Maxwell-Boltzmann velocities at k_B*T, drawn independently per replica
+        void RandomizeVelocities(double kT, uint64_t seed);
+
+        void Step(double dt, const BoundingBox& boundingBox);
+
+        [[nodiscard]] size_t GetReplicaCount() const { return m_replicaCount; }
+        [[nodiscard]] size_t GetAtomsPerReplica() const { return m_atomsPerReplica; }
+
+        [[nodiscard]] glm::dvec2 GetPosition(size_t replica, size_t atom) const;
+        [[nodiscard]] glm::dvec2 GetVelocity(size_t replica, size_t atom) const;
+
+        // Per-replica observables
+        [[nodiscard]] double CalculateKineticEnergy(size_t replica) const;
+        [[nodiscard]] double CalculatePotentialEnergy(size_t replica) const;
+        [[nodiscard]] double CalculateTotalEnergy(size_t replica) const;
+
+        // One channel per replica on a shared time axis
+        [[nodiscard]] const TimeSeries& GetEnergySeries() const { return m_energySeries; }
+        [[nodiscard]] SeriesView<float> GetEnergyHistory(size_t replica) const { return m_energySeries.GetChannel(replica); }
+        [[nodiscard]] SeriesView<double> GetTimeHistory() const { return m_energySeries.GetTimes(); }
+        void ClearEnergyHistory();
+
+    private:
+        [[nodiscard]] size_t Index(const size_t atom, const size_t replica) const { return atom * m_replicaCount + replica; }
+
+        void ComputeForces();
+        void HandleCollisions();
+        void RecordEnergyData();
+
+        size_t m_replicaCount = 0;
+        size_t m_atomsPerReplica = 0;
+
+        // Hot per-atom arrays, index a*K + k
+        std::vector<double> m_x, m_y;
+        std::vector<double> m_vx, m_vy;
+        std::vector<double> m_fx, m_fy;
+        std::vector<double> m_mass, m_inverseMass;
+
+        // Force-field parameters, same layout
+        std::vector<double> m_epsilon, m_sigma, m_charge, m_vanDerWaalsRadius;
+
+        bool m_forcesValid = false;
+        double m_energyLossFactor;
+        double m_maxForce;
+
+        static constexpr int m_energyRecordInterval = 5;
+        static constexpr size_t m_maxEnergyHistory = 1000000;
+
+        // Energy tracking: one channel per replica, shared time axis
+        TimeSeries m_energySeries{m_maxEnergyHistory, 0};
+        std::vector<float> m_energySample;
+        double m_accumulatedTime = 0.0;
+        int m_recordCounter = 0;
+    };
+}
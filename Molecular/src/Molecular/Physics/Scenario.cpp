@@ -0,0 +1,258 @@
+#include "Scenario.h"
+
+#include "SimulationSpace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace Molecular
+{
+    namespace
+    {
+        struct IntegratorName
+        {
+            const char* name;
+            IntegrationMethod method;
+        };
+
+        constexpr IntegratorName integratorNames[] = {
+            {"euler", IntegrationMethod::Euler},
+            {"rk4", IntegrationMethod::RungeKutta4},
+            {"leapfrog", IntegrationMethod::LeapFrog},
+            {"velocity-verlet", IntegrationMethod::VelocityVerlet},
+            {"verlet", IntegrationMethod::Verlet},
+            {"langevin", IntegrationMethod::Langevin},
+        };
+
+        constexpr double defaultTimeStep = 1e-3;
+
+        // Tokens of one directive, with the location for error messages
+        class DirectiveReader
+        {
+        public:
+            DirectiveReader(const std::string& line, std::string location)
+                : m_location(std::move(location))
+            {
+                std::istringstream tokens(line);
+                for (std::string token; tokens >> token;) {
+                    m_tokens.push_back(token);
+                }
+            }
+
+            [[noreturn]] void Fail(const std::string& what) const
+            {
+                throw std::runtime_error(m_location + ": " + what);
+            }
+
+            const std::string& Word(const char* what)
+            {
+                if (!HasMore()) Fail(std::string("missing ") + what);
+                return m_tokens[m_next++];
+            }
+
+            template<typename T>
+            T Number(const char* what)
+            {
+                const std::string& word = Word(what);
+                std::istringstream parser(word);
+                T value;
+                // Streams wrap "-1" around for unsigned types
+                const bool negativeUnsigned = std::is_unsigned_v<T> && word.front() == '-';
+                if (negativeUnsigned || !(parser >> value) || !parser.eof()) {
+                    Fail("'" + word + "' is not a valid " + what);
+                }
+                return value;
+            }
+
+            double Positive(const char* what)
+            {
+                const auto value = Number<double>(what);
+                if (!(value > 0.0)) Fail(std::string(what) + " must be positive");
+                return value;
+            }
+
+            int Count(const char* what)
+            {
+                const auto value = Number<int>(what);
+                if (value < 0) Fail(std::string(what) + " must be >= 0");
+                return value;
+            }
+
+            [[nodiscard]] bool HasMore() const { return m_next < m_tokens.size(); }
+
+            void End() const
+            {
+                if (HasMore()) Fail("unexpected '" + m_tokens[m_next] + "'");
+            }
+
+        private:
+            std::vector<std::string> m_tokens;
+            size_t m_next = 0;
+            std::string m_location;
+        };
+
+        ElementId ReadElement(DirectiveReader& reader)
+        {
+            const std::string symbol = reader.Word("element");
+            const auto element = FindElement(symbol);
+            if (!element) reader.Fail("unknown element '" + symbol + "'");
+            return *element;
+        }
+    }
+
+    Scenario ParseScenario(std::istream& input, const std::string& sourceName)
+    {
+        Scenario scenario;
+        std::string line;
+        for (int lineNumber = 1; std::getline(input, line); ++lineNumber) {
+            line = line.substr(0, line.find('#'));
+            DirectiveReader reader(line, sourceName + ":" + std::to_string(lineNumber));
+            if (!reader.HasMore()) continue;
+
+            const std::string key = reader.Word("directive");
+            if (key == "integrator") {
+                const std::string name = reader.Word("integrator name");
+                bool known = false;
+                for (const IntegratorName& entry : integratorNames) {
+                    if (name == entry.name) {
+                        scenario.method = entry.method;
+                        known = true;
+                    }
+                }
+                if (!known) reader.Fail("unknown integrator '" + name + "'");
+            } else if (key == "dt") {
+                scenario.timeStep = reader.Positive("time step");
+            } else if (key == "steps") {
+                scenario.steps = reader.Number<uint64_t>("step count");
+            } else if (key == "box") {
+                const auto minX = reader.Number<double>("box min x");
+                const auto minY = reader.Number<double>("box min y");
+                const auto maxX = reader.Number<double>("box max x");
+                const auto maxY = reader.Number<double>("box max y");
+                if (!(minX < maxX && minY < maxY)) reader.Fail("box max must exceed box min");
+                scenario.box = BoundingBox(glm::dvec2(minX, minY), glm::dvec2(maxX, maxY));
+            } else if (key == "seed") {
+                scenario.seed = reader.Number<uint64_t>("seed");
+            } else if (key == "temperature") {
+                scenario.thermostat.targetTemperature = reader.Number<double>("temperature");
+                if (scenario.thermostat.targetTemperature < 0.0) reader.Fail("temperature must be >= 0");
+            } else if (key == "friction") {
+                scenario.thermostat.friction = reader.Positive("friction");
+            } else if (key == "energy-loss") {
+                scenario.energyLossFactor = reader.Number<double>("energy loss factor");
+            } else if (key == "max-force") {
+                scenario.maxForce = reader.Positive("max force");
+            } else if (key == "threads") {
+                scenario.threads = static_cast<size_t>(reader.Count("thread count"));
+            } else if (key == "reorder-interval") {
+                scenario.reorderInterval = reader.Count("reorder interval");
+            } else if (key == "atom") {
+                const ElementId element = ReadElement(reader);
+                const auto x = reader.Number<double>("x");
+                const auto y = reader.Number<double>("y");
+                glm::dvec2 velocity(0.0);
+                if (reader.HasMore()) {
+                    velocity.x = reader.Number<double>("vx");
+                    velocity.y = reader.Number<double>("vy");
+                }
+                Atom atom(element, glm::dvec2(x, y), velocity);
+                if (reader.HasMore()) {
+                    atom.SetCharge(reader.Number<double>("charge"));
+                }
+                scenario.atoms.push_back(atom);
+            } else if (key == "grid") {
+                const ElementId element = ReadElement(reader);
+                const int columns = reader.Count("column count");
+                const int rows = reader.Count("row count");
+                const double spacing = reader.Positive("spacing");
+                const auto x = reader.Number<double>("first x");
+                const auto y = reader.Number<double>("first y");
+                for (int row = 0; row < rows; ++row) {
+                    for (int column = 0; column < columns; ++column) {
+                        scenario.atoms.emplace_back(element, glm::dvec2(x + spacing * column, y + spacing * row));
+                    }
+                }
+            } else if (key == "restart") {
+                scenario.restartPath = reader.Word("checkpoint path");
+            } else if (key == "trajectory") {
+                scenario.trajectoryPath = reader.Word("trajectory path");
+                if (reader.HasMore()) {
+                    scenario.trajectory.interval = std::max(1, reader.Count("frame interval"));
+                }
+            } else if (key == "trajectory-precision") {
+                scenario.trajectory.positionPrecision = reader.Number<double>("precision");
+                if (scenario.trajectory.positionPrecision < 0.0) reader.Fail("precision must be >= 0");
+            } else if (key == "observables") {
+                scenario.observablesPath = reader.Word("observables path");
+            } else if (key == "checkpoint") {
+                scenario.checkpointPath = reader.Word("checkpoint path");
+                if (reader.HasMore()) {
+                    scenario.checkpointInterval = reader.Count("checkpoint interval");
+                }
+            } else if (key == "hash-log") {
+                scenario.hashLogPath = reader.Word("hash log path");
+            } else {
+                reader.Fail("unknown directive '" + key + "'");
+            }
+            reader.End();
+        }
+
+        if (scenario.atoms.empty() && scenario.restartPath.empty()) {
+            throw std::runtime_error(sourceName + ": no atoms and no restart checkpoint");
+        }
+        return scenario;
+    }
+
+    Scenario LoadScenario(const std::string& path)
+    {
+        std::ifstream file(path);
+        if (!file) {
+            throw std::runtime_error("Could not open scenario '" + path + "'");
+        }
+        return ParseScenario(file, path);
+    }
+
+    void ApplyScenario(const Scenario& scenario, SimulationSpace& space)
+    {
+        space.ClearAllAtoms();
+        if (!scenario.restartPath.empty()) {
+            space.LoadCheckpoint(scenario.restartPath);
+        } else {
+            space.SetIntegrationMethod(scenario.method);
+            if (scenario.seed) {
+                space.SetRandomSeed(*scenario.seed);
+            }
+            space.SetTargetTemperature(scenario.thermostat.targetTemperature);
+            space.SetFriction(scenario.thermostat.friction);
+            space.SetEnergyLossFactor(scenario.energyLossFactor);
+            space.SetMaxForce(scenario.maxForce);
+            space.SetReorderInterval(scenario.reorderInterval);
+            for (const Atom& atom : scenario.atoms) {
+                space.AddObject(atom);
+            }
+            space.SaveInitialState();
+        }
+
+        const size_t threads = scenario.threads > 0 ? scenario.threads : std::thread::hardware_concurrency();
+        space.SetThreadCount(std::max<size_t>(1, threads));
+        // A restart keeps the checkpoint's fixed step and hashing unless overridden
+        const bool restarting = !scenario.restartPath.empty();
+        if (scenario.timeStep) {
+            space.SetFixedTimeStep(*scenario.timeStep);
+        } else if (!restarting || space.GetFixedTimeStep() == 0.0) {
+            space.SetFixedTimeStep(defaultTimeStep);
+        }
+        if (!restarting || !scenario.hashLogPath.empty()) {
+            space.SetStateHashing(!scenario.hashLogPath.empty());
+        }
+        space.SetAutoCheckpoint(scenario.checkpointPath, scenario.checkpointPath.empty() ? 0 : scenario.checkpointInterval);
+        if (!scenario.trajectoryPath.empty()) {
+            space.StartTrajectory(scenario.trajectoryPath, scenario.trajectory);
+        }
+    }
+}
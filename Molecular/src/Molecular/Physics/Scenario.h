@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Atom.h"
+#include "BoundingBox.h"
+#include "IntegrationPolicies.h"
+#include "TrajectoryWriter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Molecular
+{
+    class SimulationSpace;
+
+    // A batch job: starting atoms, integrator and step settings, and what to write.
+    //
+    // Scenario files are plain text, one directive per line, '#' starts a comment:
+    //
+    //   integrator langevin          euler | rk4 | leapfrog | velocity-verlet | verlet | langevin
+    //   dt 1e-3                      fixed time step (s); default 1e-3, or the checkpoint's on restart
+    //   steps 100000
+    //   box -5 -5 5 5                min x, min y, max x, max y (nm)
+    //   seed 42                      thermostat random streams
+    //   temperature 0.5              Langevin k_B*T
+    //   friction 5                   Langevin friction (1/s)
+    //   energy-loss 0.9
+    //   max-force 1000
+    //   threads 0                    0 = every core
+    //   reorder-interval 500
+    //   atom O 0.1 0.2 [vx vy [charge]]
+    //   grid H 20 10 0.4 -4 -2       element, columns, rows, spacing, first x, first y
+    //   restart run.molckpt          start from a checkpoint instead of the atoms above
+    //   trajectory run.moltraj 100   path, steps between frames
+    //   trajectory-precision 1e-4    quantise positions to this (nm); 0 = raw doubles
+    //   observables run.csv          exported when the run ends
+    //   checkpoint run.molckpt 10000 path, steps between checkpoints; also written at the end
+    //   hash-log run.hashes          per-step state hashes (see Determinism.h)
+    struct Scenario
+    {
+        IntegrationMethod method = IntegrationMethod::VelocityVerlet;
+        std::optional<double> timeStep;     // Unset: see ApplyScenario
+        uint64_t steps = 1000;
+        BoundingBox box{glm::dvec2(-5.0), glm::dvec2(5.0)};
+        std::optional<uint64_t> seed;
+        ThermostatSettings thermostat;
+        double energyLossFactor = 0.9;
+        double maxForce = 1e3;
+        size_t threads = 0;
+        int reorderInterval = 500;
+        std::vector<Atom> atoms;
+
+        std::string restartPath;
+        std::string trajectoryPath;
+        TrajectorySettings trajectory;
+        std::string observablesPath;
+        std::string checkpointPath;
+        int checkpointInterval = 0;
+        std::string hashLogPath;
+    };
+
+    // Both throw std::runtime_error naming the source and line of the first problem
+    [[nodiscard]] Scenario ParseScenario(std::istream& input, const std::string& sourceName);
+    [[nodiscard]] Scenario LoadScenario(const std::string& path);
+
+    // Clears the space and sets it up to run the scenario at its fixed time step:
+    // atoms (or the restart checkpoint, whose atoms and physics settings then win),
+    // threads, auto-checkpoints, trajectory and state hashing. On restart, the
+    // checkpoint's fixed step and hashing switch stay unless `dt` or `hash-log`
+    // override them. Does not start it.
+    void ApplyScenario(const Scenario& scenario, SimulationSpace& space);
+}
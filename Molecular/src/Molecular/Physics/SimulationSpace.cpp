@@ -1,27 +1,202 @@
 #include "SimulationSpace.h"
+#include "SpatialOrder.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
+#include <algorithm>
+#include <ctime>
+#include <fstream>
 #include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
 #include <gtx/norm.hpp>
-#include <Core/Log.h>
-#include "Molecular.h"
 
 
 namespace Molecular {
 
+    namespace
+    {
+        // Scalar state of a checkpoint; the arrays follow it in the payload
+        struct CheckpointRecord
+        {
+            uint32_t integrationMethod;
+            uint32_t adaptiveTimeStep;
+            double maxTimeStep;
+            double minTimeStep;
+            double errorTolerance;
+            double targetTemperature;
+            double friction;
+            uint64_t randomSeed;
+            uint64_t stepIndex;
+            double energyLossFactor;
+            double maxForce;
+            double bondSkin;
+            int32_t bondInterval;
+            int32_t reorderInterval;
+            int32_t stepsSinceReorder;
+            int32_t bondCallCounter;
+            double accumulatedTime;
+            uint64_t recordCounter;
+            double fixedTimeStep;
+            uint32_t stateHashing;
+            uint32_t verletInitialized;
+            double lastTimeStep;
+        };
+
+        struct SavedObservable
+        {
+            std::string name;
+            std::vector<double> times;
+            std::vector<float> values;
+            RunningStats statistics;
+        };
+
+        [[noreturn]] void ThrowCorruptCheckpoint(const char* what)
+        {
+            throw std::runtime_error(std::string("Corrupt checkpoint: ") + what);
+        }
+
+        bool IsKnownElement(const ElementId element)
+        {
+            return static_cast<size_t>(element) < ElementCount;
+        }
+
+        // The store's arrays as they are, with ids, and bonds as index pairs
+        void EncodeAtoms(CheckpointEncoder& encoder, const AtomStore& atoms)
+        {
+            const size_t count = atoms.size();
+            for (const double* array : {atoms.GetX(), atoms.GetY(), atoms.GetVX(), atoms.GetVY(),
+                                        atoms.GetFX(), atoms.GetFY(), atoms.GetPreviousX(),
+                                        atoms.GetPreviousY(), atoms.GetCharges()}) {
+                encoder.PutArray(array, count);
+            }
+            encoder.PutArray(atoms.GetElementIds(), count);
+            encoder.PutArray(atoms.GetIds(), count);
+            const std::vector<BondEdge>& bonds = atoms.GetBondEdges();
+            encoder.PutArray(bonds.data(), bonds.size());
+        }
+
+        AtomStore DecodeAtoms(CheckpointDecoder& decoder)
+        {
+            std::vector<double> x, y, vx, vy, fx, fy, previousX, previousY, charges;
+            std::vector<ElementId> elements;
+            std::vector<uint32_t> ids;
+            std::vector<BondEdge> bonds;
+            for (std::vector<double>* array : {&x, &y, &vx, &vy, &fx, &fy, &previousX, &previousY, &charges}) {
+                decoder.GetArray(*array);
+            }
+            decoder.GetArray(elements);
+            decoder.GetArray(ids);
+            decoder.GetArray(bonds);
+
+            const size_t count = x.size();
+            for (const std::vector<double>* array : {&y, &vx, &vy, &fx, &fy, &previousX, &previousY, &charges}) {
+                if (array->size() != count) ThrowCorruptCheckpoint("atom arrays differ in length");
+            }
+            if (elements.size() != count || ids.size() != count) {
+                ThrowCorruptCheckpoint("atom arrays differ in length");
+            }
+            if (!std::all_of(elements.begin(), elements.end(), IsKnownElement)) {
+                ThrowCorruptCheckpoint("bad element ids");
+            }
+
+            AtomStore atoms;
+            atoms.Reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                Atom atom(elements[i], {x[i], y[i]}, {vx[i], vy[i]});
+                atom.SetCharge(charges[i]);
+                atoms.Add(atom);
+            }
+            // The ids key the per-atom random streams, so they are kept too
+            try {
+                atoms.RestoreIds(ids.data());
+            } catch (const std::invalid_argument&) {
+                ThrowCorruptCheckpoint("invalid atom ids");
+            }
+            std::copy(fx.begin(), fx.end(), atoms.GetFX());
+            std::copy(fy.begin(), fy.end(), atoms.GetFY());
+            std::copy(previousX.begin(), previousX.end(), atoms.GetPreviousX());
+            std::copy(previousY.begin(), previousY.end(), atoms.GetPreviousY());
+            for (const BondEdge& bond : bonds) {
+                if (bond.first >= count || bond.second >= count || !atoms.AddBond(bond.first, bond.second)) {
+                    ThrowCorruptCheckpoint("invalid bond");
+                }
+            }
+            return atoms;
+        }
+    }
+
     SimulationSpace::SimulationSpace()
         : m_forceCalculator(0.9), m_integrator(IntegrationMethod::RungeKutta4) {
+        RegisterStandardObservables(m_observables, m_defaultObservableInterval);
     }
 
     SimulationSpace::SimulationSpace(IntegrationMethod method, double energyLossFactor)
         : m_forceCalculator(energyLossFactor), m_integrator(method) {
+        RegisterStandardObservables(m_observables, m_defaultObservableInterval);
     }
 
     void SimulationSpace::AddObject(const Atom& atom) {
-        m_atoms.push_back(atom);
+        SyncVerletVelocities();
+        m_verletInitialized = false;
+
+        m_atoms.Add(atom);
+        m_bondTracker.Invalidate();
+        m_molecules.Invalidate();
         if (!m_isRunning) {
-            m_initialAtoms.push_back(atom);
+            m_resetAtoms.Add(atom);
+        }
+    }
+
+    void SimulationSpace::RemoveObject(const size_t index) {
+        if (index >= m_atoms.size()) return;
+
+        SyncVerletVelocities();
+        m_verletInitialized = false;
+
+        // Keep the reset point in step with the live atoms
+        if (m_resetAtoms.size() == m_atoms.size()) {
+            m_resetAtoms.SwapRemove(index);
         }
+        m_atoms.SwapRemove(index);
+        m_bondTracker.Invalidate();
+        m_molecules.Invalidate();
+    }
+
+    void SimulationSpace::ReorderAtoms(const std::vector<uint32_t>& order) {
+        m_atoms.Permute(order);
+        m_bondTracker.Invalidate();
+        m_molecules.Invalidate();
+
+        if (m_resetAtoms.size() == order.size()) {
+            m_resetAtoms.Permute(order);
+        }
+    }
+
+    void SimulationSpace::SetThreadCount(const size_t threadCount) {
+        m_bondTracker.SetThreadPool(nullptr);
+        m_forceCalculator.SetThreadPool(nullptr);
+        m_threadPool.reset();
+        if (threadCount > 1) {
+            m_threadPool = std::make_unique<ThreadPool>(threadCount);
+            m_bondTracker.SetThreadPool(m_threadPool.get());
+            m_forceCalculator.SetThreadPool(m_threadPool.get());
+        }
+    }
+
+    void SimulationSpace::SetFixedTimeStep(const double dt) {
+        if (!(dt >= 0.0)) {
+            throw std::invalid_argument("Fixed time step must be >= 0");
+        }
+        m_fixedTimeStep = dt;
+    }
+
+    void SimulationSpace::ReorderForLocality() {
+        const std::vector<uint32_t> order = ComputeMortonOrder(m_atoms);
+        if (std::is_sorted(order.begin(), order.end())) {
+            return;
+        }
+        ReorderAtoms(order);
     }
 
     void SimulationSpace::Update(Timestep timeStep, const BoundingBox& boundingBox) {
@@ -29,60 +204,223 @@ namespace Molecular {
             return;
         }
 
-        const double dt = timeStep.GetSeconds();
+        const double dt = m_fixedTimeStep > 0.0 ? m_fixedTimeStep : static_cast<double>(timeStep.GetSeconds());
         m_accumulatedTime += dt;
+        m_lastTimeStep = dt;
+
+        if (m_integrator.GetIntegrationMethod() == IntegrationMethod::Verlet && !m_verletInitialized) {
+            Integrator::InitializeVerlet(m_atoms, dt, boundingBox, m_forceCalculator);
+            m_verletInitialized = true;
+        }
 
         // Update all atoms using the integrator
-        for (size_t i = 0; i < m_atoms.size(); ++i) {
-            m_integrator.Integrate(m_atoms[i], i, dt, m_atoms, boundingBox, m_forceCalculator);
+        m_integrator.Step(m_atoms, dt, boundingBox, m_forceCalculator);
+
+        if (m_reorderInterval > 0 && ++m_stepsSinceReorder >= m_reorderInterval) {
+            ReorderForLocality();
+            m_stepsSinceReorder = 0;
         }
 
-        // Record energy data periodically
-        if (m_recordCounter++ % m_energyRecordInterval == 0) {
-            RecordEnergyData(m_accumulatedTime);
+        // The bond pass closes the step: everything captured below (hashes, frames,
+        // samples, snapshots, checkpoints) sees this step's topology and cadence
+        UpdateBonds();
+
+        if (m_stateHashing) {
+            m_stateHashes.push_back({m_integrator.GetStepIndex(), HashState(m_atoms)});
+        }
+
+        if (m_trajectory.IsOpen() && m_integrator.GetStepIndex() % static_cast<uint64_t>(m_trajectory.GetSettings().interval) == 0) {
+            if (m_trajectory.GetSettings().writeVelocities) {
+                SyncVerletVelocities();
+            }
+            m_trajectory.WriteFrame(m_atoms, m_integrator.GetStepIndex(), m_accumulatedTime);
+        }
+
+        // Hand the state to the observable worker when anything is due, and pick up
+        // what it has finished
+        if (m_observables.IsDue(m_recordCounter)) {
+            RecordObservables(m_accumulatedTime, boundingBox);
+        }
+        ++m_recordCounter;
+        m_observables.Collect();
+
+        if (m_snapshotInterval > 0 &&
+            m_integrator.GetStepIndex() % static_cast<uint64_t>(m_snapshotInterval) == 0) {
+            TakeSnapshot();
+        }
+
+        // Encoding is a copy of the arrays; the disk write happens on the writer's thread
+        if (m_autoCheckpointInterval > 0 &&
+            m_integrator.GetStepIndex() % static_cast<uint64_t>(m_autoCheckpointInterval) == 0 &&
+            !m_checkpointWriter.IsBusy()) {
+            EncodeCheckpoint(m_checkpointBuffer);
+            m_checkpointWriter.Submit(m_autoCheckpointPath, m_checkpointBuffer);
+        }
+    }
+
+    void SimulationSpace::StartSimulation() {
+        // x_prev survives a pause; the edits that invalidate it clear m_verletInitialized
+        m_isRunning = true;
+    }
+
+    void SimulationSpace::StopSimulation() {
+        SyncVerletVelocities();
+        m_isRunning = false;
+    }
+
+    void SimulationSpace::SyncVerletVelocities() {
+        if (m_integrator.GetIntegrationMethod() == IntegrationMethod::Verlet && m_verletInitialized) {
+            Integrator::ReconstructVerletVelocities(m_atoms, m_lastTimeStep);
+        }
+    }
+
+    void SimulationSpace::DropStateHashesAfterCurrentStep() {
+        const uint64_t step = m_integrator.GetStepIndex();
+        while (!m_stateHashes.empty() && m_stateHashes.back().step > step) {
+            m_stateHashes.pop_back();
+        }
+    }
+
+    void SimulationSpace::AlignResetAtoms() {
+        const size_t count = m_atoms.size();
+        if (m_resetAtoms.size() != count) {
+            return;
+        }
+
+        constexpr uint32_t missing = std::numeric_limits<uint32_t>::max();
+        const uint32_t* resetIds = m_resetAtoms.GetIds();
+        const uint32_t idCount = count == 0 ? 0 : *std::max_element(resetIds, resetIds + count) + 1;
+        std::vector<uint32_t> resetIndexById(idCount, missing);
+        for (size_t i = 0; i < count; ++i) {
+            resetIndexById[resetIds[i]] = static_cast<uint32_t>(i);
+        }
+
+        std::vector<uint32_t> order(count);
+        for (size_t k = 0; k < count; ++k) {
+            const uint32_t id = m_atoms.GetId(k);
+            if (id >= idCount || resetIndexById[id] == missing) {
+                return;     // Not the same atoms; nothing to align
+            }
+            order[k] = resetIndexById[id];
+        }
+        if (!std::is_sorted(order.begin(), order.end())) {
+            m_resetAtoms.Permute(order);
         }
     }
 
     void SimulationSpace::ResetSimulation() {
         StopSimulation();
         ResetToInitialPositions();
-        m_energyHistory.clear();
-        m_timeHistory.clear();
+        m_snapshots.Clear();
+        m_observables.Clear();
         m_accumulatedTime = 0.0;
         m_recordCounter = 0;
+        m_stepsSinceReorder = 0;
+        m_integrator.ResetStepCounter();
+        m_stateHashes.clear();
 
         // Clear all bonds
-        for (auto& atom : m_atoms) {
-            atom.GetBondedAtoms().clear();
-        }
+        m_atoms.ClearBonds();
+        m_bondTracker.Invalidate();
+        m_molecules.Invalidate();
     }
 
     void SimulationSpace::ClearAllAtoms() {
         StopSimulation();
-        m_atoms.clear();
-        m_initialAtoms.clear();
-        m_energyHistory.clear();
-        m_timeHistory.clear();
+        m_atoms.Clear();
+        m_bondTracker.Invalidate();
+        m_molecules.Invalidate();
+        m_resetAtoms.Clear();
+        m_snapshots.Clear();
+        m_observables.Clear();
         m_accumulatedTime = 0.0;
         m_recordCounter = 0;
+        m_stepsSinceReorder = 0;
+        m_integrator.ResetStepCounter();
+        m_stateHashes.clear();
     }
 
     void SimulationSpace::ResetToInitialPositions() {
-        if (m_initialAtoms.size() == m_atoms.size()) {
-            for (size_t i = 0; i < m_atoms.size(); ++i) {
-                m_atoms[i].SetPosition(m_initialAtoms[i].GetPositionD());
-                m_atoms[i].SetVelocity(m_initialAtoms[i].GetVelocityD());
-                m_atoms[i].SetCharge(m_initialAtoms[i].GetCharge());
-                m_atoms[i].GetBondedAtoms().clear();
-            }
+        m_verletInitialized = false;
+
+        if (m_resetAtoms.size() == m_atoms.size()) {
+            // Array copies into the live store's existing storage
+            m_atoms = m_resetAtoms;
+            m_atoms.ClearBonds();
+            m_bondTracker.Invalidate();
+            m_molecules.Invalidate();
         }
     }
 
     void SimulationSpace::SaveInitialState() {
-        m_initialAtoms.clear();
-        for (const auto& atom : m_atoms) {
-            m_initialAtoms.push_back(atom);
+        SyncVerletVelocities();
+        m_resetAtoms = m_atoms;
+    }
+
+    void SimulationSpace::SetSnapshotInterval(const int steps) {
+        if (steps < 0) {
+            throw std::invalid_argument("Snapshot interval must be >= 0");
+        }
+        m_snapshotInterval = steps;
+    }
+
+    void SimulationSpace::TakeSnapshot() {
+        SimulationSnapshot& snapshot = m_snapshots.Push();
+        snapshot.step = m_integrator.GetStepIndex();
+        snapshot.time = m_accumulatedTime;
+        snapshot.atoms = m_atoms;
+        snapshot.recordCounter = m_recordCounter;
+        snapshot.stepsSinceReorder = m_stepsSinceReorder;
+        snapshot.bondCallCounter = m_bondTracker.GetCallCounter();
+        snapshot.verletInitialized = m_verletInitialized;
+        snapshot.lastTimeStep = m_lastTimeStep;
+    }
+
+    void SimulationSpace::RestoreSnapshot(const size_t age) {
+        const SimulationSnapshot& snapshot = m_snapshots.Get(age);
+        m_atoms = snapshot.atoms;
+        m_integrator.SetStepIndex(snapshot.step);
+        m_accumulatedTime = snapshot.time;
+        m_recordCounter = snapshot.recordCounter;
+        m_stepsSinceReorder = snapshot.stepsSinceReorder;
+        m_bondTracker.Invalidate();
+        m_bondTracker.SetCallCounter(snapshot.bondCallCounter);
+        m_molecules.Invalidate();
+
+        // x_prev came back with the atoms; it is only usable if it was live then
+        m_verletInitialized = snapshot.verletInitialized;
+        m_lastTimeStep = snapshot.lastTimeStep;
+
+        // Re-sorts since the snapshot permuted the reset point but not its atoms
+        AlignResetAtoms();
+
+        // The restored snapshot stays, so it can be returned to again
+        m_snapshots.DropNewest(age);
+        DropStateHashesAfterCurrentStep();
+    }
+
+    bool SimulationSpace::RewindSteps(const uint64_t steps) {
+        const uint64_t current = m_integrator.GetStepIndex();
+        const uint64_t target = steps > current ? 0 : current - steps;
+        const size_t age = m_snapshots.FindAtOrBefore(target);
+        if (age == m_snapshots.size() || m_snapshots.Get(age).step > target) {
+            return false;
         }
+        RestoreSnapshot(age);
+        return true;
+    }
+
+    StateDifference SimulationSpace::CompareWithSnapshot(const size_t age) const {
+        return CompareStates(m_snapshots.Get(age).atoms, m_atoms);
+    }
+
+    MinimizerResult SimulationSpace::MinimizeEnergy(const BoundingBox& boundingBox, const MinimizerSettings& settings) {
+        if (m_isRunning) {
+            return {};
+        }
+
+        const Minimizer minimizer(settings);
+        return minimizer.Minimize(m_atoms, boundingBox, m_forceCalculator);
     }
 
     void SimulationSpace::SetEnergyLossFactor(double energyLossFactor) {
@@ -90,6 +428,9 @@ namespace Molecular {
     }
 
     void SimulationSpace::SetIntegrationMethod(IntegrationMethod method) {
+        // Leaving position Verlet: hand the next scheme up-to-date velocities
+        SyncVerletVelocities();
+        m_verletInitialized = false;
         m_integrator.SetIntegrationMethod(method);
     }
 
@@ -100,74 +441,70 @@ namespace Molecular {
     void SimulationSpace::UpdateBonds() {
         if (!m_isRunning) return;
 
-        // Check for new bond formation and bond breaking
-        for (size_t i = 0; i < m_atoms.size(); ++i) {
-            for (size_t j = i + 1; j < m_atoms.size(); ++j) {
-                Atom& atomA = m_atoms[i];
-                Atom& atomB = m_atoms[j];
+        if (!m_molecules.IsValid(m_atoms)) {
+            m_molecules.Rebuild(m_atoms);
+        }
+        m_bondTracker.Update(m_atoms, m_integrator.GetStepIndex(), &m_molecules);
+    }
 
-                // Try to form new bonds
-                if (!atomA.IsBondedTo(&atomB)) {
-                    atomA.TryFormBond(&atomB);
-                }
-                // Check if existing bonds should break
-                else if (atomA.ShouldBreakBondWith(&atomB)) {
-                    atomA.BreakBond(&atomB);
-                }
-            }
+    MoleculeTracker& SimulationSpace::GetMolecules() {
+        if (!m_molecules.IsValid(m_atoms)) {
+            m_molecules.Rebuild(m_atoms);
         }
+        return m_molecules;
     }
 
     int SimulationSpace::GetTotalBondCount() const {
-        int totalBonds = 0;
-        for (const auto& atom : m_atoms) {
-            totalBonds += static_cast<int>(atom.GetBonds().size());
-        }
-        return totalBonds / 2; // Each bond is counted twice
+        return static_cast<int>(m_atoms.GetTotalBondCount());
     }
 
     std::vector<std::pair<size_t, size_t>> SimulationSpace::GetBondPairs() const {
-        std::vector<std::pair<size_t, size_t>> bonds;
+        const auto& edges = m_atoms.GetBondEdges();
 
-        for (size_t i = 0; i < m_atoms.size(); ++i) {
-            for (const auto* bondedAtom : m_atoms[i].GetBonds()) {
-                // Find the index of the bonded atom
-                for (size_t j = i + 1; j < m_atoms.size(); ++j) {
-                    if (&m_atoms[j] == bondedAtom) {
-                        bonds.emplace_back(i, j);
-                        break;
-                    }
-                }
-            }
+        std::vector<std::pair<size_t, size_t>> bonds;
+        bonds.reserve(edges.size());
+        for (const BondEdge& edge : edges) {
+            bonds.emplace_back(edge.first, edge.second);
         }
-
         return bonds;
     }
 
-    void SimulationSpace::RecordEnergyData(double currentTime) {
+    void SimulationSpace::RecordObservables(const double currentTime, const BoundingBox& boundingBox) {
         if (!m_isRunning) return;
 
-        const double totalEnergy = CalculateTotalEnergy();
+        SyncVerletVelocities();
+
+        // Only the copy happens here; the observables are evaluated on the worker
+        std::unique_ptr<ObservableState> state = m_observables.AcquireState();
+        state->time = currentTime;
+        state->sampleIndex = m_recordCounter;
+        state->atoms = m_atoms;
+        state->boundingBox = boundingBox;
+        state->virial = m_forceCalculator.GetLastVirial();
+        const auto& species = GetMolecules().GetSpeciesCounts();
+        state->speciesCounts.assign(species.begin(), species.end());
+        m_observables.Submit(std::move(state));
+    }
 
-        // Only record if we haven't exceeded max history size
-        if (m_energyHistory.size() < m_maxEnergyHistory) {
-            m_energyHistory.push_back(static_cast<float>(totalEnergy));
-            m_timeHistory.push_back(currentTime);
-        } else {
-            // Implement circular buffer behavior - remove oldest entries
-            m_energyHistory.erase(m_energyHistory.begin());
-            m_timeHistory.erase(m_timeHistory.begin());
+    size_t SimulationSpace::AddSpeciesObservable(const SpeciesKey species, const int interval) {
+        return m_observables.Register("Count_" + FormatSpecies(species), interval,
+            [species](const ObservableState& state) {
+                for (const auto& [key, count] : state.speciesCounts) {
+                    if (key == species) return static_cast<double>(count);
+                }
+                return 0.0;
+            });
+    }
 
-            m_energyHistory.push_back(static_cast<float>(totalEnergy));
-            m_timeHistory.push_back(currentTime);
-        }
+    ObservablePipeline& SimulationSpace::GetObservables() {
+        m_observables.Collect();
+        return m_observables;
     }
 
-    void SimulationSpace::ExportEnergyDataToCSV(const std::string& filename) const {
+    std::string SimulationSpace::ExportEnergyDataToCSV(const std::string& filename) {
+        m_observables.Flush();
         std::string outputFilename = filename;
 
-        MOL_CORE_INFO("STARTED EXPORTING");
-
         // Generate default filename if none provided
         if (outputFilename.empty()) {
             const auto now = std::chrono::system_clock::now();
@@ -180,28 +517,223 @@ namespace Molecular {
 
         std::ofstream file(outputFilename);
         if (!file.is_open()) {
-            MOL_CORE_ERROR("FILE COULD NOT BE OPENED");
-            return;
+            throw std::runtime_error("Could not open '" + outputFilename + "' for the observable export");
         }
 
         // Write CSV header
-        file << "Time,Total_Energy\n";
-
-        // Write energy data
-        for (size_t i = 0; i < m_energyHistory.size() && i < m_timeHistory.size(); ++i) {
-            file << std::fixed << std::setprecision(6)
-                 << m_timeHistory[i] << ","
-                 << m_energyHistory[i] << "\n";
+        const size_t observableCount = m_observables.GetCount();
+        file << "Time";
+        for (size_t k = 0; k < observableCount; ++k) {
+            file << "," << m_observables.GetName(k);
+        }
+        file << "\n";
+
+        // Observables may sample at different intervals: merge their time axes,
+        // walking one cursor per series
+        std::vector<size_t> cursors(observableCount, 0);
+        file << std::fixed << std::setprecision(6);
+        while (true) {
+            bool any = false;
+            double time = 0.0;
+            for (size_t k = 0; k < observableCount; ++k) {
+                const SeriesView<double> times = m_observables.GetSeries(k).GetTimes();
+                if (cursors[k] < times.size() && (!any || times[cursors[k]] < time)) {
+                    time = times[cursors[k]];
+                    any = true;
+                }
+            }
+            if (!any) break;
+
+            file << time;
+            for (size_t k = 0; k < observableCount; ++k) {
+                const TimeSeries& series = m_observables.GetSeries(k);
+                file << ",";
+                if (cursors[k] < series.size() && series.GetTimes()[cursors[k]] == time) {
+                    file << series.GetChannel(0)[cursors[k]++];
+                }
+            }
+            file << "\n";
         }
 
-        MOL_CORE_INFO("FINISHED EXPORTING");
         file.close();
+        if (file.fail()) {
+            throw std::runtime_error("Failed to write '" + outputFilename + "'");
+        }
+        return outputFilename;
+    }
+
+    void SimulationSpace::SaveCheckpoint(const std::string& path) {
+        // Keeps a finished auto-checkpoint from landing on top of this one
+        m_checkpointWriter.Wait();
+
+        std::vector<uint8_t> payload;
+        EncodeCheckpoint(payload);
+        WriteCheckpointFile(path, payload);
+    }
+
+    void SimulationSpace::LoadCheckpoint(const std::string& path) {
+        const std::vector<uint8_t> payload = ReadCheckpointFile(path);
+        StopSimulation();
+        DecodeCheckpoint(payload);
+        DropStateHashesAfterCurrentStep();
+    }
+
+    void SimulationSpace::SetAutoCheckpoint(const std::string& path, const int steps) {
+        if (steps < 0 || (steps > 0 && path.empty())) {
+            throw std::invalid_argument("Auto-checkpoint needs a path and a step interval >= 0");
+        }
+        m_autoCheckpointPath = path;
+        m_autoCheckpointInterval = steps;
+    }
+
+    void SimulationSpace::EncodeCheckpoint(std::vector<uint8_t>& payload) {
+        SyncVerletVelocities();
+        m_observables.Flush();
+
+        payload.clear();
+        CheckpointEncoder encoder(payload);
+
+        // Element ids index elementTable, so a checkpoint only loads against the same table
+        encoder.Put(static_cast<uint64_t>(ElementCount));
+        for (const AtomProperties& properties : elementTable) {
+            encoder.PutString(std::string(properties.symbol));
+        }
+
+        CheckpointRecord record{};
+        record.integrationMethod = static_cast<uint32_t>(m_integrator.GetIntegrationMethod());
+        record.adaptiveTimeStep = m_integrator.IsAdaptiveTimeStep() ? 1 : 0;
+        record.maxTimeStep = m_integrator.GetMaxTimeStep();
+        record.minTimeStep = m_integrator.GetMinTimeStep();
+        record.errorTolerance = m_integrator.GetErrorTolerance();
+        record.targetTemperature = m_integrator.GetTargetTemperature();
+        record.friction = m_integrator.GetFriction();
+        record.randomSeed = m_integrator.GetRandomSeed();
+        record.stepIndex = m_integrator.GetStepIndex();
+        record.energyLossFactor = m_forceCalculator.GetEnergyLossFactor();
+        record.maxForce = m_forceCalculator.GetMaxForce();
+        record.bondSkin = m_bondTracker.GetSettings().skin;
+        record.bondInterval = m_bondTracker.GetSettings().interval;
+        record.bondCallCounter = m_bondTracker.GetCallCounter();
+        record.reorderInterval = m_reorderInterval;
+        record.stepsSinceReorder = m_stepsSinceReorder;
+        record.accumulatedTime = m_accumulatedTime;
+        record.recordCounter = m_recordCounter;
+        record.fixedTimeStep = m_fixedTimeStep;
+        record.stateHashing = m_stateHashing ? 1 : 0;
+        record.verletInitialized = m_verletInitialized ? 1 : 0;
+        record.lastTimeStep = m_lastTimeStep;
+        encoder.Put(record);
+
+        EncodeAtoms(encoder, m_atoms);
+        EncodeAtoms(encoder, m_resetAtoms);
+
+        encoder.Put(static_cast<uint64_t>(m_observables.GetCount()));
+        for (size_t k = 0; k < m_observables.GetCount(); ++k) {
+            const TimeSeries& series = m_observables.GetSeries(k);
+            const RunningStats& statistics = m_observables.GetStatistics(k);
+            encoder.PutString(m_observables.GetName(k));
+            encoder.PutArray(series.GetTimes().data(), series.size());
+            encoder.PutArray(series.GetChannel(0).data(), series.size());
+            encoder.Put(statistics.GetCount());
+            encoder.Put(statistics.GetMean());
+            encoder.Put(statistics.GetSquaredDeviationSum());
+        }
+    }
+
+    void SimulationSpace::DecodeCheckpoint(const std::vector<uint8_t>& payload) {
+        CheckpointDecoder decoder(payload.data(), payload.size());
+
+        // Parse and check everything before touching the live state
+        if (decoder.Get<uint64_t>() != ElementCount) {
+            throw std::runtime_error("Checkpoint was written with a different element table");
+        }
+        for (const AtomProperties& properties : elementTable) {
+            if (decoder.GetString() != properties.symbol) {
+                throw std::runtime_error("Checkpoint was written with a different element table");
+            }
+        }
+
+        const auto record = decoder.Get<CheckpointRecord>();
+        if (record.integrationMethod > static_cast<uint32_t>(IntegrationMethod::Verlet)) {
+            ThrowCorruptCheckpoint("unknown integration method");
+        }
+        if (record.bondInterval < 1 || record.bondSkin < 0.0 || record.bondCallCounter < 0) {
+            ThrowCorruptCheckpoint("invalid bond settings");
+        }
+        if (!(record.fixedTimeStep >= 0.0) || !(record.lastTimeStep >= 0.0)) {
+            ThrowCorruptCheckpoint("invalid time step");
+        }
+
+        AtomStore atoms = DecodeAtoms(decoder);
+        AtomStore resetAtoms = DecodeAtoms(decoder);
+
+        const auto observableCount = decoder.Get<uint64_t>();
+        std::vector<SavedObservable> observables;
+        for (uint64_t k = 0; k < observableCount; ++k) {
+            SavedObservable& saved = observables.emplace_back();
+            saved.name = decoder.GetString();
+            decoder.GetArray(saved.times);
+            decoder.GetArray(saved.values);
+            const auto sampleCount = decoder.Get<uint64_t>();
+            const auto mean = decoder.Get<double>();
+            const auto squaredDeviationSum = decoder.Get<double>();
+            saved.statistics = RunningStats(sampleCount, mean, squaredDeviationSum);
+            if (saved.times.size() != saved.values.size()) {
+                ThrowCorruptCheckpoint("observable history differs in length");
+            }
+        }
+        if (!decoder.AtEnd()) {
+            ThrowCorruptCheckpoint("trailing data");
+        }
+
+        // Commit
+        m_atoms = std::move(atoms);
+        m_resetAtoms = std::move(resetAtoms);
+        m_snapshots.Clear();
+        m_bondTracker.Invalidate();
+        m_molecules.Invalidate();
+
+        m_integrator.SetIntegrationMethod(static_cast<IntegrationMethod>(record.integrationMethod));
+        m_integrator.SetAdaptiveTimeStep(record.adaptiveTimeStep != 0);
+        m_integrator.SetMaxTimeStep(record.maxTimeStep);
+        m_integrator.SetMinTimeStep(record.minTimeStep);
+        m_integrator.SetErrorTolerance(record.errorTolerance);
+        m_integrator.SetTargetTemperature(record.targetTemperature);
+        m_integrator.SetFriction(record.friction);
+        m_integrator.SetRandomSeed(record.randomSeed);
+        m_integrator.SetStepIndex(record.stepIndex);
+        m_forceCalculator.SetEnergyLossFactor(record.energyLossFactor);
+        m_forceCalculator.SetMaxForce(record.maxForce);
+        m_bondTracker.SetSettings({record.bondInterval, record.bondSkin});
+        m_bondTracker.SetCallCounter(record.bondCallCounter);
+        m_reorderInterval = record.reorderInterval;
+        m_stepsSinceReorder = record.stepsSinceReorder;
+        m_accumulatedTime = record.accumulatedTime;
+        m_recordCounter = record.recordCounter;
+        m_fixedTimeStep = record.fixedTimeStep;
+        m_stateHashing = record.stateHashing != 0;
+        // x_prev came back with the atoms, so position Verlet carries on from it
+        m_verletInitialized = record.verletInitialized != 0;
+        m_lastTimeStep = record.lastTimeStep;
+
+        // Histories of observables this space does not have (yet) are dropped
+        m_observables.Clear();
+        for (const SavedObservable& saved : observables) {
+            if (const auto index = m_observables.Find(saved.name)) {
+                m_observables.Restore(*index, {saved.times.data(), saved.times.size()},
+                                      {saved.values.data(), saved.values.size()}, saved.statistics);
+            }
+        }
     }
 
     double SimulationSpace::CalculateTotalEnergy() const {
         return ForceCalculator::CalculateTotalEnergy(m_atoms);
     }
 
+    double SimulationSpace::CalculateTemperature() const {
+        return ForceCalculator::CalculateTemperature(m_atoms);
+    }
+
     double SimulationSpace::GetEnergyLossFactor() const {
         return m_forceCalculator.GetEnergyLossFactor();
     }
@@ -1,12 +1,23 @@
 #pragma once
 
 #include "Atom.h"
+#include "AtomStore.h"
+#include "BondTracker.h"
 #include "BoundingBox.h"
+#include "Checkpoint.h"
+#include "Determinism.h"
 #include "ForceCalculator.h"
 #include "Integrator.h"
+#include "Minimizer.h"
+#include "MoleculeTracker.h"
+#include "Observables.h"
+#include "Snapshot.h"
+#include "ThreadPool.h"
+#include "TrajectoryWriter.h"
 #include "Molecular/Core/Timestep.h"
 
 #include <chrono>
+#include <memory>
 
 namespace Molecular{
 
@@ -17,40 +28,136 @@ namespace Molecular{
 
         // Object management
         void AddObject(const Atom& atom);
+        // Swap-removes: the last atom takes the removed atom's index
+        void RemoveObject(size_t index);
+        // Reorders the atoms (new index k <- old order[k]); bonds, Verlet state and
+        // the reset point follow. Handles from GetObjects() stay valid.
+        void ReorderAtoms(const std::vector<uint32_t>& order);
+        // Sorts the atoms along a Morton curve so spatial neighbours sit close in memory
+        void ReorderForLocality();
+        // One step: integrate, re-sort when due, then the bond pass, and only then
+        // the per-step outputs (hashes, trajectory, observables, snapshots, checkpoints)
         void Update(Molecular::Timestep timeStep, const BoundingBox& boundingBox);
 
         // Simulation control
-        void StartSimulation() { m_isRunning = true; }
-        void StopSimulation() { m_isRunning = false; }
+        void StartSimulation();
+        void StopSimulation();
         void ResetSimulation();
         void ClearAllAtoms();
+        // Back to the reset point (positions, velocities, charges), without bonds
         void ResetToInitialPositions();
+        // Makes the current atoms the reset point; it then follows edits made while stopped
         void SaveInitialState();
 
+        // Snapshots: kept every `steps` steps while running (0 = off) in a bounded
+        // ring, newest first, after the step's bond pass. Each is a copy of the atom
+        // arrays and step counters, so taking or restoring one costs about a memcpy
+        // of the state. Observable histories and trajectory files are not rewound.
+        void SetSnapshotInterval(int steps);
+        int GetSnapshotInterval() const { return m_snapshotInterval; }
+        void SetSnapshotCapacity(size_t capacity) { m_snapshots.SetCapacity(capacity); }
+        void TakeSnapshot();
+        const SnapshotRing& GetSnapshots() const { return m_snapshots; }
+        // Restores snapshot `age` (0 = newest) and forgets the newer ones
+        void RestoreSnapshot(size_t age);
+        // Restores the newest snapshot at least `steps` steps back; false if none is
+        // that old
+        bool RewindSteps(uint64_t steps);
+        // A/B comparison of snapshot `age` (first) with the current state (second)
+        StateDifference CompareWithSnapshot(size_t age) const;
+
+        // Deterministic runs: with a fixed time step (> 0) Update ignores the frame
+        // time it is given, so a run is a function of its seed, settings and step
+        // count alone; 0 goes back to wall-clock steps
+        void SetFixedTimeStep(double dt);
+        double GetFixedTimeStep() const { return m_fixedTimeStep; }
+        // Logs HashState after every step, to check two runs for bit-identity with
+        // FindFirstDivergence. Rewinds and checkpoint loads drop the entries past
+        // the restored step.
+        void SetStateHashing(bool enabled) { m_stateHashing = enabled; }
+        bool IsStateHashing() const { return m_stateHashing; }
+        const std::vector<StateHashEntry>& GetStateHashes() const { return m_stateHashes; }
+        void ClearStateHashes() { m_stateHashes.clear(); }
+
+        // Energy minimization of the current configuration (only while stopped)
+        MinimizerResult MinimizeEnergy(const BoundingBox& boundingBox, const MinimizerSettings& settings = {});
+
         // Configuration
         void SetEnergyLossFactor(double energyLossFactor);
         void SetIntegrationMethod(IntegrationMethod method);
         void SetMaxForce(double maxForce);
-
-        // Bond management
+        void SetTargetTemperature(double kT) { m_integrator.SetTargetTemperature(kT); }
+        void SetFriction(double gamma) { m_integrator.SetFriction(gamma); }
+        void SetRandomSeed(uint64_t seed) { m_integrator.SetRandomSeed(seed); }
+        // Threads for the parallel parts of the step (forces, bond proposals); 1 = serial.
+        // Every parallel stage reduces in a fixed order, so results do not depend on it.
+        void SetThreadCount(size_t threadCount);
+        // Steps between locality re-sorts while running; 0 turns them off
+        void SetReorderInterval(int steps) { m_reorderInterval = steps; }
+
+        // Bond management. Update runs the bond pass itself; UpdateBonds runs one
+        // outside a step (e.g. right after setting up atoms), counting towards the cadence.
         void UpdateBonds();
+        void SetBondUpdateSettings(const BondUpdateSettings& settings) { m_bondTracker.SetSettings(settings); }
+        const BondUpdateSettings& GetBondUpdateSettings() const { return m_bondTracker.GetSettings(); }
+        // Bonds formed/broken since the last call
+        std::vector<BondEvent> ConsumeBondEvents() { return m_bondTracker.ConsumeEvents(); }
+
+        // Molecules (connected components of the bond graph); rebuilt here when the
+        // atom or bond count changed outside UpdateBonds
+        MoleculeTracker& GetMolecules();
         int GetTotalBondCount() const;
         std::vector<std::pair<size_t, size_t>> GetBondPairs() const;
+        const std::vector<BondEdge>& GetBondEdges() const { return m_atoms.GetBondEdges(); }
+
+        // Observables: the StandardObservable set plus anything registered on
+        // GetObservables(), sampled from a snapshot on a worker thread
+        void RecordObservables(double currentTime, const BoundingBox& boundingBox);
+        // Counts molecules of one species; returns the observable's index
+        size_t AddSpeciesObservable(SpeciesKey species, int interval);
+        // One row per sample time, one column per observable (empty where it was not sampled).
+        // An empty filename picks a timestamped one; returns the file written, throws
+        // std::runtime_error if it cannot be.
+        std::string ExportEnergyDataToCSV(const std::string& filename = "");
+        void ClearEnergyHistory() { m_observables.Clear(); }
+
+        // Trajectory output: every settings.interval steps while running, written
+        // on a background thread (see TrajectoryWriter)
+        void StartTrajectory(const std::string& path, const TrajectorySettings& settings = {}) { m_trajectory.Open(path, settings); }
+        void StopTrajectory() { m_trajectory.Close(); }
+        bool IsRecordingTrajectory() const { return m_trajectory.IsOpen(); }
+
+        // Checkpoint/restart: atoms, bonds, the reset point, integrator and force
+        // settings, the fixed time step and state hashing switch, clocks and
+        // observable histories in one binary file (see CheckpointFormat). Both throw std::runtime_error on failure.
+        void SaveCheckpoint(const std::string& path);
+        // Stops the simulation, then replaces its state; nothing changes if the file
+        // is rejected. Observable histories are matched by name.
+        void LoadCheckpoint(const std::string& path);
+        // While running, checkpoints to `path` every `steps` steps on a background
+        // thread (skipped while the previous one is still being written); 0 turns it off
+        void SetAutoCheckpoint(const std::string& path, int steps);
+        int GetAutoCheckpointInterval() const { return m_autoCheckpointInterval; }
 
-        // Energy tracking
-        void RecordEnergyData(double currentTime);
-        void ExportEnergyDataToCSV(const std::string& filename = "") const;
-        void ClearEnergyHistory() { m_energyHistory.clear(); m_timeHistory.clear(); }
         double CalculateTotalEnergy() const;
+        double CalculateTemperature() const;
 
         // Getters
         bool IsRunning() const { return m_isRunning; }
+        uint64_t GetStepIndex() const { return m_integrator.GetStepIndex(); }
         double GetEnergyLossFactor() const;
         IntegrationMethod GetIntegrationMethod() const;
-        const std::vector<Atom>& GetObjects() const { return m_atoms; }
-        std::vector<Atom>& GetObjectsMutable() { return m_atoms; }
-        const std::vector<float>& GetEnergyHistory() const { return m_energyHistory; }
-        const std::vector<double>& GetTimeHistory() const { return m_timeHistory; }
+        double GetTargetTemperature() const { return m_integrator.GetTargetTemperature(); }
+        double GetFriction() const { return m_integrator.GetFriction(); }
+        int GetReorderInterval() const { return m_reorderInterval; }
+        size_t GetThreadCount() const { return m_threadPool ? m_threadPool->GetThreadCount() : 1; }
+        const AtomStore& GetObjects() const { return m_atoms; }
+        AtomStore& GetObjectsMutable() { return m_atoms; }
+        // Collects finished samples first; the const overload shows what was collected
+        ObservablePipeline& GetObservables();
+        const ObservablePipeline& GetObservables() const { return m_observables; }
+        SeriesView<float> GetEnergyHistory() const { return GetTotalEnergySeries().GetChannel(0); }
+        SeriesView<double> GetTimeHistory() const { return GetTotalEnergySeries().GetTimes(); }
 
     private:
         // Core simulation components
@@ -60,20 +167,53 @@ namespace Molecular{
         // Simulation state
         bool m_isRunning = false;
 
-        // Atom storage
-        std::vector<Atom> m_atoms;
-        std::vector<Atom> m_initialAtoms;
-
-        // Energy tracking
-        std::vector<float> m_energyHistory;
-        std::vector<double> m_timeHistory;
+        // Atom storage: live state, the reset point and the rewind ring, all as arrays
+        AtomStore m_atoms;
+        AtomStore m_resetAtoms;
+        SnapshotRing m_snapshots{m_defaultSnapshotCapacity};
+        int m_snapshotInterval = 0;
+        std::unique_ptr<ThreadPool> m_threadPool;
+        BondTracker m_bondTracker;
+        MoleculeTracker m_molecules;
 
         // Configuration
-        static constexpr size_t m_maxEnergyHistory = 1000000;
-        static constexpr int m_energyRecordInterval = 5;
+        static constexpr size_t m_maxObservableHistory = size_t{1} << 16;
+        static constexpr int m_defaultObservableInterval = 5;
+        static constexpr size_t m_defaultSnapshotCapacity = 16;
+
+        // Each observable keeps a ring buffer of its last m_maxObservableHistory samples,
+        // about 2 MB once full (mirrored times and values plus mips), so the standard
+        // eight stay near 16 MB; at the default interval that is ~330k steps of history
+        ObservablePipeline m_observables{m_maxObservableHistory};
+        TrajectoryWriter m_trajectory;
+        CheckpointWriter m_checkpointWriter;
+        std::vector<uint8_t> m_checkpointBuffer;       // Recycled with the writer's
+        std::string m_autoCheckpointPath;
+        int m_autoCheckpointInterval = 0;
 
         // Internal counters
-        mutable int m_recordCounter = 0;
-        mutable double m_accumulatedTime = 0.0;
+        uint64_t m_recordCounter = 0;
+        double m_accumulatedTime = 0.0;
+        int m_stepsSinceReorder = 0;
+
+        // Atoms drift away from their memory neighbours as the system mixes
+        int m_reorderInterval = 500;
+
+        double m_fixedTimeStep = 0.0;
+        bool m_stateHashing = false;
+        std::vector<StateHashEntry> m_stateHashes;
+
+        // Position Verlet bookkeeping: x_prev must be seeded before the first step,
+        // and velocities are only rebuilt from (x - x_prev)/dt when they are read
+        bool m_verletInitialized = false;
+        double m_lastTimeStep = 0.0;
+
+        void SyncVerletVelocities();
+        void DropStateHashesAfterCurrentStep();
+        // Re-sorts m_resetAtoms into the live atoms' order, matching them by id
+        void AlignResetAtoms();
+        void EncodeCheckpoint(std::vector<uint8_t>& payload);
+        void DecodeCheckpoint(const std::vector<uint8_t>& payload);
+        const TimeSeries& GetTotalEnergySeries() const { return m_observables.GetSeries(StandardObservable::TotalEnergy); }
     };
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "Snapshot.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace Molecular
+{
+    namespace
+    {
+        constexpr uint32_t Missing = std::numeric_limits<uint32_t>::max();
+
+        // id -> index; ids are slot numbers, so the table stays about N long
+        void BuildIndexOfId(const AtomStore& atoms, std::vector<uint32_t>& indexOfId)
+        {
+            const uint32_t* ids = atoms.GetIds();
+            const uint32_t maxId = atoms.empty() ? 0 : *std::max_element(ids, ids + atoms.size());
+            indexOfId.assign(static_cast<size_t>(maxId) + 1, Missing);
+            for (size_t i = 0; i < atoms.size(); ++i) {
+                indexOfId[ids[i]] = static_cast<uint32_t>(i);
+            }
+        }
+
+        uint32_t Lookup(const std::vector<uint32_t>& indexOfId, const uint32_t id)
+        {
+            return id < indexOfId.size() ? indexOfId[id] : Missing;
+        }
+
+        // Bonds of `from` whose atoms both exist in `to` but are not bonded there,
+        // plus those touching an atom `to` does not have
+        size_t CountBondsMissingIn(const AtomStore& from, const AtomStore& to, const std::vector<uint32_t>& indexInTo)
+        {
+            size_t missing = 0;
+            for (const BondEdge& edge : from.GetBondEdges()) {
+                const uint32_t first = Lookup(indexInTo, from.GetId(edge.first));
+                const uint32_t second = Lookup(indexInTo, from.GetId(edge.second));
+                if (first == Missing || second == Missing || !to.IsBondedTo(first, second)) {
+                    ++missing;
+                }
+            }
+            return missing;
+        }
+    }
+
+    StateDifference CompareStates(const AtomStore& first, const AtomStore& second)
+    {
+        std::vector<uint32_t> indexInFirst, indexInSecond;
+        BuildIndexOfId(first, indexInFirst);
+        BuildIndexOfId(second, indexInSecond);
+
+        StateDifference difference;
+        double sumSquared = 0.0;
+        for (size_t i = 0; i < first.size(); ++i) {
+            const uint32_t j = Lookup(indexInSecond, first.GetId(i));
+            if (j == Missing) continue;
+
+            const double displacement = glm::length(second.GetPosition(j) - first.GetPosition(i));
+            const double velocityChange = glm::length(second.GetVelocity(j) - first.GetVelocity(i));
+            difference.maxDisplacement = std::max(difference.maxDisplacement, displacement);
+            difference.maxVelocityChange = std::max(difference.maxVelocityChange, velocityChange);
+            sumSquared += displacement * displacement;
+            ++difference.matchedAtoms;
+        }
+        difference.unmatchedAtoms = first.size() + second.size() - 2 * difference.matchedAtoms;
+        if (difference.matchedAtoms > 0) {
+            difference.rmsDisplacement = std::sqrt(sumSquared / static_cast<double>(difference.matchedAtoms));
+        }
+        difference.bondsOnlyInFirst = CountBondsMissingIn(first, second, indexInSecond);
+        difference.bondsOnlyInSecond = CountBondsMissingIn(second, first, indexInFirst);
+        return difference;
+    }
+
+    SnapshotRing::SnapshotRing(const size_t capacity)
+    {
+        SetCapacity(capacity);
+    }
+
+    SimulationSnapshot& SnapshotRing::Push()
+    {
+        m_newest = (m_newest + 1) % m_slots.size();
+        m_size = std::min(m_size + 1, m_slots.size());
+        return m_slots[m_newest];
+    }
+
+    const SimulationSnapshot& SnapshotRing::Get(const size_t age) const
+    {
+        if (age >= m_size) {
+            throw std::out_of_range("Snapshot " + std::to_string(age) + " out of range");
+        }
+        return m_slots[SlotOf(age)];
+    }
+
+    size_t SnapshotRing::FindAtOrBefore(const uint64_t step) const
+    {
+        for (size_t age = 0; age < m_size; ++age) {
+            if (m_slots[SlotOf(age)].step <= step) return age;
+        }
+        return m_size;
+    }
+
+    void SnapshotRing::DropNewest(const size_t count)
+    {
+        const size_t dropped = std::min(count, m_size);
+        m_newest = SlotOf(dropped);
+        m_size -= dropped;
+    }
+
+    void SnapshotRing::SetCapacity(const size_t capacity)
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("SnapshotRing capacity must be positive");
+        }
+        if (capacity == m_slots.size()) return;
+
+        // Move the survivors to the front, oldest first, so slot k holds age size-1-k
+        const size_t kept = std::min(m_size, capacity);
+        std::vector<SimulationSnapshot> slots(capacity);
+        for (size_t k = 0; k < kept; ++k) {
+            slots[k] = std::move(m_slots[SlotOf(kept - 1 - k)]);
+        }
+        m_slots.swap(slots);
+        m_size = kept;
+        m_newest = kept == 0 ? capacity - 1 : kept - 1;
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "AtomStore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Molecular
+{
+    // Copy of the stepping state of a SimulationSpace at one step. The atoms are
+    // a plain AtomStore copy: its arrays, bond slots and id table are flat, so
+    // taking or restoring a snapshot is a handful of memcpys.
+    struct SimulationSnapshot
+    {
+        uint64_t step = 0;
+        double time = 0.0;
+        AtomStore atoms;
+
+        // Counters that decide when the next bond pass, re-sort and sample happen
+        uint64_t recordCounter = 0;
+        int stepsSinceReorder = 0;
+        int bondCallCounter = 0;
+        bool verletInitialized = false;
+        double lastTimeStep = 0.0;
+    };
+
+    // How far two configurations are apart, matching atoms by id
+    struct StateDifference
+    {
+        size_t matchedAtoms = 0;
+        size_t unmatchedAtoms = 0;          // In one state only
+        double maxDisplacement = 0.0;
+        double rmsDisplacement = 0.0;
+        double maxVelocityChange = 0.0;
+        size_t bondsOnlyInFirst = 0;
+        size_t bondsOnlyInSecond = 0;
+    };
+
+    [[nodiscard]] StateDifference CompareStates(const AtomStore& first, const AtomStore& second);
+
+    // Bounded ring of snapshots, newest first. Slots are reused in place: once the
+    // ring has filled, Push overwrites the oldest snapshot's arrays without
+    // allocating (as long as the atom count does not grow).
+    class SnapshotRing
+    {
+    public:
+        explicit SnapshotRing(size_t capacity);
+
+        // The slot to fill: the oldest one once the ring is full
+        SimulationSnapshot& Push();
+        // age 0 is the newest snapshot
+        [[nodiscard]] const SimulationSnapshot& Get(size_t age) const;
+        // Youngest snapshot taken at or before `step`, as an age; size() if none
+        [[nodiscard]] size_t FindAtOrBefore(uint64_t step) const;
+        // Forgets the `count` newest snapshots (e.g. the ones a rewind skipped over)
+        void DropNewest(size_t count);
+        void Clear() { m_size = 0; }
+
+        // Keeps the newest snapshots that still fit
+        void SetCapacity(size_t capacity);
+        [[nodiscard]] size_t GetCapacity() const { return m_slots.size(); }
+        [[nodiscard]] size_t size() const { return m_size; }
+        [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    private:
+        [[nodiscard]] size_t SlotOf(const size_t age) const { return (m_newest + m_slots.size() - age) % m_slots.size(); }
+
+        std::vector<SimulationSnapshot> m_slots;
+        size_t m_newest = 0;
+        size_t m_size = 0;
+    };
+}
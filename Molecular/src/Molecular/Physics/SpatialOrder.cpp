@@ -0,0 +1,66 @@
+#include "SpatialOrder.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Molecular
+{
+    namespace
+    {
+        // Cells per axis of the grid the positions are quantized to
+        constexpr uint32_t GridBits = 20;
+        constexpr double GridCells = static_cast<double>(1u << GridBits);
+
+        // Spreads the bits of v apart, one zero between each
+        uint64_t SpreadBits(uint64_t v)
+        {
+            v &= 0xFFFFFFFFull;
+            v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+            v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+            v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+            v = (v | (v << 2)) & 0x3333333333333333ull;
+            v = (v | (v << 1)) & 0x5555555555555555ull;
+            return v;
+        }
+    }
+
+    uint64_t MortonCode2D(const uint32_t x, const uint32_t y)
+    {
+        return SpreadBits(x) | (SpreadBits(y) << 1);
+    }
+
+    std::vector<uint32_t> ComputeMortonOrder(const AtomStore& atoms)
+    {
+        const size_t count = atoms.size();
+        if (count == 0) return {};
+
+        const double* x = atoms.GetX();
+        const double* y = atoms.GetY();
+
+        double minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+        for (size_t i = 1; i < count; ++i) {
+            minX = std::min(minX, x[i]);
+            maxX = std::max(maxX, x[i]);
+            minY = std::min(minY, y[i]);
+            maxY = std::max(maxY, y[i]);
+        }
+
+        // Square extent keeps the cells square, so the curve does not favour an axis
+        const double extent = std::max(maxX - minX, maxY - minY);
+        const double scale = extent > 0.0 ? (GridCells - 1.0) / extent : 0.0;
+
+        std::vector<std::pair<uint64_t, uint32_t>> keyed(count);
+        for (size_t i = 0; i < count; ++i) {
+            const auto cellX = static_cast<uint32_t>((x[i] - minX) * scale);
+            const auto cellY = static_cast<uint32_t>((y[i] - minY) * scale);
+            keyed[i] = {MortonCode2D(cellX, cellY), static_cast<uint32_t>(i)};
+        }
+        std::sort(keyed.begin(), keyed.end());
+
+        std::vector<uint32_t> order(count);
+        for (size_t k = 0; k < count; ++k) {
+            order[k] = keyed[k].second;
+        }
+        return order;
+    }
+}
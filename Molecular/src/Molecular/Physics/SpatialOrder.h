@@ -0,0 +1,17 @@
+#pragma once
+
+#include "AtomStore.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Molecular
+{
+    // Interleaves the bits of x and y (x in the even bits): the Z-order index of a grid cell
+    [[nodiscard]] uint64_t MortonCode2D(uint32_t x, uint32_t y);
+
+    // Order of the atoms along a Morton curve over their bounding square, in the
+    // form AtomStore::Permute takes: order[k] is the current index of the atom
+    // that should move to k. Atoms in the same cell keep their relative order.
+    [[nodiscard]] std::vector<uint32_t> ComputeMortonOrder(const AtomStore& atoms);
+}
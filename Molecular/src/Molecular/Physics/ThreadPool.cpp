@@ -0,0 +1,101 @@
+#include "ThreadPool.h"
+
+namespace Molecular
+{
+    ThreadPool::ThreadPool(const size_t threadCount)
+    {
+        const size_t workers = threadCount > 1 ? threadCount - 1 : 0;
+        m_workers.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            m_workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::ParallelFor(const size_t count, const size_t minChunkSize,
+                                 const std::function<void(size_t, size_t, size_t)>& body)
+    {
+        if (count == 0) return;
+        if (m_workers.empty() || count < minChunkSize * GetThreadCount()) {
+            body(0, count, 0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_body = &body;
+            m_count = count;
+            m_nextChunk = 0;
+            m_chunksLeft = GetThreadCount();
+            m_error = nullptr;
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        RunChunks();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_chunksLeft == 0; });
+        m_body = nullptr;
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        size_t seenGeneration = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+                if (m_stopping) return;
+                seenGeneration = m_generation;
+            }
+            RunChunks();
+        }
+    }
+
+    void ThreadPool::RunChunks()
+    {
+        const size_t chunkCount = GetThreadCount();
+        while (true) {
+            size_t chunk;
+            const std::function<void(size_t, size_t, size_t)>* body;
+            size_t count;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_body == nullptr || m_nextChunk == chunkCount) return;
+                chunk = m_nextChunk++;
+                body = m_body;
+                count = m_count;
+            }
+
+            // Chunk bounds depend only on count, never on which thread runs them
+            const size_t begin = count * chunk / chunkCount;
+            const size_t end = count * (chunk + 1) / chunkCount;
+            try {
+                (*body)(begin, end, chunk);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error) m_error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_chunksLeft == 0) {
+                m_done.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Molecular
+{
+    // Fixed set of worker threads for data-parallel loops.
+    //
+    // ParallelFor splits a range into GetThreadCount() contiguous chunks whose
+    // bounds depend only on the range size, so a loop that writes per-chunk
+    // results and merges them in chunk order gives the same answer on every run,
+    // whichever thread happened to take which chunk.
+    class ThreadPool
+    {
+    public:
+        // threadCount includes the calling thread, which also works during ParallelFor
+        explicit ThreadPool(size_t threadCount);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        [[nodiscard]] size_t GetThreadCount() const { return m_workers.size() + 1; }
+
+        // Runs body(begin, end, chunk) over [0, count) and blocks until every chunk
+        // is done. Ranges shorter than minChunkSize per thread run inline as chunk 0.
+        // The first exception thrown by a chunk is rethrown here.
+        void ParallelFor(size_t count, size_t minChunkSize,
+                         const std::function<void(size_t, size_t, size_t)>& body);
+
+    private:
+        void WorkerLoop();
+        void RunChunks();
+
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+
+        // Current job; guarded by m_mutex
+        const std::function<void(size_t, size_t, size_t)>* m_body = nullptr;
+        size_t m_count = 0;
+        size_t m_nextChunk = 0;
+        size_t m_chunksLeft = 0;
+        size_t m_generation = 0;
+        bool m_stopping = false;
+        std::exception_ptr m_error;
+    };
+}
@@ -0,0 +1,172 @@
+#include "TimeSeries.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Molecular
+{
+    TimeSeries::TimeSeries(const size_t capacity, const size_t channelCount)
+        : TimeSeries(capacity, std::vector<std::string>(channelCount))
+    {
+    }
+
+    TimeSeries::TimeSeries(const size_t capacity, std::vector<std::string> channelNames)
+        : m_capacity(capacity), m_names(std::move(channelNames)), m_values(m_names.size())
+    {
+        if (capacity == 0) {
+            throw std::invalid_argument("TimeSeries capacity must be positive");
+        }
+
+        // Levels down to blocks no larger than the capacity; each ring holds every
+        // block that can overlap the window
+        std::vector<MipLevel> levels;
+        for (unsigned shift = m_mipShift; (size_t{1} << shift) <= capacity; shift += m_mipShift) {
+            MipLevel level;
+            level.blockCapacity = (capacity >> shift) + 2;
+            levels.push_back(std::move(level));
+        }
+        m_mips.assign(m_values.size(), levels);
+    }
+
+    void TimeSeries::Append(const double time, const float* values)
+    {
+        for (size_t c = 0; c < m_values.size(); ++c) {
+            UpdateMips(c, values[c]);
+        }
+        ++m_appended;
+
+        if (!m_wrapped) {
+            m_times.push_back(time);
+            for (size_t c = 0; c < m_values.size(); ++c) {
+                m_values[c].push_back(values[c]);
+            }
+            if (++m_size < m_capacity) return;
+
+            // Full: mirror the samples into the second half and switch to ring mode
+            auto mirror = [this](auto& buffer) {
+                buffer.resize(2 * m_capacity);
+                std::copy(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(m_capacity),
+                          buffer.begin() + static_cast<std::ptrdiff_t>(m_capacity));
+            };
+            mirror(m_times);
+            for (auto& channel : m_values) {
+                mirror(channel);
+            }
+            m_next = 0;
+            m_wrapped = true;
+            return;
+        }
+
+        m_times[m_next] = m_times[m_next + m_capacity] = time;
+        for (size_t c = 0; c < m_values.size(); ++c) {
+            m_values[c][m_next] = m_values[c][m_next + m_capacity] = values[c];
+        }
+        m_next = (m_next + 1) % m_capacity;
+    }
+
+    void TimeSeries::Append(const double time, const std::initializer_list<float> values)
+    {
+        if (values.size() != m_values.size()) {
+            throw std::invalid_argument("TimeSeries::Append: expected " + std::to_string(m_values.size()) +
+                                        " values, got " + std::to_string(values.size()));
+        }
+        Append(time, values.begin());
+    }
+
+    void TimeSeries::Clear()
+    {
+        m_times.clear();
+        for (auto& channel : m_values) {
+            channel.clear();
+        }
+        m_size = 0;
+        m_next = 0;
+        m_wrapped = false;
+        m_appended = 0;     // Blocks restart at 0 and overwrite the old ones on first use
+    }
+
+    void TimeSeries::UpdateMips(const size_t channel, const float value)
+    {
+        unsigned shift = m_mipShift;
+        for (MipLevel& level : m_mips[channel]) {
+            const uint64_t block = m_appended >> shift;
+            const size_t slot = static_cast<size_t>(block % level.blockCapacity);
+            const bool startsBlock = (m_appended & ((uint64_t{1} << shift) - 1)) == 0;
+
+            if (slot == level.min.size()) {
+                // Rings grow with use, one block at a time
+                level.min.push_back(value);
+                level.max.push_back(value);
+                level.sum.push_back(value);
+                level.count.push_back(1);
+            } else if (startsBlock) {
+                level.min[slot] = level.max[slot] = value;
+                level.sum[slot] = value;
+                level.count[slot] = 1;
+            } else {
+                level.min[slot] = std::min(level.min[slot], value);
+                level.max[slot] = std::max(level.max[slot], value);
+                level.sum[slot] += value;
+                ++level.count[slot];
+            }
+            shift += m_mipShift;
+        }
+    }
+
+    void TimeSeries::Summarize(const size_t channel, size_t first, size_t count, size_t buckets, SeriesSummary& summary) const
+    {
+        first = std::min(first, m_size);
+        count = std::min(count, m_size - first);
+        buckets = std::min(buckets, count);
+        summary.min.resize(buckets);
+        summary.max.resize(buckets);
+        summary.mean.resize(buckets);
+        if (buckets == 0) return;
+
+        // Coarsest level whose blocks still fit inside one bucket
+        const size_t samplesPerBucket = count / buckets;
+        size_t levelIndex = 0;
+        while (levelIndex < m_mips[channel].size() &&
+               (size_t{1} << (m_mipShift * (levelIndex + 1))) <= samplesPerBucket) {
+            ++levelIndex;
+        }
+
+        const SeriesView<float> raw = GetChannel(channel);
+        const uint64_t windowStart = m_appended - m_size;   // Absolute index of sample 0
+
+        for (size_t b = 0; b < buckets; ++b) {
+            const size_t begin = first + count * b / buckets;
+            const size_t end = first + count * (b + 1) / buckets;
+
+            float minValue = raw[begin], maxValue = raw[begin];
+            double sum = 0.0;
+            uint64_t samples = 0;
+
+            if (levelIndex == 0) {
+                // Under four samples per bucket: read them directly
+                for (size_t k = begin; k < end; ++k) {
+                    minValue = std::min(minValue, raw[k]);
+                    maxValue = std::max(maxValue, raw[k]);
+                    sum += raw[k];
+                    ++samples;
+                }
+            } else {
+                const MipLevel& level = m_mips[channel][levelIndex - 1];
+                const unsigned shift = static_cast<unsigned>(m_mipShift * levelIndex);
+                const uint64_t firstBlock = (windowStart + begin) >> shift;
+                const uint64_t lastBlock = (windowStart + end - 1) >> shift;
+                for (uint64_t block = firstBlock; block <= lastBlock; ++block) {
+                    const size_t slot = static_cast<size_t>(block % level.blockCapacity);
+                    minValue = std::min(minValue, level.min[slot]);
+                    maxValue = std::max(maxValue, level.max[slot]);
+                    sum += level.sum[slot];
+                    samples += level.count[slot];
+                }
+            }
+
+            summary.min[b] = minValue;
+            summary.max[b] = maxValue;
+            summary.mean[b] = static_cast<float>(sum / static_cast<double>(samples));
+        }
+    }
+}
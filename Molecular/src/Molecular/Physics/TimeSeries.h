@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace Molecular
+{
+    // Read-only contiguous view of one series, oldest sample first
+    template<typename T>
+    class SeriesView
+    {
+    public:
+        SeriesView() = default;
+        SeriesView(const T* data, const size_t count) : m_data(data), m_count(count) {}
+
+        [[nodiscard]] const T* data() const { return m_data; }
+        [[nodiscard]] size_t size() const { return m_count; }
+        [[nodiscard]] bool empty() const { return m_count == 0; }
+        [[nodiscard]] const T* begin() const { return m_data; }
+        [[nodiscard]] const T* end() const { return m_data + m_count; }
+        [[nodiscard]] const T& operator[](const size_t k) const { return m_data[k]; }
+        [[nodiscard]] const T& front() const { return m_data[0]; }
+        [[nodiscard]] const T& back() const { return m_data[m_count - 1]; }
+
+        bool operator==(const SeriesView& other) const { return std::equal(begin(), end(), other.begin(), other.end()); }
+        bool operator!=(const SeriesView& other) const { return !(*this == other); }
+
+    private:
+        const T* m_data = nullptr;
+        size_t m_count = 0;
+    };
+
+    // Per-bucket statistics of a stretch of one channel, for plotting
+    struct SeriesSummary
+    {
+        std::vector<float> min;
+        std::vector<float> max;
+        std::vector<float> mean;
+    };
+
+    // Fixed-capacity time series: one time axis plus any number of value channels.
+    //
+    // Append is O(1); once full, the oldest sample is overwritten. Every sample is
+    // written twice in a buffer of twice the capacity (at k and k + capacity), so
+    // the live window is always one contiguous run that views, plots and CSV
+    // export can read directly. Storage grows with use and doubles only when the
+    // series first wraps.
+    //
+    // Each channel also keeps min/max/mean mip levels: level l summarises blocks
+    // of 4^l samples, updated on append in O(levels). Summarize reads the
+    // coarsest level that still resolves one output bucket, so a plot of any
+    // window costs O(buckets) however many samples it spans.
+    class TimeSeries
+    {
+    public:
+        TimeSeries(size_t capacity, size_t channelCount);
+        TimeSeries(size_t capacity, std::vector<std::string> channelNames);
+
+        // values must hold GetChannelCount() entries
+        void Append(double time, const float* values);
+        void Append(double time, std::initializer_list<float> values);
+        void Clear();
+
+        [[nodiscard]] size_t size() const { return m_size; }
+        [[nodiscard]] bool empty() const { return m_size == 0; }
+        [[nodiscard]] size_t GetCapacity() const { return m_capacity; }
+        [[nodiscard]] size_t GetChannelCount() const { return m_values.size(); }
+        [[nodiscard]] const std::string& GetChannelName(const size_t channel) const { return m_names[channel]; }
+
+        [[nodiscard]] SeriesView<double> GetTimes() const { return {m_times.data() + Start(), m_size}; }
+        [[nodiscard]] SeriesView<float> GetChannel(const size_t channel) const { return {m_values[channel].data() + Start(), m_size}; }
+
+        // Min/max/mean of samples [first, first + count) of the window (0 = oldest)
+        // in at most `buckets` equal buckets. Bucket edges snap to the mip blocks
+        // read, so a bucket may take in up to one block beyond its own range.
+        void Summarize(size_t channel, size_t first, size_t count, size_t buckets, SeriesSummary& summary) const;
+
+    private:
+        struct MipLevel
+        {
+            std::vector<float> min, max;
+            std::vector<double> sum;
+            std::vector<uint32_t> count;
+            size_t blockCapacity = 0;
+        };
+
+        static constexpr unsigned m_mipShift = 2;     // Each level is 4x coarser
+
+        [[nodiscard]] size_t Start() const { return m_wrapped ? m_next : 0; }
+        void UpdateMips(size_t channel, float value);
+
+        size_t m_capacity;
+        size_t m_size = 0;
+        size_t m_next = 0;          // Ring write position, once wrapped
+        bool m_wrapped = false;
+
+        std::vector<std::string> m_names;
+        std::vector<double> m_times;
+        std::vector<std::vector<float>> m_values;
+
+        // Samples appended since the last Clear; mip blocks are keyed by this count
+        uint64_t m_appended = 0;
+        std::vector<std::vector<MipLevel>> m_mips;      // [channel][level - 1]
+    };
+}
@@ -0,0 +1,70 @@
+#include "TrajectoryCodec.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace Molecular::TrajectoryCodec
+{
+    void Quantize(const double* values, const size_t count, const double precision, const int64_t* previous,
+                  int64_t* quantized, uint64_t* codes)
+    {
+        const double scale = 1.0 / precision;
+        for (size_t i = 0; i < count; ++i) {
+            quantized[i] = static_cast<int64_t>(std::floor(values[i] * scale + 0.5));
+        }
+
+        if (previous == nullptr) {
+            for (size_t i = 0; i < count; ++i) {
+                codes[i] = ZigZag(quantized[i]);
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                codes[i] = ZigZag(quantized[i] - previous[i]);
+            }
+        }
+    }
+
+    void Dequantize(const uint64_t* codes, const size_t count, const double precision, const bool keyFrame,
+                    int64_t* quantized, double* values)
+    {
+        // A key frame adds its codes to zero
+        const int64_t keep = keyFrame ? 0 : ~int64_t{0};
+        for (size_t i = 0; i < count; ++i) {
+            quantized[i] = (quantized[i] & keep) + UnZigZag(codes[i]);
+            values[i] = static_cast<double>(quantized[i]) * precision;
+        }
+    }
+
+    void EncodeVarints(const uint64_t* values, const size_t count, std::vector<uint8_t>& out)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t value = values[i];
+            while (value >= 0x80) {
+                out.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+    }
+
+    size_t DecodeVarints(const uint8_t* data, const size_t size, uint64_t* values, const size_t count)
+    {
+        size_t position = 0;
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t value = 0;
+            for (unsigned shift = 0;; shift += 7) {
+                if (position == size) {
+                    throw std::runtime_error("Trajectory data ends inside a varint");
+                }
+                if (shift > 63) {
+                    throw std::runtime_error("Trajectory varint longer than 64 bits");
+                }
+                const uint8_t byte = data[position++];
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) break;
+            }
+            values[i] = value;
+        }
+        return position;
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Molecular
+{
+    // Quantised delta coding for trajectory arrays, in the spirit of XTC.
+    //
+    // A value v becomes q = round(v / precision) (error at most precision / 2).
+    // Against a previous frame's q of the same atoms only q - q_prev is kept,
+    // zigzag-mapped so small negative steps stay small, then written as LEB128
+    // varints. Quantise and dequantise are flat branch-free loops over arrays
+    // that the compiler can vectorise; only the varint byte packing is serial.
+    namespace TrajectoryCodec
+    {
+        constexpr uint64_t ZigZag(const int64_t value)
+        {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+
+        constexpr int64_t UnZigZag(const uint64_t value)
+        {
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        // quantized[i] = round(values[i] / precision); codes[i] = zigzag of the
+        // change from previous[i] (or from 0 when previous is null)
+        void Quantize(const double* values, size_t count, double precision, const int64_t* previous,
+                      int64_t* quantized, uint64_t* codes);
+
+        // Inverse of Quantize: quantized holds the previous frame on entry (ignored
+        // when keyFrame) and this frame on return
+        void Dequantize(const uint64_t* codes, size_t count, double precision, bool keyFrame,
+                        int64_t* quantized, double* values);
+
+        void EncodeVarints(const uint64_t* values, size_t count, std::vector<uint8_t>& out);
+        // Reads count varints; returns the bytes consumed. Throws std::runtime_error
+        // if the data ends early or a varint is longer than 64 bits.
+        size_t DecodeVarints(const uint8_t* data, size_t size, uint64_t* values, size_t count);
+    }
+}
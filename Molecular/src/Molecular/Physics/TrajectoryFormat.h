@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Molecular
+{
+    // On-disk layout of a trajectory file (.moltraj), written in native byte
+    // order; byteOrderMark tells a reader whether that matches its own.
+    //
+    //   FileHeader
+    //   ElementRecord x elementCount
+    //   chunks: ChunkHeader, then up to framesPerChunk frames:
+    //     FrameHeader, x[n], y[n], (vx[n], vy[n]), ids[n], elements[n],
+    //     BondDelta x bondDeltaCount, zero padding to 8 bytes
+    //   or, for Quantized frames:
+    //     FrameHeader, (ids[n], elements[n], zero padding to 4 bytes if KeyFrame),
+    //     BondDelta x bondDeltaCount, TrajectoryCodec varints for x, y, (vx, vy),
+    //     zero padding to 8 bytes
+    //   FrameIndexEntry x frameCount
+    //   Footer
+    //
+    // Bonds are deltas against the previous frame, keyed by stable atom id; the
+    // first frame of each chunk lists every bond as formed. The index at the end gives the
+    // file offset of each FrameHeader for random access.
+    //
+    // Quantized files store round(v / precision) per value (error at most half
+    // the precision recorded in the header). A key frame codes those integers
+    // directly; any other frame codes the change from the previous frame, which
+    // holds the same atoms in the same order, and omits ids and elements. Every
+    // chunk starts with a key frame.
+    //
+    // Both rules keep chunks self-contained: a reader seeks to any frame by
+    // decoding forward from the start of its chunk.
+    namespace TrajectoryFormat
+    {
+        constexpr char FileMagic[8] = {'M', 'O', 'L', 'T', 'R', 'A', 'J', '\0'};
+        constexpr char FooterMagic[8] = {'M', 'O', 'L', 'T', 'I', 'D', 'X', '\0'};
+        constexpr uint32_t ChunkMagic = 0x4B4E4843;     // "CHNK"
+        constexpr uint32_t ByteOrderMark = 0x01020304;
+        constexpr uint32_t Version = 2;
+
+        // FileHeader::flags and FrameHeader::flags
+        constexpr uint32_t HasVelocities = 1u << 0;
+        constexpr uint32_t HasBonds = 1u << 1;
+        constexpr uint32_t Quantized = 1u << 2;
+        // FrameHeader::flags only
+        constexpr uint32_t KeyFrame = 1u << 3;
+
+        struct FileHeader
+        {
+            char magic[8];
+            uint32_t byteOrderMark;
+            uint32_t version;
+            uint32_t flags;
+            uint32_t framesPerChunk;
+            uint32_t elementCount;
+            uint32_t reserved;
+            double positionPrecision;   // Quantized only; the error bound is half of each
+            double velocityPrecision;
+        };
+
+        struct ElementRecord
+        {
+            char symbol[8];
+            double mass;
+            double vanDerWaalsRadius;
+            double bondLength;
+        };
+
+        struct ChunkHeader
+        {
+            uint32_t magic;
+            uint32_t frameCount;
+            uint64_t byteCount;     // Frames only, excluding this header
+        };
+
+        struct FrameHeader
+        {
+            uint64_t step;
+            double time;
+            uint32_t atomCount;
+            uint32_t bondDeltaCount;
+            uint32_t flags;
+            uint32_t byteCount;     // Payload after this header, padding included
+        };
+
+        struct BondDelta
+        {
+            uint32_t firstId;
+            uint32_t secondId;
+            uint32_t formed;        // 1 = formed, 0 = broken
+        };
+
+        struct FrameIndexEntry
+        {
+            uint64_t offset;        // Of the FrameHeader, from the start of the file
+            uint64_t step;
+            double time;
+        };
+
+        struct Footer
+        {
+            uint64_t indexOffset;
+            uint64_t frameCount;
+            char magic[8];
+        };
+
+        constexpr size_t PaddedSize(const size_t bytes) { return (bytes + 7) & ~size_t{7}; }
+    }
+}
@@ -0,0 +1,272 @@
+#include "TrajectoryReader.h"
+
+#include "TrajectoryCodec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Molecular
+{
+    namespace
+    {
+        template <typename T>
+        void CopyArray(std::vector<T>& out, const uint8_t* data, const size_t count)
+        {
+            out.resize(count);
+            std::memcpy(out.data(), data, count * sizeof(T));
+        }
+
+        [[noreturn]] void ThrowCorrupt(const char* what)
+        {
+            throw std::runtime_error(std::string("Corrupt trajectory file: ") + what);
+        }
+
+        void CopyElements(std::vector<ElementId>& out, const uint8_t* data, const size_t count)
+        {
+            for (size_t i = 0; i < count; ++i) {
+                if (data[i] >= ElementCount) {
+                    ThrowCorrupt("unknown element id");
+                }
+            }
+            CopyArray(out, data, count);
+        }
+    }
+
+    TrajectoryReader::TrajectoryReader(const std::string& path)
+        : m_file(path)
+    {
+        using namespace TrajectoryFormat;
+
+        const size_t size = m_file.size();
+        if (size < sizeof(FileHeader) + sizeof(Footer)) {
+            ThrowCorrupt("too short");
+        }
+        std::memcpy(&m_header, m_file.data(), sizeof(m_header));
+        if (std::memcmp(m_header.magic, FileMagic, sizeof(FileMagic)) != 0) {
+            throw std::runtime_error("'" + path + "' is not a trajectory file");
+        }
+        if (m_header.byteOrderMark != ByteOrderMark) {
+            throw std::runtime_error("'" + path + "' was written with a different byte order");
+        }
+        if (m_header.version != Version) {
+            throw std::runtime_error("'" + path + "' has unsupported trajectory version " + std::to_string(m_header.version));
+        }
+        if (m_header.framesPerChunk == 0) {
+            ThrowCorrupt("zero frames per chunk");
+        }
+
+        // Element ids in the frames index the writer's table; it must match ours
+        if (m_header.elementCount != ElementCount ||
+            sizeof(FileHeader) + ElementCount * sizeof(ElementRecord) > size) {
+            throw std::runtime_error("'" + path + "' was written with a different element table");
+        }
+        for (size_t e = 0; e < ElementCount; ++e) {
+            ElementRecord record{};
+            std::memcpy(&record, m_file.data() + sizeof(FileHeader) + e * sizeof(ElementRecord), sizeof(record));
+            if (std::string_view(record.symbol, strnlen(record.symbol, sizeof(record.symbol))) != elementTable[e].symbol) {
+                throw std::runtime_error("'" + path + "' was written with a different element table");
+            }
+        }
+
+        Footer footer{};
+        std::memcpy(&footer, m_file.data() + size - sizeof(Footer), sizeof(footer));
+        if (std::memcmp(footer.magic, FooterMagic, sizeof(FooterMagic)) != 0) {
+            ThrowCorrupt("no frame index (was the writer closed?)");
+        }
+        if (footer.indexOffset > size - sizeof(Footer) ||
+            footer.frameCount > (size - sizeof(Footer) - footer.indexOffset) / sizeof(FrameIndexEntry)) {
+            ThrowCorrupt("frame index out of range");
+        }
+        m_frameCount = static_cast<size_t>(footer.frameCount);
+        m_indexOffset = footer.indexOffset;
+    }
+
+    TrajectoryFormat::FrameIndexEntry TrajectoryReader::ReadIndex(const size_t frame) const
+    {
+        if (frame >= m_frameCount) {
+            throw std::out_of_range("Trajectory frame " + std::to_string(frame) + " out of range");
+        }
+        TrajectoryFormat::FrameIndexEntry entry{};
+        std::memcpy(&entry, m_file.data() + m_indexOffset + frame * sizeof(entry), sizeof(entry));
+        return entry;
+    }
+
+    size_t TrajectoryReader::FindFrame(const double time) const
+    {
+        // Binary search over the index; only the probed entries are paged in
+        size_t low = 0, high = m_frameCount;
+        while (low < high) {
+            const size_t middle = low + (high - low) / 2;
+            if (GetTime(middle) <= time) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low == 0 ? 0 : low - 1;
+    }
+
+    const TrajectoryFrame& TrajectoryReader::ReadFrame(const size_t frame)
+    {
+        if (frame >= m_frameCount) {
+            throw std::out_of_range("Trajectory frame " + std::to_string(frame) + " out of range");
+        }
+        if (frame == m_decodedFrame) {
+            return m_frame;
+        }
+
+        // Continue from the decoded frame when it is earlier in the same chunk,
+        // otherwise start over at the chunk's first frame
+        const size_t chunkStart = frame - frame % m_header.framesPerChunk;
+        size_t next = chunkStart;
+        if (m_decodedFrame != NoFrame && m_decodedFrame >= chunkStart && m_decodedFrame < frame) {
+            next = m_decodedFrame + 1;
+        }
+
+        m_decodedFrame = NoFrame;       // Until decoding succeeds
+        for (; next <= frame; ++next) {
+            DecodeFrame(next, next == chunkStart, IsQuantized() || next == frame);
+        }
+        BuildBondEdges();
+        m_decodedFrame = frame;
+        return m_frame;
+    }
+
+    void TrajectoryReader::DecodeFrame(const size_t frame, const bool chunkStart, const bool needValues)
+    {
+        using namespace TrajectoryFormat;
+
+        const FrameIndexEntry entry = ReadIndex(frame);
+        if (entry.offset > m_indexOffset || m_indexOffset - entry.offset < sizeof(FrameHeader)) {
+            ThrowCorrupt("frame offset out of range");
+        }
+        FrameHeader header{};
+        std::memcpy(&header, m_file.data() + entry.offset, sizeof(header));
+        if (header.byteCount > m_indexOffset - entry.offset - sizeof(FrameHeader)) {
+            ThrowCorrupt("frame runs past the index");
+        }
+
+        const uint8_t* const frameStart = m_file.data() + entry.offset;
+        const uint8_t* data = frameStart + sizeof(FrameHeader);
+        const uint8_t* const end = data + header.byteCount;
+        const size_t count = header.atomCount;
+        const bool velocities = (header.flags & TrajectoryFormat::HasVelocities) != 0;
+        auto take = [&data, end](const size_t bytes) {
+            if (static_cast<size_t>(end - data) < bytes) {
+                ThrowCorrupt("frame shorter than its contents");
+            }
+            const uint8_t* start = data;
+            data += bytes;
+            return start;
+        };
+
+        m_frame.step = header.step;
+        m_frame.time = header.time;
+        if (chunkStart) {
+            m_bondKeys.clear();
+        }
+
+        if ((header.flags & Quantized) == 0) {
+            const size_t arrayCount = velocities ? 4 : 2;
+            const uint8_t* values = take(arrayCount * count * sizeof(double));
+            const uint8_t* ids = take(count * sizeof(uint32_t));
+            const uint8_t* elements = take(count);
+            if (needValues) {
+                CopyArray(m_frame.x, values, count);
+                CopyArray(m_frame.y, values + count * sizeof(double), count);
+                if (velocities) {
+                    CopyArray(m_frame.vx, values + 2 * count * sizeof(double), count);
+                    CopyArray(m_frame.vy, values + 3 * count * sizeof(double), count);
+                } else {
+                    m_frame.vx.clear();
+                    m_frame.vy.clear();
+                }
+                CopyArray(m_frame.ids, ids, count);
+                CopyElements(m_frame.elements, elements, count);
+            }
+            ApplyBondDeltas(take(header.bondDeltaCount * sizeof(BondDelta)), header.bondDeltaCount);
+            return;
+        }
+
+        const bool keyFrame = (header.flags & KeyFrame) != 0;
+        if (keyFrame) {
+            CopyArray(m_frame.ids, take(count * sizeof(uint32_t)), count);
+            CopyElements(m_frame.elements, take(count), count);
+            take(static_cast<size_t>(-(data - frameStart)) & 3);
+        } else if (chunkStart || m_frame.ids.size() != count) {
+            ThrowCorrupt("delta frame without a matching key frame");
+        }
+        ApplyBondDeltas(take(header.bondDeltaCount * sizeof(BondDelta)), header.bondDeltaCount);
+
+        const size_t arrayCount = velocities ? 4 : 2;
+        m_codes.resize(arrayCount * count);
+        m_quantized.resize(arrayCount * count);
+        TrajectoryCodec::DecodeVarints(data, static_cast<size_t>(end - data), m_codes.data(), m_codes.size());
+
+        std::vector<double>* arrays[] = {&m_frame.x, &m_frame.y, &m_frame.vx, &m_frame.vy};
+        for (size_t a = 0; a < 4; ++a) {
+            if (a >= arrayCount) {
+                arrays[a]->clear();
+                continue;
+            }
+            arrays[a]->resize(count);
+            const double precision = a < 2 ? m_header.positionPrecision : m_header.velocityPrecision;
+            TrajectoryCodec::Dequantize(m_codes.data() + a * count, count, precision, keyFrame,
+                                        m_quantized.data() + a * count, arrays[a]->data());
+        }
+    }
+
+    void TrajectoryReader::ApplyBondDeltas(const uint8_t* data, const uint32_t count)
+    {
+        using TrajectoryFormat::BondDelta;
+
+        // The writer emits formed and broken bonds each in ascending key order
+        const size_t before = m_bondKeys.size();
+        m_brokenKeys.clear();
+        for (uint32_t k = 0; k < count; ++k) {
+            BondDelta delta{};
+            std::memcpy(&delta, data + k * sizeof(BondDelta), sizeof(delta));
+            const uint64_t key = (static_cast<uint64_t>(std::min(delta.firstId, delta.secondId)) << 32) |
+                                 std::max(delta.firstId, delta.secondId);
+            (delta.formed ? m_bondKeys : m_brokenKeys).push_back(key);
+        }
+
+        const auto middle = m_bondKeys.begin() + static_cast<std::ptrdiff_t>(before);
+        if (!std::is_sorted(middle, m_bondKeys.end())) {
+            std::sort(middle, m_bondKeys.end());
+        }
+        std::inplace_merge(m_bondKeys.begin(), middle, m_bondKeys.end());
+
+        if (!m_brokenKeys.empty()) {
+            std::sort(m_brokenKeys.begin(), m_brokenKeys.end());
+            m_bondKeys.erase(std::remove_if(m_bondKeys.begin(), m_bondKeys.end(), [this](const uint64_t key) {
+                return std::binary_search(m_brokenKeys.begin(), m_brokenKeys.end(), key);
+            }), m_bondKeys.end());
+        }
+    }
+
+    void TrajectoryReader::BuildBondEdges()
+    {
+        constexpr uint32_t Missing = std::numeric_limits<uint32_t>::max();
+
+        m_frame.bonds.clear();
+        if (m_bondKeys.empty()) return;
+
+        // Ids are slot numbers, so a flat id -> index table stays about N long
+        const uint32_t maxId = m_frame.ids.empty() ? 0 : *std::max_element(m_frame.ids.begin(), m_frame.ids.end());
+        m_indexOfId.assign(static_cast<size_t>(maxId) + 1, Missing);
+        for (size_t i = 0; i < m_frame.ids.size(); ++i) {
+            m_indexOfId[m_frame.ids[i]] = static_cast<uint32_t>(i);
+        }
+
+        for (const uint64_t key : m_bondKeys) {
+            const auto first = static_cast<uint32_t>(key >> 32);
+            const auto second = static_cast<uint32_t>(key);
+            if (first > maxId || second > maxId || m_indexOfId[first] == Missing || m_indexOfId[second] == Missing) {
+                ThrowCorrupt("bond between atoms not in the frame");
+            }
+            m_frame.bonds.push_back({m_indexOfId[first], m_indexOfId[second]});
+        }
+    }
+}
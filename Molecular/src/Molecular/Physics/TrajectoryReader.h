@@ -0,0 +1,75 @@
+#pragma once
+
+#include "AtomStore.h"
+#include "MappedFile.h"
+#include "TrajectoryFormat.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Molecular
+{
+    // One decoded trajectory frame; vx/vy are empty when the file has no velocities
+    struct TrajectoryFrame
+    {
+        uint64_t step = 0;
+        double time = 0.0;
+        std::vector<double> x, y, vx, vy;
+        std::vector<uint32_t> ids;
+        std::vector<ElementId> elements;
+        std::vector<BondEdge> bonds;    // Indices into this frame's arrays
+    };
+
+    // Reads a TrajectoryFormat file through a memory mapping.
+    //
+    // Opening reads only the header and footer; step and time of any frame come
+    // straight from the trailing index. ReadFrame decodes lazily: the next frame
+    // after the last one read costs one frame, any other costs at most one chunk
+    // of frames. Memory stays at one frame's worth whatever the file size.
+    class TrajectoryReader
+    {
+    public:
+        // Throws std::runtime_error if the file is missing, truncated or not a trajectory
+        explicit TrajectoryReader(const std::string& path);
+
+        [[nodiscard]] size_t GetFrameCount() const { return m_frameCount; }
+        [[nodiscard]] uint64_t GetStep(size_t frame) const { return ReadIndex(frame).step; }
+        [[nodiscard]] double GetTime(size_t frame) const { return ReadIndex(frame).time; }
+        // Last frame at or before `time` (0 if the trajectory starts later)
+        [[nodiscard]] size_t FindFrame(double time) const;
+
+        [[nodiscard]] bool HasVelocities() const { return (m_header.flags & TrajectoryFormat::HasVelocities) != 0; }
+        [[nodiscard]] bool IsQuantized() const { return (m_header.flags & TrajectoryFormat::Quantized) != 0; }
+        [[nodiscard]] double GetPositionPrecision() const { return m_header.positionPrecision; }
+
+        // The reference stays valid until the next ReadFrame. Throws std::out_of_range
+        // for a bad frame number and std::runtime_error for corrupt data.
+        const TrajectoryFrame& ReadFrame(size_t frame);
+
+    private:
+        static constexpr size_t NoFrame = std::numeric_limits<size_t>::max();
+
+        [[nodiscard]] TrajectoryFormat::FrameIndexEntry ReadIndex(size_t frame) const;
+        // Applies one frame on top of the decoded state; positions are skipped
+        // for raw frames that are only passed through on the way to a seek target
+        void DecodeFrame(size_t frame, bool chunkStart, bool needValues);
+        void ApplyBondDeltas(const uint8_t* data, uint32_t count);
+        void BuildBondEdges();
+
+        MappedFile m_file;
+        TrajectoryFormat::FileHeader m_header{};
+        size_t m_frameCount = 0;
+        uint64_t m_indexOffset = 0;
+
+        TrajectoryFrame m_frame;
+        size_t m_decodedFrame = NoFrame;
+
+        std::vector<int64_t> m_quantized;
+        std::vector<uint64_t> m_codes;
+        std::vector<uint64_t> m_bondKeys;           // Sorted (smaller id << 32 | larger id)
+        std::vector<uint64_t> m_brokenKeys;
+        std::vector<uint32_t> m_indexOfId;
+    };
+}
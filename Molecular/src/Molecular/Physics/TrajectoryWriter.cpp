@@ -0,0 +1,291 @@
+#include "TrajectoryWriter.h"
+
+#include "TrajectoryCodec.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace Molecular
+{
+    namespace
+    {
+        template <typename T>
+        void AppendBytes(std::vector<uint8_t>& buffer, const T* data, const size_t count)
+        {
+            const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+            buffer.insert(buffer.end(), bytes, bytes + count * sizeof(T));
+        }
+
+        uint64_t BondKey(const uint32_t a, const uint32_t b)
+        {
+            return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+        }
+    }
+
+    TrajectoryWriter::~TrajectoryWriter()
+    {
+        try {
+            Close();
+        } catch (...) {
+            // Nowhere to report a failure from a destructor; Close explicitly to see it
+        }
+    }
+
+    void TrajectoryWriter::Open(const std::string& path, const TrajectorySettings& settings)
+    {
+        using namespace TrajectoryFormat;
+
+        if (settings.interval <= 0 || settings.framesPerChunk == 0) {
+            throw std::invalid_argument("Trajectory interval and chunk size must be positive");
+        }
+        if (settings.positionPrecision < 0.0 ||
+            (settings.positionPrecision > 0.0 && settings.writeVelocities && settings.velocityPrecision <= 0.0)) {
+            throw std::invalid_argument("Trajectory precision must be positive (0 = raw positions)");
+        }
+        Close();
+
+        m_file.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open()) {
+            throw std::runtime_error("Could not create trajectory file '" + path + "'");
+        }
+        m_open = true;
+        m_settings = settings;
+        m_index.clear();
+        m_writtenBonds.clear();
+        m_previousIds.clear();
+        m_error = nullptr;
+        m_stopping = false;
+        m_hasPending = false;
+
+        FileHeader header{};
+        std::memcpy(header.magic, FileMagic, sizeof(header.magic));
+        header.byteOrderMark = ByteOrderMark;
+        header.version = Version;
+        header.flags = (settings.writeVelocities ? HasVelocities : 0u) | (settings.writeBonds ? HasBonds : 0u) |
+                       (settings.positionPrecision > 0.0 ? Quantized : 0u);
+        header.framesPerChunk = settings.framesPerChunk;
+        header.elementCount = static_cast<uint32_t>(ElementCount);
+        if (settings.positionPrecision > 0.0) {
+            header.positionPrecision = settings.positionPrecision;
+            header.velocityPrecision = settings.writeVelocities ? settings.velocityPrecision : 0.0;
+        }
+
+        std::vector<uint8_t> preamble;
+        AppendBytes(preamble, &header, 1);
+        for (const AtomProperties& properties : elementTable) {
+            ElementRecord record{};
+            std::memcpy(record.symbol, properties.symbol.data(), std::min(properties.symbol.size(), sizeof(record.symbol) - 1));
+            record.mass = properties.mass;
+            record.vanDerWaalsRadius = properties.vanDerWaalsRadius;
+            record.bondLength = properties.bondLength;
+            AppendBytes(preamble, &record, 1);
+        }
+        m_file.write(reinterpret_cast<const char*>(preamble.data()), static_cast<std::streamsize>(preamble.size()));
+        m_fileOffset = preamble.size();
+
+        BeginChunk();
+        m_ioThread = std::thread([this] { IoLoop(); });
+    }
+
+    void TrajectoryWriter::WriteFrame(const AtomStore& atoms, const uint64_t step, const double time)
+    {
+        using namespace TrajectoryFormat;
+
+        if (!IsOpen()) return;
+        RethrowIoError();
+
+        const size_t count = atoms.size();
+        m_bondDeltas.clear();
+        if (m_framesInChunk == 0) {
+            m_writtenBonds.clear();     // Each chunk restates its bonds in full
+        }
+        if (m_settings.writeBonds) {
+            CollectBondDeltas(atoms);
+        }
+
+        // Deltas need the same atoms in the same order as the previous frame
+        const bool quantized = m_settings.positionPrecision > 0.0;
+        const bool keyFrame = quantized &&
+            (m_framesInChunk == 0 || m_previousIds.size() != count ||
+             !std::equal(m_previousIds.begin(), m_previousIds.end(), atoms.GetIds()));
+
+        FrameHeader header{};
+        header.step = step;
+        header.time = time;
+        header.atomCount = static_cast<uint32_t>(count);
+        header.bondDeltaCount = static_cast<uint32_t>(m_bondDeltas.size());
+        header.flags = (m_settings.writeVelocities ? HasVelocities : 0u) | (m_settings.writeBonds ? HasBonds : 0u) |
+                       (quantized ? Quantized : 0u) | (keyFrame ? KeyFrame : 0u);
+
+        const size_t frameStart = m_filling.size();
+        m_index.push_back({m_fileOffset + frameStart, step, time});
+
+        AppendBytes(m_filling, &header, 1);
+        if (quantized) {
+            AppendQuantized(atoms, keyFrame);
+        } else {
+            AppendBytes(m_filling, atoms.GetX(), count);
+            AppendBytes(m_filling, atoms.GetY(), count);
+            if (m_settings.writeVelocities) {
+                AppendBytes(m_filling, atoms.GetVX(), count);
+                AppendBytes(m_filling, atoms.GetVY(), count);
+            }
+            AppendBytes(m_filling, atoms.GetIds(), count);
+            AppendBytes(m_filling, atoms.GetElementIds(), count);
+            AppendBytes(m_filling, m_bondDeltas.data(), m_bondDeltas.size());
+        }
+        m_filling.resize(frameStart + PaddedSize(m_filling.size() - frameStart), 0);
+
+        // Patch in the payload size now that it is known
+        const auto byteCount = static_cast<uint32_t>(m_filling.size() - frameStart - sizeof(FrameHeader));
+        std::memcpy(m_filling.data() + frameStart + offsetof(FrameHeader, byteCount), &byteCount, sizeof(byteCount));
+
+        if (++m_framesInChunk == m_settings.framesPerChunk) {
+            SubmitChunk();
+        }
+    }
+
+    void TrajectoryWriter::Close()
+    {
+        using namespace TrajectoryFormat;
+
+        if (!IsOpen()) return;
+
+        if (m_framesInChunk > 0) {
+            SubmitChunk();
+        }
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_written.wait(lock, [this] { return !m_hasPending; });
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        m_ioThread.join();
+
+        // The I/O thread is gone; the index and footer go out from here
+        const uint64_t indexOffset = m_fileOffset;
+        m_file.write(reinterpret_cast<const char*>(m_index.data()),
+                     static_cast<std::streamsize>(m_index.size() * sizeof(FrameIndexEntry)));
+        Footer footer{indexOffset, m_index.size(), {}};
+        std::memcpy(footer.magic, FooterMagic, sizeof(footer.magic));
+        m_file.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+        m_file.close();
+        m_open = false;
+
+        const bool failed = m_file.fail();
+        m_file.clear();
+        RethrowIoError();
+        if (failed) {
+            throw std::runtime_error("Failed to finish the trajectory file");
+        }
+    }
+
+    void TrajectoryWriter::AppendQuantized(const AtomStore& atoms, const bool keyFrame)
+    {
+        const size_t count = atoms.size();
+        if (keyFrame) {
+            AppendBytes(m_filling, atoms.GetIds(), count);
+            AppendBytes(m_filling, atoms.GetElementIds(), count);
+            m_filling.resize((m_filling.size() + 3) & ~size_t{3}, 0);
+            m_previousIds.assign(atoms.GetIds(), atoms.GetIds() + count);
+        }
+        AppendBytes(m_filling, m_bondDeltas.data(), m_bondDeltas.size());
+
+        const double* arrays[] = {atoms.GetX(), atoms.GetY(), atoms.GetVX(), atoms.GetVY()};
+        const size_t arrayCount = m_settings.writeVelocities ? 4 : 2;
+        m_quantized.resize(arrayCount * count);
+        m_codes.resize(arrayCount * count);
+        for (size_t a = 0; a < arrayCount; ++a) {
+            const double precision = a < 2 ? m_settings.positionPrecision : m_settings.velocityPrecision;
+            TrajectoryCodec::Quantize(arrays[a], count, precision,
+                                      keyFrame ? nullptr : m_previousQuantized.data() + a * count,
+                                      m_quantized.data() + a * count, m_codes.data() + a * count);
+        }
+        TrajectoryCodec::EncodeVarints(m_codes.data(), m_codes.size(), m_filling);
+        m_previousQuantized.swap(m_quantized);
+    }
+
+    void TrajectoryWriter::BeginChunk()
+    {
+        m_filling.clear();
+        m_filling.resize(sizeof(TrajectoryFormat::ChunkHeader), 0);
+        m_framesInChunk = 0;
+    }
+
+    void TrajectoryWriter::SubmitChunk()
+    {
+        using namespace TrajectoryFormat;
+
+        const ChunkHeader header{ChunkMagic, m_framesInChunk, m_filling.size() - sizeof(ChunkHeader)};
+        std::memcpy(m_filling.data(), &header, sizeof(header));
+        m_fileOffset += m_filling.size();
+
+        {
+            // Only blocks if the previous chunk is still being written
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_written.wait(lock, [this] { return !m_hasPending; });
+            m_pending.swap(m_filling);
+            m_hasPending = true;
+        }
+        m_wake.notify_one();
+        BeginChunk();
+    }
+
+    void TrajectoryWriter::IoLoop()
+    {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stopping || m_hasPending; });
+                if (!m_hasPending) return;
+            }
+
+            // m_pending is ours until m_hasPending is cleared
+            m_file.write(reinterpret_cast<const char*>(m_pending.data()), static_cast<std::streamsize>(m_pending.size()));
+            const bool failed = m_file.fail();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (failed && !m_error) {
+                    m_error = std::make_exception_ptr(std::runtime_error("Failed to write trajectory chunk"));
+                }
+                m_hasPending = false;
+            }
+            m_written.notify_all();
+        }
+    }
+
+    void TrajectoryWriter::RethrowIoError()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_error) {
+            std::exception_ptr error = m_error;
+            m_error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    void TrajectoryWriter::CollectBondDeltas(const AtomStore& atoms)
+    {
+        m_currentBonds.clear();
+        for (const BondEdge& edge : atoms.GetBondEdges()) {
+            m_currentBonds.push_back(BondKey(atoms.GetId(edge.first), atoms.GetId(edge.second)));
+        }
+        std::sort(m_currentBonds.begin(), m_currentBonds.end());
+
+        auto addDeltas = [this](const std::vector<uint64_t>& from, const std::vector<uint64_t>& minus, const uint32_t formed) {
+            auto it = minus.begin();
+            for (const uint64_t key : from) {
+                while (it != minus.end() && *it < key) ++it;
+                if (it == minus.end() || *it != key) {
+                    m_bondDeltas.push_back({static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key), formed});
+                }
+            }
+        };
+        addDeltas(m_currentBonds, m_writtenBonds, 1);
+        addDeltas(m_writtenBonds, m_currentBonds, 0);
+        m_writtenBonds.swap(m_currentBonds);
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "AtomStore.h"
+#include "TrajectoryFormat.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Molecular
+{
+    struct TrajectorySettings
+    {
+        int interval = 10;              // Steps between frames
+        uint32_t framesPerChunk = 64;
+        bool writeVelocities = true;
+        bool writeBonds = true;
+        // Quantise to this precision (nm) with inter-frame deltas; 0 writes raw doubles
+        double positionPrecision = 0.0;
+        double velocityPrecision = 1e-3;
+    };
+
+    // Streams frames into a TrajectoryFormat file.
+    //
+    // WriteFrame only serialises into the chunk being filled; a full chunk is
+    // swapped with the one the I/O thread is writing, so the caller waits only
+    // if the disk falls a whole chunk behind. Close writes the last chunk, the
+    // frame index and the footer. Write errors surface from WriteFrame / Close.
+    class TrajectoryWriter
+    {
+    public:
+        TrajectoryWriter() = default;
+        ~TrajectoryWriter();
+
+        TrajectoryWriter(const TrajectoryWriter&) = delete;
+        TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+        // Throws std::runtime_error if the file cannot be created
+        void Open(const std::string& path, const TrajectorySettings& settings = {});
+        void WriteFrame(const AtomStore& atoms, uint64_t step, double time);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const { return m_open; }
+        [[nodiscard]] uint64_t GetFrameCount() const { return m_index.size(); }
+        [[nodiscard]] const TrajectorySettings& GetSettings() const { return m_settings; }
+
+    private:
+        void BeginChunk();
+        void SubmitChunk();
+        void IoLoop();
+        void RethrowIoError();
+        void CollectBondDeltas(const AtomStore& atoms);
+        void AppendQuantized(const AtomStore& atoms, bool keyFrame);
+
+        TrajectorySettings m_settings;
+        std::ofstream m_file;           // Only the I/O thread touches it while open
+        bool m_open = false;
+        uint64_t m_fileOffset = 0;          // Where m_filling will land in the file
+        uint32_t m_framesInChunk = 0;
+        std::vector<uint8_t> m_filling;
+        std::vector<TrajectoryFormat::FrameIndexEntry> m_index;
+
+        // Bonds written so far as (smaller id << 32 | larger id), sorted
+        std::vector<uint64_t> m_writtenBonds;
+        std::vector<uint64_t> m_currentBonds;
+        std::vector<TrajectoryFormat::BondDelta> m_bondDeltas;
+
+        // Quantised state of the previous frame, per array, and the atoms it held
+        std::vector<int64_t> m_previousQuantized;
+        std::vector<int64_t> m_quantized;
+        std::vector<uint64_t> m_codes;
+        std::vector<uint32_t> m_previousIds;
+
+        std::thread m_ioThread;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_written;
+
+        // Guarded by m_mutex
+        std::vector<uint8_t> m_pending;
+        bool m_hasPending = false;
+        bool m_stopping = false;
+        std::exception_ptr m_error;
+    };
+}
@@ -0,0 +1,124 @@
+// Headless batch runner: loads a scenario (see Molecular/Physics/Scenario.h),
+// steps it as fast as the machine allows and writes the outputs it asks for.
+//
+//   MolecularBatch <scenario> [--steps N] [--threads N] [--quiet]
+
+#include "Molecular/Physics/Scenario.h"
+#include "Molecular/Physics/SimulationSpace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+
+namespace
+{
+    struct Options
+    {
+        std::string scenarioPath;
+        long long steps = -1;       // Overrides the scenario when >= 0
+        long long threads = -1;
+        bool quiet = false;
+    };
+
+    void PrintUsage()
+    {
+        std::fprintf(stderr, "Usage: MolecularBatch <scenario> [--steps N] [--threads N] [--quiet]\n");
+    }
+
+    bool ParseOptions(const int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i) {
+            const char* argument = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argument, "--steps") == 0 && hasValue) {
+                options.steps = std::atoll(argv[++i]);
+            } else if (std::strcmp(argument, "--threads") == 0 && hasValue) {
+                options.threads = std::atoll(argv[++i]);
+            } else if (std::strcmp(argument, "--quiet") == 0) {
+                options.quiet = true;
+            } else if (argument[0] != '-' && options.scenarioPath.empty()) {
+                options.scenarioPath = argument;
+            } else {
+                return false;
+            }
+        }
+        return !options.scenarioPath.empty() && options.steps >= -1 && options.threads >= -1;
+    }
+
+    int Run(const Options& options)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        Molecular::Scenario scenario = Molecular::LoadScenario(options.scenarioPath);
+        if (options.steps >= 0) {
+            scenario.steps = static_cast<uint64_t>(options.steps);
+        }
+        if (options.threads >= 0) {
+            scenario.threads = static_cast<size_t>(options.threads);
+        }
+
+        Molecular::SimulationSpace space;
+        Molecular::ApplyScenario(scenario, space);
+        const size_t atomCount = space.GetObjects().size();
+        std::printf("%s: %zu atoms, %llu steps of %g s on %zu threads\n", options.scenarioPath.c_str(), atomCount,
+                    static_cast<unsigned long long>(scenario.steps), space.GetFixedTimeStep(), space.GetThreadCount());
+
+        // The space runs at its fixed step; the frame time is ignored
+        const Molecular::Timestep frame(static_cast<float>(space.GetFixedTimeStep()));
+        const uint64_t reportInterval = scenario.steps >= 10 ? scenario.steps / 10 : 1;
+
+        space.StartSimulation();
+        const Clock::time_point start = Clock::now();
+        for (uint64_t step = 1; step <= scenario.steps; ++step) {
+            space.Update(frame, scenario.box);
+
+            if (!options.quiet && step % reportInterval == 0) {
+                const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                std::printf("  step %llu/%llu  %.1f s  E = %.6g  kT = %.6g  bonds = %d\n",
+                            static_cast<unsigned long long>(step), static_cast<unsigned long long>(scenario.steps),
+                            seconds, space.CalculateTotalEnergy(), space.CalculateTemperature(), space.GetTotalBondCount());
+            }
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        space.StopSimulation();
+
+        // Outputs: the trajectory's index goes down first, then the end state
+        space.StopTrajectory();
+        if (!scenario.checkpointPath.empty()) {
+            space.SaveCheckpoint(scenario.checkpointPath);
+        }
+        if (!scenario.observablesPath.empty()) {
+            space.ExportEnergyDataToCSV(scenario.observablesPath);
+        }
+        if (!scenario.hashLogPath.empty()) {
+            Molecular::WriteStateHashLog(scenario.hashLogPath, space.GetStateHashes());
+        }
+
+        const auto steps = static_cast<double>(scenario.steps);
+        const double stepsPerSecond = seconds > 0.0 ? steps / seconds : 0.0;
+        const double atomSteps = steps * static_cast<double>(atomCount);
+        const double nanosecondsPerAtomStep = atomSteps > 0.0 ? seconds * 1e9 / atomSteps : 0.0;
+        std::printf("%llu steps in %.3f s: %.1f steps/s, %.2f ns/atom-step\n",
+                    static_cast<unsigned long long>(scenario.steps), seconds, stepsPerSecond, nanosecondsPerAtomStep);
+        return EXIT_SUCCESS;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    try {
+        return Run(options);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "MolecularBatch: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
@@ -1,20 +1,24 @@
 #include "Sandbox2D.h"
 
 #include "imgui.h"
+#include <algorithm>
+#include <cmath>
 #include <random>
+#include <stdexcept>
+#include <thread>
 
 Sandbox2D::Sandbox2D()
     : Layer("Sandbox2D"), m_rng(std::random_device{}()),
       m_positionDistribution(-m_boundingBoxSize + 0.2f, m_boundingBoxSize - 0.2f),
       m_cameraController(1920.0f/1080.0f, true)
 {
-    for (const auto& element : m_availableElements) {
-        m_atomCounts[element] = 0;
-    }
 }
 
 void Sandbox2D::OnAttach()
 {
+    m_simulationSpace.SetThreadCount(std::max(1u, std::thread::hardware_concurrency()));
+    m_simulationSpace.SetSnapshotInterval(m_snapshotSteps);
+    m_simulationSpace.SetSnapshotCapacity(m_snapshotCapacity);
     UpdateAtomCounts();
 }
 
@@ -26,27 +30,41 @@ void Sandbox2D::OnUpdate(Molecular::Timestep ts)
 {
     m_cameraController.OnUpdate(ts);
 
-    Molecular::BoundingBox box = {glm::vec2(-m_boundingBoxSize, -m_boundingBoxSize), glm::vec2(m_boundingBoxSize, m_boundingBoxSize)};
-    glm::vec2 minPoint = box.GetMinPoint();
-    glm::vec2 maxPoint = box.GetMaxPoint();
-    glm::vec4 color = {1.0f,1.0f,1.0f,1.0f};
+    // Playback replaces the live simulation until it is closed
+    if (m_playback) {
+        RenderPlayback(ts);
+        return;
+    }
+
+    Molecular::BoundingBox box = GetBoundingBox();
     float sum = 0.0f;
     float numberOfAtoms = 0.0f;
-    float averageRadius = 0.12f;
 
     m_simulationSpace.Update(ts,box);
-    m_simulationSpace.UpdateBonds();
+
+    // Keep the most recent bond events for the control panel
+    for (const auto& event : m_simulationSpace.ConsumeBondEvents()) {
+        m_recentBondEvents.push_back(event);
+    }
+    if (m_recentBondEvents.size() > m_maxRecentBondEvents) {
+        m_recentBondEvents.erase(m_recentBondEvents.begin(),
+                                 m_recentBondEvents.end() - static_cast<std::ptrdiff_t>(m_maxRecentBondEvents));
+    }
 
     Molecular::RenderCommand::SetClearColor({ 0.15f, 0.15f, 0.15f, 1.0f });
     Molecular::RenderCommand::Clear();
     Molecular::Renderer2D::BeginScene(m_cameraController.GetCamera());
 
-    Molecular::Renderer2D::DrawQuad({abs(maxPoint.x) - abs(minPoint.x) ,maxPoint.y + averageRadius},{abs(maxPoint.x) + abs(minPoint.x) + (2 * averageRadius),0.05f},color);//top
-    Molecular::Renderer2D::DrawQuad({abs(maxPoint.x) - abs(minPoint.x) ,minPoint.y - averageRadius},{abs(maxPoint.x) + abs(minPoint.x) + (2 * averageRadius),0.05f},color);//bottom
-    Molecular::Renderer2D::DrawQuad({maxPoint.x + averageRadius,abs(maxPoint.y) - abs(minPoint.y)},{0.05f,abs(maxPoint.y) + abs(minPoint.y) + (2 * averageRadius)},color);//right
-    Molecular::Renderer2D::DrawQuad({minPoint.x - averageRadius,abs(maxPoint.y) - abs(minPoint.y)},{0.05f,abs(maxPoint.y) + abs(minPoint.y) + (2 * averageRadius)},color);//left
+    DrawBoundary(box);
 
-    for (const Molecular::Atom& atom : m_simulationSpace.GetObjects())
+    // Bonds first, so the atoms are drawn over their ends
+    const auto& atoms = m_simulationSpace.GetObjects();
+    for (const Molecular::BondEdge& bond : m_simulationSpace.GetBondEdges())
+    {
+        DrawBond(glm::vec2(atoms.GetPosition(bond.first)), glm::vec2(atoms.GetPosition(bond.second)));
+    }
+
+    for (const auto atom : atoms)
     {
         Molecular::Renderer2D::DrawCircle(atom.GetPosition(),atom.GetVanDerWaalsRadius(),atom.GetColor());
 
@@ -58,6 +76,83 @@ void Sandbox2D::OnUpdate(Molecular::Timestep ts)
 
 }
 
+void Sandbox2D::DrawBoundary(const Molecular::BoundingBox& box)
+{
+    const glm::vec2 minPoint = box.GetMinPoint();
+    const glm::vec2 maxPoint = box.GetMaxPoint();
+    const glm::vec4 color = {1.0f,1.0f,1.0f,1.0f};
+    const float averageRadius = 0.12f;
+
+    Molecular::Renderer2D::DrawQuad({abs(maxPoint.x) - abs(minPoint.x) ,maxPoint.y + averageRadius},{abs(maxPoint.x) + abs(minPoint.x) + (2 * averageRadius),0.05f},color);//top
+    Molecular::Renderer2D::DrawQuad({abs(maxPoint.x) - abs(minPoint.x) ,minPoint.y - averageRadius},{abs(maxPoint.x) + abs(minPoint.x) + (2 * averageRadius),0.05f},color);//bottom
+    Molecular::Renderer2D::DrawQuad({maxPoint.x + averageRadius,abs(maxPoint.y) - abs(minPoint.y)},{0.05f,abs(maxPoint.y) + abs(minPoint.y) + (2 * averageRadius)},color);//right
+    Molecular::Renderer2D::DrawQuad({minPoint.x - averageRadius,abs(maxPoint.y) - abs(minPoint.y)},{0.05f,abs(maxPoint.y) + abs(minPoint.y) + (2 * averageRadius)},color);//left
+}
+
+void Sandbox2D::DrawBond(const glm::vec2& from, const glm::vec2& to)
+{
+    const glm::vec4 bondColor = {0.8f, 0.8f, 0.8f, 1.0f};
+    const glm::vec2 delta = to - from;
+    Molecular::Renderer2D::DrawRotatedQuad((from + to) * 0.5f, {glm::length(delta), 0.02f},
+                                           std::atan2(delta.y, delta.x), bondColor);
+}
+
+void Sandbox2D::RenderPlayback(Molecular::Timestep ts)
+{
+    // Advance at the chosen speed, wrapping at either end; only the frame shown is decoded
+    const auto frameCount = static_cast<double>(m_playback->GetFrameCount());
+    if (m_playbackPlaying) {
+        m_playbackPosition += static_cast<double>(m_playbackSpeed) * static_cast<double>(ts.GetSeconds());
+        m_playbackPosition = std::fmod(m_playbackPosition, frameCount);
+        if (m_playbackPosition < 0.0) m_playbackPosition += frameCount;
+    }
+    const auto frameIndex = std::min(static_cast<size_t>(m_playbackPosition), m_playback->GetFrameCount() - 1);
+
+    // Only the header and index were checked on open; a damaged frame ends playback
+    const Molecular::TrajectoryFrame* frame = nullptr;
+    try {
+        frame = &m_playback->ReadFrame(frameIndex);
+    } catch (const std::runtime_error& e) {
+        MOL_ERROR("Playback: {}", e.what());
+        m_playback.reset();
+        return;
+    }
+
+    Molecular::RenderCommand::SetClearColor({ 0.15f, 0.15f, 0.15f, 1.0f });
+    Molecular::RenderCommand::Clear();
+    Molecular::Renderer2D::BeginScene(m_cameraController.GetCamera());
+
+    DrawBoundary(GetBoundingBox());
+    for (const Molecular::BondEdge& bond : frame->bonds)
+    {
+        DrawBond({frame->x[bond.first], frame->y[bond.first]}, {frame->x[bond.second], frame->y[bond.second]});
+    }
+    for (size_t i = 0; i < frame->x.size(); ++i)
+    {
+        const auto& properties = Molecular::GetElementProperties(frame->elements[i]);
+        Molecular::Renderer2D::DrawCircle({frame->x[i], frame->y[i]}, static_cast<float>(properties.vanDerWaalsRadius),
+                                          properties.color);
+    }
+
+    Molecular::Renderer2D::EndScene();
+}
+
+void Sandbox2D::OpenPlayback(const std::string& path)
+{
+    try {
+        m_simulationSpace.StopSimulation();
+        m_playback = std::make_unique<Molecular::TrajectoryReader>(path);
+        m_playbackPosition = 0.0;
+        m_playbackPlaying = true;
+        if (m_playback->GetFrameCount() == 0) {
+            m_playback.reset();
+        }
+    } catch (const std::exception& e) {
+        MOL_ERROR("Playback: {}", e.what());
+        m_playback.reset();
+    }
+}
+
 void Sandbox2D::OnImGuiRender()
 {
     ImGui::Begin("Simulation Controls");
@@ -112,6 +207,73 @@ void Sandbox2D::OnImGuiRender()
 
     ImGui::Spacing();
 
+    // Energy minimization of the starting configuration
+    if (isRunning) {
+        ImGui::BeginDisabled();
+    }
+
+    int minimizerMethod = static_cast<int>(m_minimizerSettings.method);
+    ImGui::RadioButton("FIRE", &minimizerMethod, static_cast<int>(Molecular::MinimizerMethod::FIRE));
+    ImGui::SameLine();
+    ImGui::RadioButton("Conjugate Gradient", &minimizerMethod, static_cast<int>(Molecular::MinimizerMethod::ConjugateGradient));
+    m_minimizerSettings.method = static_cast<Molecular::MinimizerMethod>(minimizerMethod);
+
+    auto forceTolerance = static_cast<float>(m_minimizerSettings.forceTolerance);
+    if (ImGui::SliderFloat("Force Tolerance", &forceTolerance, 1e-5f, 1.0f, "%.5f", ImGuiSliderFlags_Logarithmic)) {
+        m_minimizerSettings.forceTolerance = static_cast<double>(forceTolerance);
+    }
+
+    if (ImGui::Button("Minimize Energy", ImVec2(150, 30))) {
+        MinimizeEnergy();
+    }
+
+    if (isRunning) {
+        ImGui::EndDisabled();
+    }
+
+    if (m_hasMinimized) {
+        ImGui::Text("%s after %d iterations (max |F| = %.2e)",
+                    m_lastMinimization.converged ? "Converged" : "Stopped",
+                    m_lastMinimization.iterations, m_lastMinimization.maxForce);
+    }
+
+    ImGui::Spacing();
+
+    // Rewind through the snapshot ring (one snapshot every m_snapshotSteps steps)
+    const Molecular::SnapshotRing& snapshots = m_simulationSpace.GetSnapshots();
+    ImGui::Text("Snapshots: %zu / %zu", snapshots.size(), snapshots.GetCapacity());
+    if (snapshots.empty()) {
+        ImGui::BeginDisabled();
+    }
+    if (ImGui::Button("Rewind", ImVec2(120, 30))) {
+        // Back to the previous snapshot, or the newest one if no step has run since
+        const bool atNewest = snapshots.Get(0).step == m_simulationSpace.GetStepIndex();
+        m_simulationSpace.RestoreSnapshot(atNewest && snapshots.size() > 1 ? 1 : 0);
+        m_recentBondEvents.clear();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Compare A/B", ImVec2(120, 30))) {
+        m_lastComparison = m_simulationSpace.CompareWithSnapshot(0);
+        m_hasComparison = true;
+    }
+    if (snapshots.empty()) {
+        ImGui::EndDisabled();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Mark A", ImVec2(120, 30))) {
+        m_simulationSpace.TakeSnapshot();
+    }
+    if (m_hasComparison) {
+        ImGui::Text("vs A: max |dr| = %.3e, rms |dr| = %.3e, max |dv| = %.3e",
+                    m_lastComparison.maxDisplacement, m_lastComparison.rmsDisplacement,
+                    m_lastComparison.maxVelocityChange);
+        ImGui::Text("Bonds only in A: %zu, only now: %zu, unmatched atoms: %zu",
+                    m_lastComparison.bondsOnlyInFirst, m_lastComparison.bondsOnlyInSecond,
+                    m_lastComparison.unmatchedAtoms);
+    }
+
+    ImGui::Spacing();
+
     // === ATOM MANAGEMENT SECTION ===
     ImGui::SeparatorText("Atom Management");
 
@@ -120,11 +282,13 @@ void Sandbox2D::OnImGuiRender()
     } else {
         ImGui::Text("Add/Remove Atoms:");
 
-        for (const auto& element : m_availableElements) {
-            ImGui::PushID(element.c_str());
+        for (size_t e = 0; e < Molecular::ElementCount; ++e) {
+            const auto element = static_cast<Molecular::ElementId>(e);
+            const std::string_view symbol = Molecular::GetElementSymbol(element);
+            ImGui::PushID(static_cast<int>(e));
 
             // Display element name and count
-            ImGui::Text("%s (%d):", element.c_str(), GetAtomCount(element));
+            ImGui::Text("%.*s (%d):", static_cast<int>(symbol.size()), symbol.data(), GetAtomCount(element));
             ImGui::SameLine();
 
             // Add button
@@ -171,6 +335,28 @@ if (ImGui::RadioButton("Velocity Verlet", m_simulationSpace.GetIntegrationMethod
     m_simulationSpace.SetIntegrationMethod(Molecular::IntegrationMethod::VelocityVerlet);
 }
 
+if (ImGui::RadioButton("Position Verlet", m_simulationSpace.GetIntegrationMethod() == Molecular::IntegrationMethod::Verlet)) {
+    m_simulationSpace.SetIntegrationMethod(Molecular::IntegrationMethod::Verlet);
+}
+
+if (ImGui::RadioButton("Langevin (BAOAB)", m_simulationSpace.GetIntegrationMethod() == Molecular::IntegrationMethod::Langevin)) {
+    m_simulationSpace.SetIntegrationMethod(Molecular::IntegrationMethod::Langevin);
+}
+
+    if (m_simulationSpace.GetIntegrationMethod() == Molecular::IntegrationMethod::Langevin) {
+        auto targetTemperature = static_cast<float>(m_simulationSpace.GetTargetTemperature());
+        if (ImGui::SliderFloat("Target kT", &targetTemperature, 0.0f, 10.0f, "%.2f")) {
+            m_simulationSpace.SetTargetTemperature(static_cast<double>(targetTemperature));
+        }
+
+        auto friction = static_cast<float>(m_simulationSpace.GetFriction());
+        if (ImGui::SliderFloat("Friction (1/s)", &friction, 0.01f, 100.0f, "%.2f", ImGuiSliderFlags_Logarithmic)) {
+            m_simulationSpace.SetFriction(static_cast<double>(friction));
+        }
+
+        ImGui::Text("Current kT: %.4f", m_simulationSpace.CalculateTemperature());
+    }
+
     double energyLoss = m_simulationSpace.GetEnergyLossFactor();
     auto energyLossF = static_cast<float>(energyLoss);
 
@@ -213,31 +399,184 @@ if (ImGui::RadioButton("Velocity Verlet", m_simulationSpace.GetIntegrationMethod
 
     ImGui::Spacing();
 
+    // === DETERMINISM SECTION ===
+    ImGui::SeparatorText("Deterministic Mode");
+    if (ImGui::Checkbox("Deterministic", &m_deterministic)) {
+        SetDeterministic(m_deterministic);
+    }
+    ImGui::SameLine();
+    if (ImGui::InputInt("Seed", &m_deterministicSeed) && m_deterministic) {
+        SetDeterministic(true);
+    }
+    if (m_deterministic) {
+        const auto& hashes = m_simulationSpace.GetStateHashes();
+        if (!hashes.empty()) {
+            ImGui::Text("Step %llu  hash %016llx", static_cast<unsigned long long>(hashes.back().step),
+                        static_cast<unsigned long long>(hashes.back().hash));
+        }
+        if (ImGui::Button("Save Hash Log", ImVec2(150, 30))) {
+            try {
+                Molecular::WriteStateHashLog(m_hashLogPath, hashes);
+            } catch (const std::exception& e) {
+                MOL_ERROR("Hash log: {}", e.what());
+            }
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Compare With Log", ImVec2(150, 30))) {
+            try {
+                m_lastDivergence = Molecular::FindFirstDivergence(Molecular::ReadStateHashLog(m_hashLogPath), hashes);
+                m_hasDivergence = true;
+            } catch (const std::exception& e) {
+                MOL_ERROR("Hash log: {}", e.what());
+            }
+        }
+        if (m_hasDivergence) {
+            if (m_lastDivergence.diverged) {
+                ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "First divergence at step %llu",
+                                   static_cast<unsigned long long>(m_lastDivergence.step));
+            } else {
+                ImGui::Text("Identical over %zu steps", m_lastDivergence.comparedSteps);
+            }
+        }
+    }
+
+    ImGui::Spacing();
+
     // === ENERGY MONITORING SECTION ===
     ImGui::SeparatorText("Energy Monitoring");
 
     const float totalEnergy = m_simulationSpace.CalculateTotalEnergy();
     ImGui::Text("Total Energy: %.4f eV", totalEnergy);
 
-    const auto& energyHistory = m_simulationSpace.GetEnergyHistory();
+    const auto energyHistory = m_simulationSpace.GetEnergyHistory();
     ImGui::Text("Data Points: %zu", energyHistory.size());
 
     if (!energyHistory.empty()) {
-        ImGui::PlotLines("Energy Over Time", energyHistory.data(),
-                         energyHistory.size(), 0, nullptr, 0.0f,
-                         *std::max_element(energyHistory.begin(), energyHistory.end()),
-                         ImVec2(0, 100));
+        ImGui::SliderFloat("Zoom", &m_plotZoom, 1.0f, 1e4f, "%.0fx", ImGuiSliderFlags_Logarithmic);
+        ImGui::SliderFloat("Scroll", &m_plotScroll, 0.0f, 1.0f, "%.3f");
+
+        // Visible window of the history; scroll 1 keeps the newest sample in view
+        const size_t total = energyHistory.size();
+        const size_t visible = std::max<size_t>(2, static_cast<size_t>(static_cast<double>(total) / m_plotZoom));
+        const size_t count = std::min(visible, total);
+        const size_t first = static_cast<size_t>(static_cast<double>(total - count) * m_plotScroll);
+
+        // One min/max pair per pixel column, drawn as a zig-zag envelope; once
+        // zoomed past one sample per column this is the raw data
+        const size_t columns = std::max<size_t>(1, static_cast<size_t>(ImGui::GetContentRegionAvail().x));
+        m_simulationSpace.GetObservables().GetSeries(Molecular::StandardObservable::TotalEnergy)
+            .Summarize(0, first, count, columns, m_plotSummary);
+        m_plotEnvelope.clear();
+        for (size_t b = 0; b < m_plotSummary.min.size(); ++b) {
+            m_plotEnvelope.push_back(m_plotSummary.min[b]);
+            m_plotEnvelope.push_back(m_plotSummary.max[b]);
+        }
+        const auto [low, high] = std::minmax_element(m_plotEnvelope.begin(), m_plotEnvelope.end());
+        ImGui::PlotLines("Energy Over Time", m_plotEnvelope.data(), static_cast<int>(m_plotEnvelope.size()),
+                         0, nullptr, *low, *high, ImVec2(0, 100));
+        ImGui::Text("Samples %zu-%zu", first, first + count);
+    }
+
+    // Latest value and long-run mean ± standard deviation of every observable
+    auto& observables = m_simulationSpace.GetObservables();
+    if (ImGui::TreeNode("Observables")) {
+        for (size_t k = 0; k < observables.GetCount(); ++k) {
+            ImGui::PushID(static_cast<int>(k));
+            const auto& series = observables.GetSeries(k);
+            const auto& statistics = observables.GetStatistics(k);
+            ImGui::Text("%s: %.4g (mean %.4g +/- %.2g)", observables.GetName(k).c_str(),
+                        series.empty() ? 0.0 : static_cast<double>(series.GetChannel(0).back()),
+                        statistics.GetMean(), statistics.GetStandardDeviation());
+            int interval = observables.GetInterval(k);
+            if (ImGui::SliderInt("Interval", &interval, 0, 100)) {
+                observables.SetInterval(k, interval);
+            }
+            ImGui::PopID();
+        }
+        ImGui::TreePop();
     }
 
     ImGui::Spacing();
     if (ImGui::Button("Export Energy Data", ImVec2(150, 30))) {
-        m_simulationSpace.ExportEnergyDataToCSV();
+        try {
+            MOL_INFO("Exported observables to {}", m_simulationSpace.ExportEnergyDataToCSV());
+        } catch (const std::exception& e) {
+            MOL_ERROR("Export: {}", e.what());
+        }
     }
     ImGui::SameLine();
     if (ImGui::Button("Clear History", ImVec2(120, 30))) {
         m_simulationSpace.ClearEnergyHistory();
     }
 
+    const bool recording = m_simulationSpace.IsRecordingTrajectory();
+    if (ImGui::Button(recording ? "Stop Trajectory" : "Record Trajectory", ImVec2(150, 30))) {
+        try {
+            if (recording) {
+                m_simulationSpace.StopTrajectory();
+            } else {
+                Molecular::TrajectorySettings settings;
+                settings.positionPrecision = 1e-4;
+                m_simulationSpace.StartTrajectory("trajectory.moltraj", settings);
+            }
+        } catch (const std::exception& e) {
+            MOL_ERROR("Trajectory: {}", e.what());
+        }
+    }
+
+    // === CHECKPOINT SECTION ===
+    ImGui::SeparatorText("Checkpoints");
+    if (ImGui::Button("Save Checkpoint", ImVec2(150, 30))) {
+        try {
+            m_simulationSpace.SaveCheckpoint(m_checkpointPath);
+        } catch (const std::exception& e) {
+            MOL_ERROR("Checkpoint: {}", e.what());
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Load Checkpoint", ImVec2(150, 30))) {
+        try {
+            m_simulationSpace.LoadCheckpoint(m_checkpointPath);
+            UpdateAtomCounts();
+        } catch (const std::exception& e) {
+            MOL_ERROR("Checkpoint: {}", e.what());
+        }
+    }
+    bool autoCheckpoint = m_simulationSpace.GetAutoCheckpointInterval() > 0;
+    const bool autoToggled = ImGui::Checkbox("Auto-checkpoint", &autoCheckpoint);
+    ImGui::SameLine();
+    const bool intervalChanged = ImGui::InputInt("Steps", &m_autoCheckpointSteps, 100, 1000);
+    m_autoCheckpointSteps = std::max(1, m_autoCheckpointSteps);
+    if (autoToggled || (autoCheckpoint && intervalChanged)) {
+        m_simulationSpace.SetAutoCheckpoint(m_checkpointPath, autoCheckpoint ? m_autoCheckpointSteps : 0);
+    }
+
+    // === PLAYBACK SECTION ===
+    ImGui::SeparatorText("Playback");
+    if (!m_playback) {
+        if (ImGui::Button("Open Trajectory", ImVec2(150, 30)) && !recording) {
+            OpenPlayback("trajectory.moltraj");
+        }
+    } else {
+        // Scrubbing reads the step and time from the frame index; nothing is loaded up front
+        int frameIndex = static_cast<int>(m_playbackPosition);
+        const int lastFrame = static_cast<int>(m_playback->GetFrameCount()) - 1;
+        if (ImGui::SliderInt("Frame", &frameIndex, 0, lastFrame)) {
+            m_playbackPosition = static_cast<double>(frameIndex);
+        }
+        ImGui::Text("Step %llu, t = %.4f s",
+                    static_cast<unsigned long long>(m_playback->GetStep(static_cast<size_t>(frameIndex))),
+                    m_playback->GetTime(static_cast<size_t>(frameIndex)));
+        ImGui::SliderFloat("Speed (frames/s)", &m_playbackSpeed, -240.0f, 240.0f, "%.0f");
+        if (ImGui::Button(m_playbackPlaying ? "Pause" : "Play", ImVec2(120, 30))) {
+            m_playbackPlaying = !m_playbackPlaying;
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Close Playback", ImVec2(120, 30))) {
+            m_playback.reset();
+        }
+    }
+
     ImGui::Spacing();
 
     // === BOND INFORMATION SECTION ===
@@ -246,28 +585,48 @@ if (ImGui::RadioButton("Velocity Verlet", m_simulationSpace.GetIntegrationMethod
     int totalBonds = m_simulationSpace.GetTotalBondCount();
     ImGui::Text("Total Bonds: %d", totalBonds);
 
-    // Show individual atom bond counts
+    // Species counts are kept incrementally; only the display order is computed here
+    auto& molecules = m_simulationSpace.GetMolecules();
+    std::vector<std::pair<std::string, int>> species;
+    for (const auto& [key, count] : molecules.GetSpeciesCounts()) {
+        species.emplace_back(Molecular::FormatSpecies(key), count);
+    }
+    std::sort(species.begin(), species.end());
+    ImGui::Text("Molecules: %zu", molecules.GetMoleculeCount());
+    for (const auto& [formula, count] : species) {
+        ImGui::BulletText("%s x%d", formula.c_str(), count);
+    }
+
+    Molecular::BondUpdateSettings bondSettings = m_simulationSpace.GetBondUpdateSettings();
+    if (ImGui::SliderInt("Bond Update Interval", &bondSettings.interval, 1, 60)) {
+        m_simulationSpace.SetBondUpdateSettings(bondSettings);
+    }
+
+    for (auto it = m_recentBondEvents.rbegin(); it != m_recentBondEvents.rend(); ++it) {
+        const bool formed = it->type == Molecular::BondEvent::Type::Formed;
+        ImGui::Text("Step %llu: %u %s %u", static_cast<unsigned long long>(it->step),
+                    it->firstId, formed ? "bonded to" : "broke from", it->secondId);
+    }
+
+    // Show individual atom bond counts, labelled by stable id (indices change when atoms are re-sorted)
     const auto& atoms = m_simulationSpace.GetObjects();
     for (size_t i = 0; i < atoms.size(); ++i) {
-        const auto& atom = atoms[i];
-        const int bondCount = atom.GetBonds().size();
+        const auto atom = atoms[i];
+        const int bondCount = atom.GetBondCount();
         const int maxBonds = atom.GetValence();
 
-        ImGui::Text("Atom %zu (%s): %d/%d bonds", i, atom.GetElement().c_str(), bondCount, maxBonds);
+        const std::string_view symbol = atom.GetElement();
+        ImGui::Text("Atom %u (%.*s): %d/%d bonds", atoms.GetId(i), static_cast<int>(symbol.size()), symbol.data(), bondCount, maxBonds);
 
         // Show what it's bonded to
         if (bondCount > 0) {
             ImGui::SameLine();
             ImGui::Text("-> ");
-            for (const auto* bondedAtom : atom.GetBonds()) {
-                // Find the index of the bonded atom
-                for (size_t j = 0; j < atoms.size(); ++j) {
-                    if (&atoms[j] == bondedAtom) {
-                        ImGui::SameLine();
-                        ImGui::Text("%s%zu", j > 0 ? ", " : "", j);
-                        break;
-                    }
-                }
+            bool first = true;
+            for (const uint32_t j : atom.GetBonds()) {
+                ImGui::SameLine();
+                ImGui::Text("%s%u", first ? "" : ", ", atoms.GetId(j));
+                first = false;
             }
         }
     }
@@ -281,11 +640,12 @@ if (ImGui::RadioButton("Velocity Verlet", m_simulationSpace.GetIntegrationMethod
 
     for (size_t i = 0; i < objects.size(); ++i)
     {
-        const auto& obj = objects[i];
+        const auto obj = objects[i];
 
-        ImGui::PushID(static_cast<int>(i));
+        const uint32_t id = objects.GetId(i);
+        ImGui::PushID(static_cast<int>(id));
 
-        if (ImGui::CollapsingHeader(("Atom " + std::to_string(i) + " (" + obj.GetElement() + ")").c_str())) {
+        if (ImGui::CollapsingHeader(("Atom " + std::to_string(id) + " (" + std::string(obj.GetElement()) + ")").c_str())) {
             ImGui::Text("Position: (%.2f, %.2f)", obj.GetPosition().x, obj.GetPosition().y);
             ImGui::Text("Velocity: (%.2f, %.2f)", obj.GetVelocity().x, obj.GetVelocity().y);
             ImGui::Text("Mass: %.3f amu", obj.GetMassD());
@@ -303,7 +663,7 @@ void Sandbox2D::OnEvent(Molecular::Event& e)
     m_cameraController.OnEvent(e);
 }
 
-void Sandbox2D::AddRandomAtom(const std::string& elementType)
+void Sandbox2D::AddRandomAtom(const Molecular::ElementId element)
 {
     glm::vec2 position = GenerateRandomPosition();
 
@@ -315,26 +675,44 @@ void Sandbox2D::AddRandomAtom(const std::string& elementType)
     }
 
     if (attempts < 100) {
-        m_simulationSpace.AddObject(Molecular::Atom(elementType, position));
-        m_atomCounts[elementType]++;
+        m_simulationSpace.AddObject(Molecular::Atom(element, position));
+        m_atomCounts[static_cast<size_t>(element)]++;
     }
     // If we couldn't find a valid position after 100 attempts, we don't add the atom
 }
 
-void Sandbox2D::RemoveLastAtom(const std::string& elementType)
+void Sandbox2D::RemoveLastAtom(const Molecular::ElementId element)
 {
-    auto& atoms = m_simulationSpace.GetObjectsMutable();
+    const auto& atoms = m_simulationSpace.GetObjects();
 
     // Find the last atom of the specified type and remove it
-    for (auto it = atoms.rbegin(); it != atoms.rend(); ++it) {
-        if (it->GetElement() == elementType) {
-            atoms.erase(std::next(it).base());
-            m_atomCounts[elementType]--;
+    for (size_t i = atoms.size(); i-- > 0;) {
+        if (atoms.GetElementId(i) == element) {
+            m_simulationSpace.RemoveObject(i);
+            m_atomCounts[static_cast<size_t>(element)]--;
             break;
         }
     }
 }
 
+void Sandbox2D::MinimizeEnergy()
+{
+    if (m_simulationSpace.IsRunning()) {
+        return;
+    }
+
+    m_lastMinimization = m_simulationSpace.MinimizeEnergy(GetBoundingBox(), m_minimizerSettings);
+    m_hasMinimized = true;
+
+    // Reset should replay from the relaxed configuration
+    m_simulationSpace.SaveInitialState();
+}
+
+Molecular::BoundingBox Sandbox2D::GetBoundingBox() const
+{
+    return {glm::vec2(-m_boundingBoxSize, -m_boundingBoxSize), glm::vec2(m_boundingBoxSize, m_boundingBoxSize)};
+}
+
 glm::vec2 Sandbox2D::GenerateRandomPosition()
 {
     float x = m_positionDistribution(m_rng);
@@ -346,7 +724,7 @@ bool Sandbox2D::IsPositionValid(const glm::vec2& position, const float radius) c
 {
     const auto& atoms = m_simulationSpace.GetObjects();
 
-    for (const auto& atom : atoms) {
+    for (const auto atom : atoms) {
         const float distance = glm::length(position - atom.GetPosition());
 
         if (const float minDistance = radius + atom.GetVanDerWaalsRadius(); distance < minDistance) {
@@ -359,20 +737,31 @@ bool Sandbox2D::IsPositionValid(const glm::vec2& position, const float radius) c
 
 void Sandbox2D::UpdateAtomCounts()
 {
-    for (auto& pair : m_atomCounts) {
-        pair.second = 0;
-    }
+    m_atomCounts.fill(0);
 
     const auto& atoms = m_simulationSpace.GetObjects();
-    for (const auto& atom : atoms) {
-        m_atomCounts[atom.GetElement()]++;
+    for (size_t i = 0; i < atoms.size(); ++i) {
+        m_atomCounts[static_cast<size_t>(atoms.GetElementId(i))]++;
     }
 }
 
-int Sandbox2D::GetAtomCount(const std::string& elementType) const
+int Sandbox2D::GetAtomCount(const Molecular::ElementId element) const
 {
-    auto it = m_atomCounts.find(elementType);
-    return (it != m_atomCounts.end()) ? it->second : 0;
+    return m_atomCounts[static_cast<size_t>(element)];
+}
+
+void Sandbox2D::SetDeterministic(const bool enabled)
+{
+    // Fixed seeds for placement and the thermostat, and a step that ignores frame timing
+    if (enabled) {
+        const auto seed = static_cast<uint32_t>(m_deterministicSeed);
+        m_rng.seed(seed);
+        m_simulationSpace.SetRandomSeed(seed);
+    }
+    m_simulationSpace.SetFixedTimeStep(enabled ? m_deterministicTimeStep : 0.0);
+    m_simulationSpace.SetStateHashing(enabled);
+    m_simulationSpace.ClearStateHashes();
+    m_hasDivergence = false;
 }
 
 void Sandbox2D::SetupDefaultSimulation()
@@ -383,8 +772,8 @@ void Sandbox2D::SetupDefaultSimulation()
 
     m_simulationSpace.ClearAllAtoms();
 
-    m_simulationSpace.AddObject(Molecular::Atom("H", glm::vec2(0.0f, 0.0f)));
-    m_simulationSpace.AddObject(Molecular::Atom("H", glm::vec2(0.3f, 0.0f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::H, glm::vec2(0.0f, 0.0f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::H, glm::vec2(0.3f, 0.0f)));
 
 
     m_simulationSpace.SaveInitialState();
@@ -400,9 +789,9 @@ void Sandbox2D::SetupH2OSimulation()
 
     m_simulationSpace.ClearAllAtoms();
 
-    m_simulationSpace.AddObject(Molecular::Atom("H", glm::vec2(-0.3f, 0.1f)));
-    m_simulationSpace.AddObject(Molecular::Atom("O", glm::vec2(0.0f, 0.0f)));
-    m_simulationSpace.AddObject(Molecular::Atom("H", glm::vec2(0.3f, 0.0f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::H, glm::vec2(-0.3f, 0.1f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::O, glm::vec2(0.0f, 0.0f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::H, glm::vec2(0.3f, 0.0f)));
 
 
     m_simulationSpace.SaveInitialState();
@@ -418,9 +807,9 @@ void Sandbox2D::SetupO3Simulation()
 
     m_simulationSpace.ClearAllAtoms();
 
-    m_simulationSpace.AddObject(Molecular::Atom("O", glm::vec2(-0.3f, 0.0f)));
-    m_simulationSpace.AddObject(Molecular::Atom("O", glm::vec2(0.0f, 0.0f)));
-    m_simulationSpace.AddObject(Molecular::Atom("O", glm::vec2(0.3f, 0.0f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::O, glm::vec2(-0.3f, 0.0f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::O, glm::vec2(0.0f, 0.0f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::O, glm::vec2(0.3f, 0.0f)));
 
 
     m_simulationSpace.SaveInitialState();
@@ -436,11 +825,11 @@ void Sandbox2D::SetupCH4Simulation()
 
     m_simulationSpace.ClearAllAtoms();
 
-    m_simulationSpace.AddObject(Molecular::Atom("H", glm::vec2(0.2f, 0.0f)));
-    m_simulationSpace.AddObject(Molecular::Atom("H", glm::vec2(0.0f, 0.2f)));
-    m_simulationSpace.AddObject(Molecular::Atom("C", glm::vec2(0.0f, 0.0f)));
-    m_simulationSpace.AddObject(Molecular::Atom("H", glm::vec2(-0.2f, 0.0f)));
-    m_simulationSpace.AddObject(Molecular::Atom("H", glm::vec2(0.f, -0.2f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::H, glm::vec2(0.2f, 0.0f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::H, glm::vec2(0.0f, 0.2f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::C, glm::vec2(0.0f, 0.0f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::H, glm::vec2(-0.2f, 0.0f)));
+    m_simulationSpace.AddObject(Molecular::Atom(Molecular::ElementId::H, glm::vec2(0.f, -0.2f)));
 
 
     m_simulationSpace.SaveInitialState();
@@ -455,6 +844,7 @@ void Sandbox2D::ResetSimulation()
     }
 
     m_simulationSpace.ResetSimulation();
+    m_recentBondEvents.clear();
 
     UpdateAtomCounts();
 }
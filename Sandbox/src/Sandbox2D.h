@@ -17,13 +17,13 @@ public:
 private:
 
     struct AtomSetupData {
-        std::string elementType = "H";
+        Molecular::ElementId elementType = Molecular::ElementId::H;
         int count = 1;
     };
 
     // Atom management functions
-    void AddRandomAtom(const std::string& elementType);
-    void RemoveLastAtom(const std::string& elementType);
+    void AddRandomAtom(Molecular::ElementId element);
+    void RemoveLastAtom(Molecular::ElementId element);
 
     void ResetSimulation();
     void SetupDefaultSimulation();
@@ -31,17 +31,26 @@ private:
     void SetupO3Simulation();
     void SetupCH4Simulation();
 
+    void MinimizeEnergy();
+    void SetDeterministic(bool enabled);
+
+    // Trajectory playback
+    void OpenPlayback(const std::string& path);
+    void RenderPlayback(Molecular::Timestep ts);
+    static void DrawBoundary(const Molecular::BoundingBox& box);
+    static void DrawBond(const glm::vec2& from, const glm::vec2& to);
+    Molecular::BoundingBox GetBoundingBox() const;
+
     glm::vec2 GenerateRandomPosition();
     bool IsPositionValid(const glm::vec2& position, float radius) const;
     void UpdateAtomCounts();
-    int GetAtomCount(const std::string& elementType) const;
+    int GetAtomCount(Molecular::ElementId element) const;
 
 
     std::vector<AtomSetupData> m_atomSetupList;
-    std::vector<std::string> m_availableElements = {"H", "O", "C", "N"};
 
-    // Atom count tracking
-    std::unordered_map<std::string, int> m_atomCounts;
+    // Atom count tracking, indexed by ElementId
+    std::array<int, Molecular::ElementCount> m_atomCounts{};
 
     // Simulation bounds
     float m_boundingBoxSize = 1.0f;
@@ -56,5 +65,30 @@ private:
     Molecular::Ref<Molecular::Texture2D> m_texture;
 
     Molecular::SimulationSpace m_simulationSpace;
+    std::vector<Molecular::BondEvent> m_recentBondEvents;
+    float m_plotZoom = 1.0f;        // History length / visible window
+    float m_plotScroll = 1.0f;      // 0 = oldest window, 1 = newest
+    Molecular::SeriesSummary m_plotSummary;
+    std::vector<float> m_plotEnvelope;
+    static constexpr int m_snapshotSteps = 200;
+    static constexpr size_t m_snapshotCapacity = 32;
+    Molecular::StateDifference m_lastComparison;
+    bool m_hasComparison = false;
+    std::string m_checkpointPath = "simulation.molckpt";
+    int m_autoCheckpointSteps = 1000;
+    bool m_deterministic = false;
+    int m_deterministicSeed = 12345;
+    static constexpr double m_deterministicTimeStep = 1.0 / 60.0;
+    std::string m_hashLogPath = "state_hashes.txt";
+    Molecular::Divergence m_lastDivergence;
+    bool m_hasDivergence = false;
+    std::unique_ptr<Molecular::TrajectoryReader> m_playback;
+    double m_playbackPosition = 0.0;    // Fractional frame index; a float stalls slow playback on long runs
+    float m_playbackSpeed = 30.0f;      // Frames per second; negative plays backwards
+    bool m_playbackPlaying = true;
+    static constexpr size_t m_maxRecentBondEvents = 8;
+    Molecular::MinimizerSettings m_minimizerSettings;
+    Molecular::MinimizerResult m_lastMinimization;
+    bool m_hasMinimized = false;
     glm::vec3 m_objectColor = { 0.5f, 0.0f, 0.0f };
 };
@@ -0,0 +1,1725 @@
+#include "vendor/doctest/doctest.h"
+
+#include "Molecular/Physics/SimulationSpace.h"
+#include "Molecular/Physics/ReplicaBatch.h"
+#include "Molecular/Physics/Scenario.h"
+#include "Molecular/Physics/Determinism.h"
+#include "Molecular/Physics/SpatialOrder.h"
+#include "Molecular/Physics/TrajectoryCodec.h"
+#include "Molecular/Physics/TrajectoryReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+using namespace Molecular;
+
+namespace
+{
+    // Atoms this far apart feel essentially no Lennard-Jones force, so the
+    // thermostat is the only thing acting on them.
+    void AddSparseGas(SimulationSpace& space, const int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            space.AddObject(Atom("H", glm::dvec2(-40.0 + 20.0 * i, 0.0)));
+        }
+    }
+
+    const BoundingBox kLargeBox{glm::dvec2(-100.0, -100.0), glm::dvec2(100.0, 100.0)};
+}
+
+// ---------------------------------------------------------------------------
+// Element table
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Elements: symbols are interned at compile time")
+{
+    static_assert(FindElement("C") == ElementId::C);
+    static_assert(GetElementSymbol(ElementId::N) == "N");
+    static_assert(!FindElement("Xe").has_value());
+
+    for (size_t i = 0; i < ElementCount; ++i) {
+        const auto element = static_cast<ElementId>(i);
+        CHECK(ElementFromSymbol(GetElementSymbol(element)) == element);
+    }
+    CHECK_THROWS_AS(Atom("Xe", glm::dvec2(0.0)), std::runtime_error);
+}
+
+TEST_CASE("Elements: atoms carry an id, not a copy of the element data")
+{
+    const Atom oxygen(ElementId::O, glm::dvec2(0.0));
+    CHECK(oxygen.GetElement() == "O");
+    CHECK(oxygen.GetMassD() == doctest::Approx(15.999));
+    CHECK(sizeof(Atom) <= 64);
+}
+
+// ---------------------------------------------------------------------------
+// AtomStore
+// ---------------------------------------------------------------------------
+
+TEST_CASE("AtomStore: hot arrays are cache-line aligned")
+{
+    AtomStore store;
+    store.Add(Atom("H", glm::dvec2(0.0, 0.0)));
+    store.Add(Atom("O", glm::dvec2(1.0, 0.0)));
+    store.Add(Atom("H", glm::dvec2(2.0, 0.0), glm::dvec2(0.5, 0.0)));
+
+    CHECK(store.size() == 3);
+    CHECK(store.GetElementIds()[1] == ElementId::O);
+
+    CHECK(reinterpret_cast<uintptr_t>(store.GetX()) % 64 == 0);
+    CHECK(reinterpret_cast<uintptr_t>(store.GetVY()) % 64 == 0);
+    CHECK(reinterpret_cast<uintptr_t>(store.GetFX()) % 64 == 0);
+
+    const auto atom = store[2];
+    CHECK(atom.GetElement() == "H");
+    CHECK(atom.GetVelocityD().x == doctest::Approx(0.5));
+    CHECK(atom.ToAtom().GetMassD() == doctest::Approx(Atom("H", glm::dvec2(0.0)).GetMassD()));
+}
+
+TEST_CASE("AtomStore: removing an atom keeps bond indices pointing at the same atoms")
+{
+    AtomStore store;
+    store.Add(Atom("C", glm::dvec2(0.0, 0.0)));
+    store.Add(Atom("H", glm::dvec2(0.1, 0.0)));
+    store.Add(Atom("H", glm::dvec2(0.0, 0.1)));
+    store.Add(Atom("H", glm::dvec2(-0.1, 0.0)));
+
+    store.AddBond(0, 2);
+    store.AddBond(0, 3);
+    store.AddBond(0, 1);
+    store.Remove(1);
+
+    REQUIRE(store.size() == 3);
+    CHECK(store[0].GetBondCount() == 2);
+    CHECK(store.IsBondedTo(0, 1));      // formerly atom 2
+    CHECK(store.IsBondedTo(0, 2));      // formerly atom 3
+    CHECK(store.GetPosition(2).x == doctest::Approx(-0.1));
+}
+
+TEST_CASE("AtomStore: bonds fill inline slots up to the valence and keep their order")
+{
+    static_assert(MaxValence == 4);
+
+    AtomStore store;
+    store.Add(Atom("C", glm::dvec2(0.0, 0.0)));
+    for (int k = 0; k < 5; ++k) {
+        store.Add(Atom("H", glm::dvec2(0.1 * (k + 1), 0.0)));
+    }
+    for (size_t k = 1; k <= 5; ++k) {
+        store.AddBond(0, k);
+    }
+
+    CHECK(store[0].GetBondCount() == 4);        // the fifth hydrogen is refused
+    CHECK_FALSE(store.IsBondedTo(0, 5));
+    CHECK_FALSE(store.IsBondedTo(5, 0));
+
+    store.BreakBond(0, 2);
+    const auto& bonds = store.GetBonds(0);
+    REQUIRE(bonds.size() == 3);
+    CHECK(bonds[0] == 1);
+    CHECK(bonds[1] == 3);
+    CHECK(bonds[2] == 4);
+    CHECK_FALSE(store.IsBondedTo(0, 2));
+    CHECK(store.CanFormBond(0));
+}
+
+TEST_CASE("AtomStore: bond count and edge list track topology changes")
+{
+    AtomStore store;
+    store.Add(Atom("O", glm::dvec2(0.0, 0.0)));
+    store.Add(Atom("H", glm::dvec2(0.1, 0.0)));
+    store.Add(Atom("H", glm::dvec2(-0.1, 0.0)));
+
+    store.AddBond(0, 2);
+    store.AddBond(0, 1);
+    CHECK_FALSE(store.AddBond(1, 0));   // already bonded
+    CHECK(store.GetTotalBondCount() == 2);
+
+    const auto& edges = store.GetBondEdges();
+    REQUIRE(edges.size() == 2);
+    CHECK(edges[0].first == 0);
+    CHECK(edges[0].second == 2);
+    CHECK(edges[1].second == 1);
+
+    store.SwapRemove(1);
+    CHECK(store.GetTotalBondCount() == 1);
+    REQUIRE(store.GetBondEdges().size() == 1);
+    CHECK(store.GetBondEdges()[0].first == 0);
+    CHECK(store.GetBondEdges()[0].second == 1);
+
+    store.ClearBonds();
+    CHECK(store.GetTotalBondCount() == 0);
+    CHECK(store.GetBondEdges().empty());
+}
+
+TEST_CASE("AtomStore: handles and bonds follow atoms through swap-removal and permutation")
+{
+    AtomStore store;
+    store.Add(Atom("C", glm::dvec2(0.0, 0.0)));
+    store.Add(Atom("H", glm::dvec2(0.1, 0.0)));
+    store.Add(Atom("O", glm::dvec2(0.0, 0.1)));
+    store.Add(Atom("H", glm::dvec2(-0.1, 0.0)));
+
+    store.AddBond(0, 1);
+    store.AddBond(0, 3);
+    const AtomHandle carbon = store.GetHandle(0);
+    const AtomHandle lastHydrogen = store.GetHandle(3);
+    const AtomHandle oxygen = store.GetHandle(2);
+
+    store.SwapRemove(2);
+    REQUIRE(store.size() == 3);
+    CHECK_FALSE(store.Resolve(oxygen).has_value());
+    REQUIRE(store.Resolve(lastHydrogen) == std::optional<size_t>(2));
+    CHECK(store.IsBondedTo(0, 2));
+    CHECK(store.GetPosition(2).x == doctest::Approx(-0.1));
+
+    // A new atom reuses the freed slot without reviving the old handle
+    store.Add(Atom("N", glm::dvec2(0.3, 0.3)));
+    CHECK_FALSE(store.Resolve(oxygen).has_value());
+
+    store.Permute({3, 2, 1, 0});
+    REQUIRE(store.Resolve(carbon) == std::optional<size_t>(3));
+    CHECK(store.GetElementId(3) == ElementId::C);
+    CHECK(store[3].GetBondCount() == 2);
+    CHECK(store.IsBondedTo(3, 1));
+    CHECK(store.IsBondedTo(3, 2));
+    CHECK(store.GetPosition(*store.Resolve(lastHydrogen)).x == doctest::Approx(-0.1));
+
+    CHECK_THROWS_AS(store.Permute({0, 0, 1, 2}), std::invalid_argument);
+}
+
+TEST_CASE("AtomStore: restored ids invalidate old handles and must be in range")
+{
+    AtomStore store;
+    for (int i = 0; i < 3; ++i) {
+        store.Add(Atom("H", glm::dvec2(0.1 * i, 0.0)));
+    }
+    const AtomHandle first = store.GetHandle(0);
+
+    // A corrupt id would size the slot table; it is refused before anything changes
+    const uint32_t wrapping[] = {0, UINT32_MAX, 1};
+    CHECK_THROWS_AS(store.RestoreIds(wrapping), std::invalid_argument);
+    const uint32_t huge[] = {0, 1u << 30, 1};
+    CHECK_THROWS_AS(store.RestoreIds(huge), std::invalid_argument);
+    const uint32_t duplicate[] = {4, 2, 4};
+    CHECK_THROWS_AS(store.RestoreIds(duplicate), std::invalid_argument);
+    CHECK(store.Resolve(first) == std::optional<size_t>(0));
+
+    const uint32_t ids[] = {0, 5, 2};
+    store.RestoreIds(ids);
+    CHECK(store.GetId(1) == 5);
+    CHECK_FALSE(store.Resolve(first).has_value());
+    CHECK(store.Resolve(store.GetHandle(1)) == std::optional<size_t>(1));
+
+    // Free slots below the highest id are reused without reviving anything
+    store.Add(Atom("O", glm::dvec2(1.0, 0.0)));
+    CHECK(store.GetId(3) < 5);
+    CHECK_FALSE(store.Resolve(first).has_value());
+}
+
+// ---------------------------------------------------------------------------
+// Pair forces — direction
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Lennard-Jones: squeezed atoms repel, distant atoms attract")
+{
+    const ForceCalculator fc;
+    const Atom a("H", glm::dvec2(0.2, 0.0));
+    const Atom near("H", glm::dvec2(0.0, 0.0));
+    const Atom far("H", glm::dvec2(0.6, 0.0));
+
+    CHECK(fc.CalculateVanDerWaalsForce(a, near).x > 0.0);   // pushed away (+x)
+    CHECK(fc.CalculateVanDerWaalsForce(a, far).x > 0.0);    // pulled towards it (+x)
+}
+
+TEST_CASE("Coulomb: like charges repel in 2D")
+{
+    const ForceCalculator fc;
+    Atom a("H", glm::dvec2(1.0, 0.0));
+    Atom b("H", glm::dvec2(0.0, 0.0));
+    a.SetCharge(1.0);
+    b.SetCharge(1.0);
+
+    CHECK(fc.CalculateCoulombForce(a, b).x > 0.0);
+}
+
+// ---------------------------------------------------------------------------
+// Integrator dispatch
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Integrator: every deterministic method coasts a free atom exactly")
+{
+    const IntegrationMethod methods[] = {
+        IntegrationMethod::Euler, IntegrationMethod::RungeKutta4, IntegrationMethod::LeapFrog,
+        IntegrationMethod::VelocityVerlet, IntegrationMethod::Verlet
+    };
+
+    for (const auto method : methods) {
+        CAPTURE(static_cast<int>(method));
+
+        SimulationSpace space;
+        space.SetIntegrationMethod(method);
+        REQUIRE(space.GetIntegrationMethod() == method);
+
+        space.AddObject(Atom("O", glm::dvec2(0.0, 0.0), glm::dvec2(0.5, 0.25)));
+        space.StartSimulation();
+        for (int step = 0; step < 200; ++step) {
+            space.Update(Timestep(1e-3f), kLargeBox);
+        }
+        space.StopSimulation();
+
+        const glm::dvec2 position = space.GetObjects()[0].GetPositionD();
+        CHECK(position.x == doctest::Approx(0.5 * 200 * 1e-3).epsilon(1e-6));
+        CHECK(position.y == doctest::Approx(0.25 * 200 * 1e-3).epsilon(1e-6));
+    }
+}
+
+TEST_CASE("Integrator: velocity Verlet conserves the energy of a bound pair")
+{
+    SimulationSpace space(IntegrationMethod::VelocityVerlet);
+    space.AddObject(Atom("O", glm::dvec2(0.0, 0.0)));
+    space.AddObject(Atom("O", glm::dvec2(0.4, 0.0)));
+
+    const double initialEnergy = space.CalculateTotalEnergy();
+    space.StartSimulation();
+    for (int step = 0; step < 2000; ++step) {
+        space.Update(Timestep(1e-3f), kLargeBox);
+    }
+    space.StopSimulation();
+
+    const auto& atoms = space.GetObjects();
+    CHECK(atoms[0].GetPositionD().x > 0.0);     // the pair attracted and moved
+    CHECK(space.CalculateTotalEnergy() == doctest::Approx(initialEnergy).epsilon(1e-3));
+}
+
+// ---------------------------------------------------------------------------
+// Langevin (BAOAB) thermostat
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Langevin: a gas at rest heats up to the target temperature")
+{
+    SimulationSpace space(IntegrationMethod::Langevin);
+    space.SetTargetTemperature(1.0);
+    space.SetFriction(10.0);
+    AddSparseGas(space, 5);
+    space.StartSimulation();
+
+    // Equilibrate for a few friction times, then average kT over the tail
+    for (int step = 0; step < 2000; ++step) {
+        space.Update(Timestep(1e-3f), kLargeBox);
+    }
+
+    double sum = 0.0;
+    constexpr int samples = 20000;
+    for (int step = 0; step < samples; ++step) {
+        space.Update(Timestep(1e-3f), kLargeBox);
+        sum += space.CalculateTemperature();
+    }
+
+    CHECK(sum / samples == doctest::Approx(1.0).epsilon(0.15));
+}
+
+TEST_CASE("Langevin: large time steps stay bounded")
+{
+    SimulationSpace space(IntegrationMethod::Langevin);
+    space.SetTargetTemperature(1.0);
+    space.SetFriction(50.0);
+    AddSparseGas(space, 5);
+    space.StartSimulation();
+
+    // gamma*dt = 5: an Euler-discretised friction term would blow up here
+    for (int step = 0; step < 500; ++step) {
+        space.Update(Timestep(0.1f), kLargeBox);
+    }
+
+    const double kT = space.CalculateTemperature();
+    CHECK(std::isfinite(kT));
+    CHECK(kT < 10.0);
+}
+
+TEST_CASE("Langevin: the noise is reproducible for a given seed")
+{
+    auto run = [](const uint64_t seed) {
+        SimulationSpace space(IntegrationMethod::Langevin);
+        space.SetRandomSeed(seed);
+        AddSparseGas(space, 3);
+        space.StartSimulation();
+        for (int step = 0; step < 100; ++step) {
+            space.Update(Timestep(1e-3f), kLargeBox);
+        }
+        return space.GetObjects()[1].GetPositionD();
+    };
+
+    CHECK(run(7) == run(7));
+    CHECK(run(7) != run(8));
+}
+
+// ---------------------------------------------------------------------------
+// Energy minimization
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Minimizer: an H-H pair relaxes to the Lennard-Jones minimum")
+{
+    // F = 0 where r + softening = 2^(1/6) * sigma
+    const double expected = std::pow(2.0, 1.0 / 6.0) * 0.2958 - 1e-2;
+
+    for (const auto method : {MinimizerMethod::FIRE, MinimizerMethod::ConjugateGradient}) {
+        CAPTURE(static_cast<int>(method));
+
+        SimulationSpace space;
+        space.AddObject(Atom("H", glm::dvec2(0.0, 0.0)));
+        space.AddObject(Atom("H", glm::dvec2(0.25, 0.0)));
+
+        MinimizerSettings settings;
+        settings.method = method;
+        settings.forceTolerance = 1e-6;
+
+        const MinimizerResult result = space.MinimizeEnergy(kLargeBox, settings);
+        REQUIRE(result.converged);
+
+        const auto& atoms = space.GetObjects();
+        const double separation = glm::length(atoms[1].GetPositionD() - atoms[0].GetPositionD());
+        CHECK(separation == doctest::Approx(expected).epsilon(1e-4));
+    }
+}
+
+TEST_CASE("Minimizer: a crowded cluster converges to the force tolerance")
+{
+    for (const auto method : {MinimizerMethod::FIRE, MinimizerMethod::ConjugateGradient}) {
+        CAPTURE(static_cast<int>(method));
+
+        SimulationSpace space;
+        const char* elements[] = {"H", "O", "C", "N"};
+        for (int i = 0; i < 12; ++i) {
+            space.AddObject(Atom(elements[i % 4], glm::dvec2(0.2 * (i % 4), 0.2 * (i / 4))));
+        }
+
+        MinimizerSettings settings;
+        settings.method = method;
+        settings.forceTolerance = 1e-3;
+
+        const MinimizerResult result = space.MinimizeEnergy(kLargeBox, settings);
+        CHECK(result.converged);
+        CHECK(result.maxForce <= 1e-3);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Position (Stormer) Verlet
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Position Verlet: a free atom coasts and its velocity is reconstructed")
+{
+    SimulationSpace space(IntegrationMethod::Verlet);
+    space.AddObject(Atom("H", glm::dvec2(0.0, 0.0), glm::dvec2(2.0, -1.0)));
+    space.StartSimulation();
+
+    constexpr int steps = 1000;
+    constexpr float dt = 1e-3f;
+    for (int step = 0; step < steps; ++step) {
+        space.Update(Timestep(dt), kLargeBox);
+    }
+    space.StopSimulation();
+
+    const auto atom = space.GetObjects()[0];
+    CHECK(atom.GetPositionD().x == doctest::Approx(2.0 * steps * dt).epsilon(1e-6));
+    CHECK(atom.GetPositionD().y == doctest::Approx(-1.0 * steps * dt).epsilon(1e-6));
+    CHECK(atom.GetVelocityD().x == doctest::Approx(2.0).epsilon(1e-6));
+    CHECK(atom.GetVelocityD().y == doctest::Approx(-1.0).epsilon(1e-6));
+}
+
+TEST_CASE("Position Verlet: pausing and resuming does not change the trajectory")
+{
+    auto run = [](const bool pause) {
+        SimulationSpace space(IntegrationMethod::Verlet);
+        for (int i = 0; i < 12; ++i) {
+            space.AddObject(Atom(i % 3 == 0 ? "O" : "H", glm::dvec2(0.25 * (i % 4), 0.25 * (i / 4))));
+        }
+        space.StartSimulation();
+        for (int step = 1; step <= 100; ++step) {
+            space.Update(Timestep(1e-3f), kLargeBox);
+            if (pause && step == 60) {
+                space.StopSimulation();
+                space.StartSimulation();
+            }
+        }
+        return space.GetObjects();
+    };
+
+    const AtomStore straight = run(false);
+    const AtomStore paused = run(true);
+    CHECK(std::equal(straight.GetX(), straight.GetX() + straight.size(), paused.GetX()));
+    CHECK(std::equal(straight.GetY(), straight.GetY() + straight.size(), paused.GetY()));
+}
+
+TEST_CASE("Position Verlet: walls reflect the implicit velocity")
+{
+    const BoundingBox box{glm::dvec2(-1.0, -1.0), glm::dvec2(1.0, 1.0)};
+
+    SimulationSpace space(IntegrationMethod::Verlet);
+    space.AddObject(Atom("H", glm::dvec2(0.9, 0.0), glm::dvec2(1.0, 0.0)));
+    space.StartSimulation();
+
+    for (int step = 0; step < 300; ++step) {
+        space.Update(Timestep(1e-3f), box);
+    }
+    space.StopSimulation();
+
+    const auto atom = space.GetObjects()[0];
+    CHECK(atom.GetPositionD().x < 1.0);
+    CHECK(atom.GetVelocityD().x == doctest::Approx(-0.9).epsilon(1e-6));   // restitution 0.9
+}
+
+// ---------------------------------------------------------------------------
+// Multi-replica batch
+// ---------------------------------------------------------------------------
+
+TEST_CASE("ReplicaBatch: replicas evolve independently")
+{
+    const BoundingBox box{glm::dvec2(-2.0, -2.0), glm::dvec2(2.0, 2.0)};
+
+    std::vector<Atom> replicaA;
+    replicaA.emplace_back("H", glm::dvec2(0.0, 0.0), glm::dvec2(0.5, 0.0));
+    replicaA.emplace_back("O", glm::dvec2(0.4, 0.1), glm::dvec2(-0.5, 0.2));
+    replicaA.emplace_back("C", glm::dvec2(-0.3, 0.3));
+
+    std::vector<Atom> replicaB = replicaA;
+    replicaB[0].SetPosition(glm::dvec2(1.0, -1.0));
+    replicaB[2].SetVelocity(glm::dvec2(3.0, 3.0));
+
+    ReplicaBatch single;
+    single.AddReplica(replicaA);
+
+    ReplicaBatch batch;
+    batch.AddReplica(replicaB);
+    batch.AddReplica(replicaA);
+    batch.AddReplica(replicaB);
+
+    for (int step = 0; step < 500; ++step) {
+        single.Step(1e-3, box);
+        batch.Step(1e-3, box);
+    }
+
+    for (size_t atom = 0; atom < replicaA.size(); ++atom) {
+        CHECK(batch.GetPosition(1, atom).x == doctest::Approx(single.GetPosition(0, atom).x));
+        CHECK(batch.GetPosition(1, atom).y == doctest::Approx(single.GetPosition(0, atom).y));
+    }
+    CHECK(batch.GetEnergyHistory(1) == single.GetEnergyHistory(0));
+    CHECK(batch.GetPosition(0, 0).x != doctest::Approx(batch.GetPosition(1, 0).x));
+}
+
+TEST_CASE("ReplicaBatch: one energy history per replica on a shared time axis")
+{
+    ReplicaBatch batch;
+    for (int k = 0; k < 3; ++k) {
+        std::vector<Atom> atoms;
+        for (int i = 0; i < 8; ++i) {
+            atoms.emplace_back("H", glm::dvec2(-40.0 + 10.0 * i, 0.0));
+        }
+        batch.AddReplica(atoms);
+    }
+    batch.RandomizeVelocities(1.0, 7);
+
+    for (int step = 0; step < 100; ++step) {
+        batch.Step(1e-3, kLargeBox);
+    }
+
+    REQUIRE(batch.GetReplicaCount() == 3);
+    for (size_t k = 0; k < 3; ++k) {
+        CHECK(batch.GetEnergyHistory(k).size() == batch.GetTimeHistory().size());
+    }
+    CHECK(batch.GetEnergyHistory(0) != batch.GetEnergyHistory(1));
+}
+
+TEST_CASE("ReplicaBatch: replicas must share an atom count")
+{
+    ReplicaBatch batch;
+    batch.AddReplica({Atom("H", glm::dvec2(0.0, 0.0))});
+    CHECK_THROWS_AS(batch.AddReplica({Atom("H", glm::dvec2(0.0, 0.0)), Atom("H", glm::dvec2(1.0, 0.0))}),
+                    std::invalid_argument);
+}
+
+// ---------------------------------------------------------------------------
+// Spatial reordering
+// ---------------------------------------------------------------------------
+
+TEST_CASE("SpatialOrder: Morton codes interleave x into the even bits")
+{
+    CHECK(MortonCode2D(0, 0) == 0);
+    CHECK(MortonCode2D(1, 0) == 1);
+    CHECK(MortonCode2D(0, 1) == 2);
+    CHECK(MortonCode2D(3, 3) == 15);
+    CHECK(MortonCode2D(0xFFFFFFFFu, 0) == 0x5555555555555555ull);
+}
+
+TEST_CASE("SimulationSpace: locality reordering groups neighbours and keeps ids, bonds and the reset point")
+{
+    SimulationSpace space(IntegrationMethod::VelocityVerlet);
+    // Alternate between two far-apart clusters so insertion order is maximally scattered
+    for (int i = 0; i < 4; ++i) {
+        space.AddObject(Atom("H", glm::dvec2(-10.0 + 0.3 * i, -10.0)));
+        space.AddObject(Atom("O", glm::dvec2(10.0 + 0.3 * i, 10.0)));
+    }
+    AtomStore& atoms = space.GetObjectsMutable();
+    atoms.AddBond(1, 3);    // O-O, inside the second cluster
+    const AtomHandle bondedOxygen = atoms.GetHandle(1);
+    const AtomHandle firstHydrogen = atoms.GetHandle(0);
+    space.SaveInitialState();
+
+    space.ReorderForLocality();
+
+    for (size_t i = 0; i < 4; ++i) {
+        CHECK(atoms.GetElementId(i) == ElementId::H);
+        CHECK(atoms.GetElementId(i + 4) == ElementId::O);
+    }
+
+    const auto oxygen = atoms.Resolve(bondedOxygen);
+    REQUIRE(oxygen.has_value());
+    CHECK(atoms.GetPosition(*oxygen).x == doctest::Approx(10.0));
+    REQUIRE(atoms.GetBonds(*oxygen).size() == 1);
+    CHECK(atoms.GetPosition(atoms.GetBonds(*oxygen)[0]).x == doctest::Approx(10.3));
+
+    const size_t hydrogen = *atoms.Resolve(firstHydrogen);
+    atoms.SetPosition(hydrogen, glm::dvec2(0.0, 0.0));
+    space.ResetToInitialPositions();
+    CHECK(atoms.GetPosition(hydrogen).x == doctest::Approx(-10.0));
+}
+
+// ---------------------------------------------------------------------------
+// Bond updates
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    // Reference for the two-phase bond pass: every formable pair, accepted shortest first
+    void FormBondsShortestFirst(AtomStore& atoms)
+    {
+        std::vector<std::tuple<double, size_t, size_t>> proposals;
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            for (size_t j = i + 1; j < atoms.size(); ++j) {
+                if (atoms.CanFormBondWith(i, j)) {
+                    const glm::dvec2 d = atoms.GetPosition(j) - atoms.GetPosition(i);
+                    proposals.emplace_back(d.x * d.x + d.y * d.y, i, j);
+                }
+            }
+        }
+        std::sort(proposals.begin(), proposals.end());
+        for (const auto& [distanceSquared, i, j] : proposals) {
+            atoms.AddBond(i, j);
+        }
+    }
+
+    void AddRandomCluster(SimulationSpace& space, AtomStore& reference, const int count, const double size)
+    {
+        uint64_t state = 12345;
+        auto next = [&state] {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<double>(state >> 11) / static_cast<double>(1ull << 53);
+        };
+        for (int i = 0; i < count; ++i) {
+            const auto element = static_cast<ElementId>(i % static_cast<int>(ElementCount));
+            const Atom atom(element, glm::dvec2(size * next(), size * next()));
+            space.AddObject(atom);
+            reference.Add(atom);
+        }
+    }
+
+    void CheckSameBonds(const AtomStore& atoms, const AtomStore& expected)
+    {
+        REQUIRE(atoms.GetTotalBondCount() == expected.GetTotalBondCount());
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            const auto& bonds = atoms.GetBonds(i);
+            const auto& expectedBonds = expected.GetBonds(i);
+            REQUIRE(bonds.size() == expectedBonds.size());
+            for (size_t k = 0; k < bonds.size(); ++k) {
+                CHECK(bonds[k] == expectedBonds[k]);
+            }
+        }
+    }
+}
+
+TEST_CASE("SimulationSpace: grid bond search forms the same bonds as an all-pairs pass")
+{
+    SimulationSpace space(IntegrationMethod::VelocityVerlet);
+    AtomStore reference;
+    AddRandomCluster(space, reference, 80, 3.0);
+    FormBondsShortestFirst(reference);
+
+    space.StartSimulation();
+    space.UpdateBonds();
+
+    REQUIRE(space.GetTotalBondCount() > 0);
+    CheckSameBonds(space.GetObjects(), reference);
+}
+
+TEST_CASE("SimulationSpace: parallel bond proposals give the serial topology")
+{
+    SimulationSpace serial(IntegrationMethod::VelocityVerlet);
+    SimulationSpace parallel(IntegrationMethod::VelocityVerlet);
+    AtomStore reference, unused;
+    AddRandomCluster(serial, reference, 600, 3.0);
+    AddRandomCluster(parallel, unused, 600, 3.0);
+    FormBondsShortestFirst(reference);
+
+    parallel.SetThreadCount(4);
+    REQUIRE(parallel.GetThreadCount() == 4);
+
+    serial.StartSimulation();
+    parallel.StartSimulation();
+    serial.UpdateBonds();
+    parallel.UpdateBonds();
+
+    CheckSameBonds(serial.GetObjects(), reference);
+    CheckSameBonds(parallel.GetObjects(), reference);
+}
+
+TEST_CASE("BondTracker: cadence, hysteresis and event list")
+{
+    AtomStore atoms;
+    atoms.Add(Atom("H", glm::dvec2(0.0, 0.0)));
+    atoms.Add(Atom("H", glm::dvec2(0.1, 0.0)));
+    atoms.Add(Atom("O", glm::dvec2(5.0, 5.0)));
+
+    BondTracker tracker;
+    tracker.SetSettings({3, 0.1});
+
+    REQUIRE(tracker.Update(atoms, 1));
+    CHECK(atoms.IsBondedTo(0, 1));
+    auto events = tracker.ConsumeEvents();
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].type == BondEvent::Type::Formed);
+    CHECK(events[0].firstId == atoms.GetId(0));
+    CHECK(events[0].secondId == atoms.GetId(1));
+    CHECK(tracker.ConsumeEvents().empty());
+
+    // Off-cadence calls do nothing
+    CHECK_FALSE(tracker.Update(atoms, 2));
+    CHECK_FALSE(tracker.Update(atoms, 3));
+
+    // Past the formation range (0.222) but inside the break range (0.296): the bond holds
+    atoms.SetPosition(1, glm::dvec2(0.25, 0.0));
+    REQUIRE(tracker.Update(atoms, 4));
+    CHECK(atoms.IsBondedTo(0, 1));
+    CHECK(tracker.ConsumeEvents().empty());
+
+    atoms.SetPosition(1, glm::dvec2(0.35, 0.0));
+    tracker.Update(atoms, 5);
+    tracker.Update(atoms, 6);
+    REQUIRE(tracker.Update(atoms, 7));
+    CHECK_FALSE(atoms.IsBondedTo(0, 1));
+    events = tracker.ConsumeEvents();
+    REQUIRE(events.size() == 1);
+    CHECK(events[0].type == BondEvent::Type::Broken);
+    CHECK(events[0].step == 7);
+
+    // Small moves reuse the candidate list
+    const size_t rebuilds = tracker.GetCandidateRebuildCount();
+    atoms.SetPosition(2, glm::dvec2(5.01, 5.0));
+    tracker.Update(atoms, 8);
+    tracker.Update(atoms, 9);
+    tracker.Update(atoms, 10);
+    CHECK(tracker.GetCandidateRebuildCount() == rebuilds);
+}
+
+// ---------------------------------------------------------------------------
+// Molecules
+// ---------------------------------------------------------------------------
+
+TEST_CASE("MoleculeTracker: species are written in Hill order")
+{
+    const SpeciesKey water = 2 * SpeciesOf(ElementId::H) + SpeciesOf(ElementId::O);
+    const SpeciesKey methane = SpeciesOf(ElementId::C) + 4 * SpeciesOf(ElementId::H);
+
+    CHECK(FormatSpecies(water) == "H2O");
+    CHECK(FormatSpecies(methane) == "CH4");
+    CHECK(FormatSpecies(3 * SpeciesOf(ElementId::O)) == "O3");
+    CHECK(CountInSpecies(methane, ElementId::H) == 4);
+}
+
+TEST_CASE("MoleculeTracker: unions on formation, splits only when a bond was the last link")
+{
+    AtomStore atoms;
+    atoms.Add(Atom("O", glm::dvec2(0.0, 0.0)));
+    atoms.Add(Atom("H", glm::dvec2(0.1, 0.0)));
+    atoms.Add(Atom("H", glm::dvec2(-0.1, 0.0)));
+    atoms.Add(Atom("C", glm::dvec2(1.0, 0.0)));
+    atoms.Add(Atom("C", glm::dvec2(1.1, 0.0)));
+    atoms.Add(Atom("C", glm::dvec2(1.05, 0.1)));
+
+    MoleculeTracker molecules;
+    molecules.Rebuild(atoms);
+    CHECK(molecules.GetMoleculeCount() == 6);
+
+    const SpeciesKey water = 2 * SpeciesOf(ElementId::H) + SpeciesOf(ElementId::O);
+    const std::pair<size_t, size_t> bonds[] = {{0, 1}, {0, 2}, {3, 4}, {4, 5}, {5, 3}};
+    for (const auto& [i, j] : bonds) {
+        REQUIRE(atoms.AddBond(i, j));
+        molecules.OnBondFormed(i, j);
+    }
+    REQUIRE(molecules.IsValid(atoms));
+    CHECK(molecules.GetMoleculeCount() == 2);
+    CHECK(molecules.GetSpeciesCount(water) == 1);
+    CHECK(molecules.GetSpeciesCount(3 * SpeciesOf(ElementId::C)) == 1);
+    CHECK(molecules.GetMoleculeId(1) == molecules.GetMoleculeId(2));
+
+    // Opening the carbon ring keeps one molecule
+    atoms.BreakBond(3, 4);
+    molecules.OnBondBroken(atoms, 3, 4);
+    CHECK(molecules.GetMoleculeCount() == 2);
+    CHECK(molecules.GetMoleculeId(3) == molecules.GetMoleculeId(4));
+
+    // Pulling a hydrogen off the water splits it
+    atoms.BreakBond(0, 2);
+    molecules.OnBondBroken(atoms, 0, 2);
+    CHECK(molecules.GetMoleculeCount() == 3);
+    CHECK(molecules.GetSpeciesCount(water) == 0);
+    CHECK(molecules.GetSpeciesCount(SpeciesOf(ElementId::H) + SpeciesOf(ElementId::O)) == 1);
+    CHECK(molecules.GetSpeciesCount(SpeciesOf(ElementId::H)) == 1);
+    CHECK(molecules.GetMoleculeId(2) != molecules.GetMoleculeId(0));
+
+    // Matches a from-scratch rebuild
+    MoleculeTracker rebuilt;
+    rebuilt.Rebuild(atoms);
+    CHECK(rebuilt.GetSpeciesCounts() == molecules.GetSpeciesCounts());
+
+    const auto collected = molecules.CollectMolecules(atoms);
+    REQUIRE(collected.size() == 3);
+    for (const auto& molecule : collected) {
+        if (molecule.species == 3 * SpeciesOf(ElementId::C)) {
+            CHECK(molecule.atomCount == 3);
+            CHECK(molecule.centreOfMass.x == doctest::Approx(1.05));
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Time series
+// ---------------------------------------------------------------------------
+
+TEST_CASE("TimeSeries: overwrites the oldest samples and stays contiguous")
+{
+    TimeSeries series(4, {"a", "b"});
+    for (int k = 0; k < 3; ++k) {
+        series.Append(k, {static_cast<float>(k), static_cast<float>(10 * k)});
+    }
+    REQUIRE(series.size() == 3);
+    CHECK(series.GetTimes().front() == 0.0);
+
+    for (int k = 3; k < 10; ++k) {
+        series.Append(k, {static_cast<float>(k), static_cast<float>(10 * k)});
+    }
+    REQUIRE(series.size() == 4);
+
+    const auto times = series.GetTimes();
+    const auto b = series.GetChannel(1);
+    for (size_t i = 0; i < 4; ++i) {
+        CHECK(times[i] == doctest::Approx(6.0 + static_cast<double>(i)));
+        CHECK(b[i] == doctest::Approx(60.0f + 10.0f * static_cast<float>(i)));
+    }
+    CHECK(series.GetChannelName(1) == "b");
+    CHECK_THROWS_AS(series.Append(10.0, {1.0f}), std::invalid_argument);
+
+    series.Clear();
+    CHECK(series.empty());
+    series.Append(11.0, {1.0f, 2.0f});
+    CHECK(series.GetChannel(0).back() == 1.0f);
+}
+
+TEST_CASE("TimeSeries: summaries match the raw samples at every zoom")
+{
+    TimeSeries series(1000, 1);
+    for (int k = 0; k < 2500; ++k) {
+        series.Append(k, {std::sin(0.01f * static_cast<float>(k)) + 0.001f * static_cast<float>(k % 7)});
+    }
+    const auto raw = series.GetChannel(0);
+
+    auto bruteForce = [&raw](const size_t begin, const size_t end) {
+        float low = raw[begin], high = raw[begin];
+        double sum = 0.0;
+        for (size_t k = begin; k < end; ++k) {
+            low = std::min(low, raw[k]);
+            high = std::max(high, raw[k]);
+            sum += raw[k];
+        }
+        return std::make_tuple(low, high, static_cast<float>(sum / static_cast<double>(end - begin)));
+    };
+
+    // Window starts at absolute sample 1500; 36 in is 1536, a multiple of 64, so
+    // 64-sample buckets line up with level-3 blocks and must be exact
+    SeriesSummary summary;
+    series.Summarize(0, 36, 640, 10, summary);
+    REQUIRE(summary.min.size() == 10);
+    for (size_t b = 0; b < 10; ++b) {
+        const auto [low, high, mean] = bruteForce(36 + 64 * b, 36 + 64 * (b + 1));
+        CHECK(summary.min[b] == low);
+        CHECK(summary.max[b] == high);
+        CHECK(summary.mean[b] == doctest::Approx(mean).epsilon(1e-5));
+    }
+
+    // Unaligned buckets may read past their edges but still bound the data
+    series.Summarize(0, 0, 1000, 7, summary);
+    REQUIRE(summary.min.size() == 7);
+    for (size_t b = 0; b < 7; ++b) {
+        const auto exact = bruteForce(1000 * b / 7, 1000 * (b + 1) / 7);
+        CHECK(summary.min[b] <= std::get<0>(exact));
+        CHECK(summary.max[b] >= std::get<1>(exact));
+    }
+
+    // Zoomed in past one sample per bucket: the raw data itself
+    series.Summarize(0, 990, 50, 400, summary);
+    REQUIRE(summary.mean.size() == 10);
+    for (size_t b = 0; b < 10; ++b) {
+        CHECK(summary.mean[b] == raw[990 + b]);
+    }
+
+    series.Clear();
+    for (int k = 0; k < 16; ++k) {
+        series.Append(k, {static_cast<float>(k)});
+    }
+    series.Summarize(0, 0, 16, 1, summary);
+    CHECK(summary.min[0] == 0.0f);
+    CHECK(summary.max[0] == 15.0f);
+    CHECK(summary.mean[0] == doctest::Approx(7.5f));
+}
+
+// ---------------------------------------------------------------------------
+// Observables
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Observables: Welford statistics match a two-pass computation")
+{
+    const std::vector<double> values = {1e6 + 4.0, 1e6 + 7.0, 1e6 + 13.0, 1e6 + 16.0};
+    RunningStats stats;
+    for (const double value : values) {
+        stats.Add(value);
+    }
+
+    CHECK(stats.GetCount() == 4);
+    CHECK(stats.GetMean() == doctest::Approx(1e6 + 10.0));
+    CHECK(stats.GetVariance() == doctest::Approx(30.0));     // (36 + 9 + 9 + 36) / 3
+
+    stats.Reset();
+    CHECK(stats.GetCount() == 0);
+    CHECK(stats.GetVariance() == 0.0);
+}
+
+TEST_CASE("Observables: samples are computed off-thread at each observable's interval")
+{
+    SimulationSpace space(IntegrationMethod::VelocityVerlet);
+    space.AddObject(Atom("O", glm::dvec2(0.0, 0.0)));
+    space.AddObject(Atom("O", glm::dvec2(0.4, 0.0)));
+
+    auto& observables = space.GetObservables();
+    const size_t atomCount = observables.Register("Atom_Count", 2, [](const ObservableState& state) {
+        return static_cast<double>(state.atoms.size());
+    });
+    REQUIRE(observables.Find("Atom_Count") == atomCount);
+    REQUIRE(observables.GetName(StandardObservable::Pressure) == "Pressure");
+
+    space.StartSimulation();
+    for (int step = 0; step < 20; ++step) {
+        space.Update(Timestep(1e-3f), kLargeBox);
+    }
+    space.StopSimulation();
+    observables.Flush();
+
+    // Standard observables every 5 steps, the custom one every 2
+    const TimeSeries& total = observables.GetSeries(StandardObservable::TotalEnergy);
+    const TimeSeries& kinetic = observables.GetSeries(StandardObservable::KineticEnergy);
+    const TimeSeries& potential = observables.GetSeries(StandardObservable::PotentialEnergy);
+    REQUIRE(total.size() == 4);
+    CHECK(observables.GetSeries(atomCount).size() == 10);
+    CHECK(observables.GetStatistics(atomCount).GetMean() == 2.0);
+    CHECK(space.GetEnergyHistory() == total.GetChannel(0));
+
+    for (size_t k = 0; k < total.size(); ++k) {
+        CHECK(total.GetTimes()[k] == kinetic.GetTimes()[k]);
+        CHECK(total.GetChannel(0)[k] == doctest::Approx(kinetic.GetChannel(0)[k] + potential.GetChannel(0)[k]));
+    }
+
+    // Momentum is conserved by the pair forces
+    const TimeSeries& momentumX = observables.GetSeries(StandardObservable::MomentumX);
+    CHECK(momentumX.GetChannel(0).back() == doctest::Approx(0.0).epsilon(1e-9));
+
+    // A throwing observable surfaces on the owner's thread, from Update or Flush
+    observables.Register("Broken", 1, [](const ObservableState&) -> double {
+        throw std::runtime_error("broken observable");
+    });
+    space.StartSimulation();
+    CHECK_THROWS_AS((space.Update(Timestep(1e-3f), kLargeBox), observables.Flush()), std::runtime_error);
+    space.StopSimulation();
+
+    space.ClearEnergyHistory();
+    CHECK(observables.GetSeries(StandardObservable::TotalEnergy).empty());
+    CHECK(observables.GetStatistics(atomCount).GetCount() == 0);
+}
+
+// ---------------------------------------------------------------------------
+// Trajectory output
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Trajectory: chunks, bond deltas and the trailing index")
+{
+    using namespace TrajectoryFormat;
+    const std::string path = (std::filesystem::temp_directory_path() / "physics2d_writer.moltraj").string();
+
+    AtomStore atoms;
+    atoms.Add(Atom("H", glm::dvec2(0.0, 0.0)));
+    atoms.Add(Atom("O", glm::dvec2(0.1, 0.0)));
+    atoms.Add(Atom("H", glm::dvec2(0.2, 0.0), glm::dvec2(1.0, 2.0)));
+    atoms.AddBond(0, 1);
+
+    TrajectoryWriter writer;
+    writer.Open(path, TrajectorySettings{1, 2, true, true});
+    writer.WriteFrame(atoms, 10, 0.01);             // bond 0-1 formed
+    atoms.AddBond(1, 2);
+    atoms.BreakBond(0, 1);
+    writer.WriteFrame(atoms, 20, 0.02);             // 1-2 formed, 0-1 broken
+    writer.WriteFrame(atoms, 30, 0.03);             // starts chunk 2: restates 1-2
+    writer.Close();
+    CHECK(writer.GetFrameCount() == 3);
+
+    std::ifstream file(path, std::ios::binary);
+    const std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto read = [&bytes](auto& value, const size_t offset) {
+        REQUIRE(offset + sizeof(value) <= bytes.size());
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+    };
+
+    FileHeader header{};
+    read(header, 0);
+    CHECK(std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) == 0);
+    CHECK(header.byteOrderMark == ByteOrderMark);
+    CHECK(header.elementCount == ElementCount);
+    CHECK((header.flags & HasVelocities) != 0);
+
+    ChunkHeader chunk{};
+    const size_t firstChunk = sizeof(FileHeader) + ElementCount * sizeof(ElementRecord);
+    read(chunk, firstChunk);
+    CHECK(chunk.magic == ChunkMagic);
+    CHECK(chunk.frameCount == 2);
+
+    Footer footer{};
+    read(footer, bytes.size() - sizeof(Footer));
+    CHECK(std::memcmp(footer.magic, FooterMagic, sizeof(FooterMagic)) == 0);
+    REQUIRE(footer.frameCount == 3);
+
+    std::vector<FrameIndexEntry> index(3);
+    for (size_t k = 0; k < 3; ++k) {
+        read(index[k], footer.indexOffset + k * sizeof(FrameIndexEntry));
+        CHECK(index[k].step == 10 * (k + 1));
+    }
+    CHECK(index[0].offset == firstChunk + sizeof(ChunkHeader));
+
+    // Second frame: velocities of atom 2, then the two bond deltas
+    FrameHeader frame{};
+    read(frame, index[1].offset);
+    CHECK(frame.atomCount == 3);
+    REQUIRE(frame.bondDeltaCount == 2);
+    const size_t payload = index[1].offset + sizeof(FrameHeader);
+    double vy = 0.0;
+    read(vy, payload + (3 * 3 + 2) * sizeof(double));
+    CHECK(vy == 2.0);
+
+    BondDelta formed{}, broken{};
+    const size_t deltas = payload + 4 * 3 * sizeof(double) + 3 * sizeof(uint32_t) + 3;
+    read(formed, deltas);
+    read(broken, deltas + sizeof(BondDelta));
+    CHECK(formed.formed == 1);
+    CHECK(formed.firstId == atoms.GetId(1));
+    CHECK(formed.secondId == atoms.GetId(2));
+    CHECK(broken.formed == 0);
+    CHECK(broken.firstId == atoms.GetId(0));
+
+    // The third frame follows the second chunk's header
+    const size_t secondFrameEnd = payload + frame.byteCount;
+    CHECK(secondFrameEnd % 8 == 0);
+    CHECK(index[2].offset == secondFrameEnd + sizeof(ChunkHeader));
+    read(frame, index[2].offset);
+    CHECK(frame.bondDeltaCount == 1);
+
+    file.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Trajectory: quantised deltas round-trip within half the precision")
+{
+    using namespace TrajectoryCodec;
+
+    const std::vector<uint64_t> edges = {0, 1, 127, 128, 16383, 16384, ~uint64_t{0}};
+    std::vector<uint8_t> bytes;
+    EncodeVarints(edges.data(), edges.size(), bytes);
+    CHECK(bytes.size() == 1 + 1 + 1 + 2 + 2 + 3 + 10);
+    std::vector<uint64_t> decoded(edges.size());
+    CHECK(DecodeVarints(bytes.data(), bytes.size(), decoded.data(), decoded.size()) == bytes.size());
+    CHECK(decoded == edges);
+    CHECK_THROWS_AS(DecodeVarints(bytes.data(), bytes.size() - 1, decoded.data(), decoded.size()), std::runtime_error);
+    CHECK(UnZigZag(ZigZag(-3)) == -3);
+    CHECK(ZigZag(-1) == 1);
+
+    // A key frame, then a frame that moved a little: the delta codes stay small
+    constexpr double precision = 1e-4;
+    const std::vector<double> first = {0.12345678, -0.5, 3.14159, -2.71828};
+    std::vector<double> second = first;
+    for (double& value : second) value += 0.00123;
+
+    std::vector<int64_t> written(4), previous(4), read(4);
+    std::vector<uint64_t> codes(4);
+    std::vector<double> values(4);
+
+    Quantize(first.data(), 4, precision, nullptr, written.data(), codes.data());
+    Dequantize(codes.data(), 4, precision, true, read.data(), values.data());
+    for (size_t i = 0; i < 4; ++i) {
+        CHECK(std::abs(values[i] - first[i]) <= 0.5 * precision + 1e-12);
+    }
+
+    previous = written;
+    Quantize(second.data(), 4, precision, previous.data(), written.data(), codes.data());
+    for (const uint64_t code : codes) {
+        CHECK(code < 128);      // one varint byte each
+    }
+    Dequantize(codes.data(), 4, precision, false, read.data(), values.data());
+    for (size_t i = 0; i < 4; ++i) {
+        CHECK(std::abs(values[i] - second[i]) <= 0.5 * precision + 1e-12);
+    }
+}
+
+TEST_CASE("Trajectory: quantised files are several times smaller")
+{
+    const auto directory = std::filesystem::temp_directory_path();
+    const std::string rawPath = (directory / "physics2d_raw.moltraj").string();
+    const std::string packedPath = (directory / "physics2d_packed.moltraj").string();
+
+    SimulationSpace space(IntegrationMethod::VelocityVerlet);
+    AtomStore reference;
+    AddRandomCluster(space, reference, 300, 3.0);
+    for (size_t i = 0; i < space.GetObjects().size(); ++i) {
+        space.GetObjectsMutable().SetVelocity(i, glm::dvec2(0.3, -0.2));
+    }
+
+    TrajectoryWriter raw, packed;
+    raw.Open(rawPath);
+    TrajectorySettings settings;
+    settings.positionPrecision = 1e-4;
+    packed.Open(packedPath, settings);
+
+    auto& atoms = space.GetObjectsMutable();
+    for (uint64_t step = 0; step < 128; ++step) {
+        raw.WriteFrame(atoms, step, 1e-3 * static_cast<double>(step));
+        packed.WriteFrame(atoms, step, 1e-3 * static_cast<double>(step));
+        for (size_t i = 0; i < atoms.size(); ++i) {
+            atoms.SetPosition(i, atoms.GetPosition(i) + 1e-3 * atoms.GetVelocity(i));
+        }
+    }
+    raw.Close();
+    packed.Close();
+
+    const auto rawSize = std::filesystem::file_size(rawPath);
+    const auto packedSize = std::filesystem::file_size(packedPath);
+    CHECK(rawSize > 5 * packedSize);
+
+    std::filesystem::remove(rawPath);
+    std::filesystem::remove(packedPath);
+}
+
+TEST_CASE("Trajectory: the reader seeks to any frame, raw or quantised")
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "physics2d_reader.moltraj").string();
+
+    for (const double precision : {0.0, 1e-4}) {
+        CAPTURE(precision);
+
+        AtomStore atoms;
+        for (int i = 0; i < 6; ++i) {
+            atoms.Add(Atom(i % 2 == 0 ? "H" : "O", glm::dvec2(0.1 * i, 0.0), glm::dvec2(0.0, 0.01 * i)));
+        }
+
+        // Frame k: atoms drift by k steps; bond (0,1) lives in frames 2-7, (2,3)
+        // from 5 on, and atom 5 is removed before frame 9
+        TrajectorySettings settings;
+        settings.framesPerChunk = 4;
+        settings.positionPrecision = precision;
+        TrajectoryWriter writer;
+        writer.Open(path, settings);
+        std::vector<std::vector<double>> expectedX;
+        for (uint64_t k = 0; k < 12; ++k) {
+            if (k == 2) atoms.AddBond(0, 1);
+            if (k == 5) atoms.AddBond(2, 3);
+            if (k == 8) atoms.BreakBond(0, 1);
+            if (k == 9) atoms.SwapRemove(5);
+            for (size_t i = 0; i < atoms.size(); ++i) {
+                atoms.SetPosition(i, atoms.GetPosition(i) + glm::dvec2(1e-3, 0.0));
+            }
+            expectedX.emplace_back(atoms.GetX(), atoms.GetX() + atoms.size());
+            writer.WriteFrame(atoms, 10 * k, 0.5 * static_cast<double>(k));
+        }
+        writer.Close();
+
+        TrajectoryReader reader(path);
+        REQUIRE(reader.GetFrameCount() == 12);
+        CHECK(reader.IsQuantized() == (precision > 0.0));
+        CHECK(reader.GetStep(7) == 70);
+        CHECK(reader.FindFrame(3.2) == 6);
+        CHECK(reader.FindFrame(-1.0) == 0);
+
+        // Out of order, across chunks, forwards and backwards
+        const double tolerance = precision > 0.0 ? 0.5 * precision + 1e-12 : 0.0;
+        for (const size_t k : {7u, 3u, 4u, 5u, 11u, 0u, 9u, 6u}) {
+            CAPTURE(k);
+            const TrajectoryFrame& frame = reader.ReadFrame(k);
+            CHECK(frame.step == 10 * k);
+            REQUIRE(frame.x.size() == expectedX[k].size());
+            for (size_t i = 0; i < frame.x.size(); ++i) {
+                CHECK(std::abs(frame.x[i] - expectedX[k][i]) <= tolerance);
+            }
+            CHECK(frame.elements[1] == ElementId::O);
+
+            const bool firstBond = k >= 2 && k < 8;
+            const bool secondBond = k >= 5;
+            CHECK(frame.bonds.size() == static_cast<size_t>(firstBond) + static_cast<size_t>(secondBond));
+            if (secondBond) {
+                const BondEdge& edge = frame.bonds.back();
+                CHECK(frame.ids[edge.first] == atoms.GetId(2));
+                CHECK(frame.ids[edge.second] == atoms.GetId(3));
+            }
+        }
+        CHECK_THROWS_AS(reader.ReadFrame(12), std::out_of_range);
+    }
+
+    std::filesystem::remove(path);
+    CHECK_THROWS_AS(TrajectoryReader{path}, std::runtime_error);
+}
+
+// ---------------------------------------------------------------------------
+// Checkpoint / restart
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    // Hot enough that bonds keep forming and breaking every few bond passes
+    void AddBondingGas(SimulationSpace& space)
+    {
+        space.SetTargetTemperature(20.0);
+        space.SetFriction(5.0);
+        space.SetRandomSeed(4321);
+        for (int i = 0; i < 36; ++i) {
+            space.AddObject(Atom(i % 3 == 0 ? "O" : "H", glm::dvec2(0.25 * (i % 6), 0.25 * (i / 6))));
+        }
+    }
+
+    // BondEvent has no operator==; compare as tuples
+    std::vector<std::tuple<BondEvent::Type, uint32_t, uint32_t, uint64_t>> EventsAfter(
+        const std::vector<BondEvent>& events, const uint64_t step)
+    {
+        std::vector<std::tuple<BondEvent::Type, uint32_t, uint32_t, uint64_t>> result;
+        for (const BondEvent& event : events) {
+            if (event.step > step) {
+                result.emplace_back(event.type, event.firstId, event.secondId, event.step);
+            }
+        }
+        return result;
+    }
+}
+
+TEST_CASE("Checkpoint: a restored space continues exactly where the saved one was")
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "physics2d_restart.molckpt").string();
+
+    auto fill = [](SimulationSpace& space) {
+        space.SetTargetTemperature(0.5);
+        space.SetFriction(5.0);
+        space.SetRandomSeed(1234);
+        for (int i = 0; i < 16; ++i) {
+            space.AddObject(Atom(i % 3 == 0 ? "O" : "H", glm::dvec2(0.25 * (i % 4), 0.25 * (i / 4))));
+        }
+    };
+    auto run = [](SimulationSpace& space, const int steps) {
+        for (int step = 0; step < steps; ++step) {
+            space.Update(Timestep(1e-3f), kLargeBox);
+        }
+    };
+
+    // Langevin draws from the saved seed and step; position Verlet steps from x_prev
+    for (const IntegrationMethod method : {IntegrationMethod::Langevin, IntegrationMethod::Verlet}) {
+        INFO("method " << static_cast<int>(method));
+        SimulationSpace original(method);
+        fill(original);
+        original.SetReorderInterval(7);
+        // Differs from the 1e-3f frame time, so a restart that lost it would drift
+        original.SetFixedTimeStep(1e-3);
+        original.SetStateHashing(true);
+        original.StartSimulation();
+        run(original, 60);
+        original.SaveCheckpoint(path);
+        REQUIRE(original.GetTotalBondCount() > 0);
+        const size_t savedSamples = original.GetObservables().GetSeries(StandardObservable::TotalEnergy).size();
+        run(original, 40);
+
+        // A space with other settings; everything saved must come from the file
+        SimulationSpace restored(IntegrationMethod::Euler, 0.5);
+        restored.AddObject(Atom("N", glm::dvec2(5.0, 5.0)));
+        restored.LoadCheckpoint(path);
+        CHECK_FALSE(restored.IsRunning());
+        CHECK(restored.GetIntegrationMethod() == method);
+        CHECK(restored.GetReorderInterval() == 7);
+        CHECK(restored.GetFixedTimeStep() == 1e-3);
+        CHECK(restored.IsStateHashing());
+        CHECK(restored.GetEnergyLossFactor() == original.GetEnergyLossFactor());
+        CHECK(restored.GetObservables().GetSeries(StandardObservable::TotalEnergy).size() == savedSamples);
+        restored.StartSimulation();
+        run(restored, 40);
+
+        const AtomStore& a = original.GetObjects();
+        const AtomStore& b = restored.GetObjects();
+        REQUIRE(a.size() == b.size());
+        CHECK(std::equal(a.GetX(), a.GetX() + a.size(), b.GetX()));
+        CHECK(std::equal(a.GetVY(), a.GetVY() + a.size(), b.GetVY()));
+        CHECK(original.GetTotalBondCount() == restored.GetTotalBondCount());
+        CHECK(original.GetTimeHistory() == restored.GetTimeHistory());
+        CHECK(original.GetEnergyHistory() == restored.GetEnergyHistory());
+        // x_prev is saved too, so even position Verlet hashes the same after step 60
+        const std::vector<StateHashEntry>& originalHashes = original.GetStateHashes();
+        REQUIRE(originalHashes.size() == 100);
+        const std::vector<StateHashEntry> continued(originalHashes.begin() + 60, originalHashes.end());
+        CHECK_FALSE(FindFirstDivergence(continued, restored.GetStateHashes()).diverged);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Checkpoint: damaged files are rejected and leave the space untouched")
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "physics2d_damaged.molckpt").string();
+
+    SimulationSpace saved;
+    for (int i = 0; i < 4; ++i) {
+        saved.AddObject(Atom("H", glm::dvec2(1.0 * i, 0.0)));
+    }
+    saved.SaveCheckpoint(path);
+    CHECK_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    SimulationSpace target;
+    target.AddObject(Atom("C", glm::dvec2(0.0)));
+
+    // One flipped bit in the payload
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(-3, std::ios::end);
+        const char byte = static_cast<char>(file.get() ^ 0x10);
+        file.seekp(-3, std::ios::end);
+        file.put(byte);
+    }
+    CHECK_THROWS_AS(target.LoadCheckpoint(path), std::runtime_error);
+
+    // Truncated
+    saved.SaveCheckpoint(path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    CHECK_THROWS_AS(target.LoadCheckpoint(path), std::runtime_error);
+    CHECK_THROWS_AS(target.LoadCheckpoint(path + ".missing"), std::runtime_error);
+
+    REQUIRE(target.GetObjects().size() == 1);
+    CHECK(target.GetObjects()[0].GetElementId() == ElementId::C);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Checkpoint: auto-checkpoints are written in the background and restart the run")
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "physics2d_auto.molckpt").string();
+    std::filesystem::remove(path);
+
+    CHECK_THROWS_AS(SimulationSpace().SetAutoCheckpoint("", 10), std::invalid_argument);
+    auto run = [](SimulationSpace& space, std::vector<BondEvent>& events, const int steps) {
+        for (int step = 0; step < steps; ++step) {
+            space.Update(Timestep(1e-3f), kLargeBox);
+            const std::vector<BondEvent> stepEvents = space.ConsumeBondEvents();
+            events.insert(events.end(), stepEvents.begin(), stepEvents.end());
+        }
+    };
+
+    std::vector<BondEvent> originalEvents;
+    AtomStore originalAtoms;
+    {
+        SimulationSpace space(IntegrationMethod::Langevin);
+        AddBondingGas(space);
+        // Only step 42 is due within the run
+        space.SetAutoCheckpoint(path, 42);
+        space.StartSimulation();
+        run(space, originalEvents, 80);
+        originalAtoms = space.GetObjects();
+    }   // The destructor finishes the write in flight
+
+    SimulationSpace restored;
+    restored.LoadCheckpoint(path);
+    REQUIRE(restored.GetStepIndex() == 42);
+    restored.StartSimulation();
+    std::vector<BondEvent> restoredEvents;
+    run(restored, restoredEvents, 38);
+
+    // The checkpoint sits after step 42's bond pass, so the bond cadence and the
+    // trajectory after it line up with the original run
+    const auto expectedEvents = EventsAfter(originalEvents, 42);
+    REQUIRE_FALSE(expectedEvents.empty());
+    CHECK(EventsAfter(restoredEvents, 42) == expectedEvents);
+    const AtomStore& atoms = restored.GetObjects();
+    REQUIRE(atoms.size() == originalAtoms.size());
+    CHECK(std::equal(atoms.GetX(), atoms.GetX() + atoms.size(), originalAtoms.GetX()));
+    CHECK(std::equal(atoms.GetY(), atoms.GetY() + atoms.size(), originalAtoms.GetY()));
+    CHECK(std::equal(atoms.GetVX(), atoms.GetVX() + atoms.size(), originalAtoms.GetVX()));
+    CHECK(std::equal(atoms.GetIds(), atoms.GetIds() + atoms.size(), originalAtoms.GetIds()));
+    CHECK(atoms.GetTotalBondCount() == originalAtoms.GetTotalBondCount());
+
+    std::filesystem::remove(path);
+}
+
+// ---------------------------------------------------------------------------
+// Snapshots
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Snapshots: the ring keeps the newest and survives resizing")
+{
+    SnapshotRing ring(3);
+    CHECK(ring.FindAtOrBefore(100) == 0);
+    for (uint64_t step = 10; step <= 50; step += 10) {
+        ring.Push().step = step;
+    }
+    REQUIRE(ring.size() == 3);
+    CHECK(ring.Get(0).step == 50);
+    CHECK(ring.Get(2).step == 30);
+    CHECK(ring.FindAtOrBefore(45) == 1);
+    CHECK(ring.FindAtOrBefore(29) == ring.size());
+    CHECK_THROWS_AS(static_cast<void>(ring.Get(3)), std::out_of_range);
+
+    ring.SetCapacity(5);
+    ring.Push().step = 60;
+    CHECK(ring.size() == 4);
+    CHECK(ring.Get(0).step == 60);
+    CHECK(ring.Get(3).step == 30);
+
+    ring.DropNewest(2);
+    CHECK(ring.Get(0).step == 40);
+    ring.Push().step = 45;
+    CHECK(ring.Get(1).step == 40);
+
+    ring.SetCapacity(2);
+    CHECK(ring.size() == 2);
+    CHECK(ring.Get(0).step == 45);
+    CHECK(ring.Get(1).step == 40);
+}
+
+TEST_CASE("Snapshots: rewinding replays the same trajectory, and A/B compares by id")
+{
+    SimulationSpace space(IntegrationMethod::Langevin);
+    space.SetTargetTemperature(0.5);
+    space.SetFriction(5.0);
+    for (int i = 0; i < 12; ++i) {
+        space.AddObject(Atom(i % 3 == 0 ? "O" : "H", glm::dvec2(0.25 * (i % 4), 0.25 * (i / 4))));
+    }
+    space.SaveInitialState();
+    const AtomHandle sixth = space.GetObjects().GetHandle(5);
+    // A re-sort restarts the bond cadence; at 30 the replay window still has
+    // bond passes before the next one
+    space.SetReorderInterval(30);
+    space.SetSnapshotInterval(10);
+    space.SetSnapshotCapacity(4);
+    space.StartSimulation();
+
+    std::vector<BondEvent> events;
+    auto run = [&space, &events](const int steps) {
+        for (int step = 0; step < steps; ++step) {
+            space.Update(Timestep(1e-3f), kLargeBox);
+            const std::vector<BondEvent> stepEvents = space.ConsumeBondEvents();
+            events.insert(events.end(), stepEvents.begin(), stepEvents.end());
+        }
+    };
+    run(60);
+    REQUIRE(space.GetSnapshots().size() == 4);      // steps 60, 50, 40, 30
+    CHECK(space.GetSnapshots().Get(3).step == 30);
+
+    // Step 47 is not a snapshot: rewinding 15 steps from 62 lands on 40
+    run(2);
+    const AtomStore atStep62 = space.GetObjects();
+    const auto originalEvents = EventsAfter(events, 40);
+    REQUIRE_FALSE(originalEvents.empty());
+    events.clear();
+    CHECK_FALSE(space.RewindSteps(40));
+    REQUIRE(space.RewindSteps(15));
+    CHECK(space.GetSnapshots().size() == 2);
+    CHECK(space.GetSnapshots().Get(0).step == 40);
+
+    const StateDifference before = space.CompareWithSnapshot(0);
+    CHECK(before.matchedAtoms == 12);
+    CHECK(before.maxDisplacement == 0.0);
+
+    // Same random streams, same cadences: steps 41-62 come out identical, bond
+    // passes included
+    run(22);
+    const AtomStore& atoms = space.GetObjects();
+    CHECK(HashState(atoms) == HashState(atStep62));
+    CHECK(EventsAfter(events, 40) == originalEvents);
+    const StateDifference replay = CompareStates(atStep62, atoms);
+    CHECK(replay.matchedAtoms == 12);
+    CHECK(replay.unmatchedAtoms == 0);
+    CHECK(replay.maxDisplacement == 0.0);
+    CHECK(replay.maxVelocityChange == 0.0);
+    CHECK(replay.bondsOnlyInFirst == 0);
+    CHECK(replay.bondsOnlyInSecond == 0);
+    CHECK(space.CompareWithSnapshot(0).rmsDisplacement > 0.0);
+
+    // The reset point is untouched by all of it
+    space.StopSimulation();
+    space.ResetToInitialPositions();
+    const auto index = space.GetObjects().Resolve(sixth);
+    REQUIRE(index.has_value());
+    CHECK(space.GetObjects().GetPosition(*index).x == doctest::Approx(0.25));
+    CHECK(space.GetObjects().GetPosition(*index).y == doctest::Approx(0.25));
+    CHECK(space.GetTotalBondCount() == 0);
+}
+
+TEST_CASE("Snapshots: a reset forgets the previous run's snapshots")
+{
+    SimulationSpace space(IntegrationMethod::VelocityVerlet);
+    space.AddObject(Atom("O", glm::dvec2(0.0), glm::dvec2(1.0, 0.0)));
+    space.SetSnapshotInterval(5);
+    space.StartSimulation();
+    for (int step = 0; step < 5; ++step) {
+        space.Update(Timestep(1e-3f), kLargeBox);
+    }
+    REQUIRE(space.GetSnapshots().size() == 1);
+
+    space.ResetSimulation();
+    CHECK(space.GetSnapshots().size() == 0);
+    space.StartSimulation();
+    for (int step = 0; step < 8; ++step) {
+        space.Update(Timestep(1e-3f), kLargeBox);
+    }
+    // Only this run's step-5 snapshot is left, and step 8 - 3 is it
+    REQUIRE(space.GetSnapshots().size() == 1);
+    CHECK_FALSE(space.RewindSteps(4));
+    REQUIRE(space.RewindSteps(3));
+    CHECK(space.GetStepIndex() == 5);
+    CHECK(space.GetObjects().GetPosition(0).x == doctest::Approx(0.005));
+}
+
+TEST_CASE("Snapshots: a rewind across a re-sort keeps the reset point aligned")
+{
+    SimulationSpace space(IntegrationMethod::Langevin);
+    space.SetTargetTemperature(0.5);
+    space.SetFriction(5.0);
+    // Row-major is not Morton order, so the re-sort at step 10 permutes
+    for (int i = 0; i < 12; ++i) {
+        space.AddObject(Atom(i % 3 == 0 ? "O" : "H", glm::dvec2(0.25 * (i % 4), 0.25 * (i / 4))));
+    }
+    space.SaveInitialState();
+    std::vector<glm::dvec2> initialById(12);
+    for (size_t i = 0; i < 12; ++i) {
+        initialById[space.GetObjects().GetId(i)] = space.GetObjects().GetPosition(i);
+    }
+    space.SetSnapshotInterval(5);
+    space.SetReorderInterval(10);
+    space.StartSimulation();
+    for (int step = 0; step < 12; ++step) {
+        space.Update(Timestep(1e-3f), kLargeBox);
+    }
+    const uint32_t* ids = space.GetObjects().GetIds();
+    REQUIRE_FALSE(std::is_sorted(ids, ids + 12));
+
+    // Back to step 5, before the re-sort; then edit and reset
+    REQUIRE(space.RewindSteps(7));
+    space.StopSimulation();
+    const uint32_t removedId = space.GetObjects().GetId(5);
+    space.RemoveObject(5);
+    space.ResetToInitialPositions();
+
+    const AtomStore& atoms = space.GetObjects();
+    REQUIRE(atoms.size() == 11);
+    for (size_t i = 0; i < atoms.size(); ++i) {
+        CHECK(atoms.GetId(i) != removedId);
+        CHECK(atoms.GetPosition(i).x == initialById[atoms.GetId(i)].x);
+        CHECK(atoms.GetPosition(i).y == initialById[atoms.GetId(i)].y);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Deterministic mode
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    // A charged mixture dense enough that every pair contributes
+    void AddDeterminismGrid(SimulationSpace& space, const int count)
+    {
+        static const char* const symbols[] = {"H", "O", "C", "N"};
+        for (int i = 0; i < count; ++i) {
+            Atom atom(symbols[i % 4], glm::dvec2(0.45 * (i % 20), 0.45 * (i / 20)));
+            atom.SetCharge(i % 5 == 0 ? 0.2 : (i % 5 == 1 ? -0.2 : 0.0));
+            space.AddObject(atom);
+        }
+    }
+}
+
+TEST_CASE("Determinism: the threaded force pass matches the serial one bit for bit")
+{
+    SimulationSpace space;
+    AddDeterminismGrid(space, 300);
+    AtomStore serial = space.GetObjects();
+    AtomStore threaded = serial;
+
+    ForceCalculator calculator;
+    const double serialMax = calculator.CalculateForces(serial);
+    const double serialVirial = calculator.GetLastVirial();
+
+    ThreadPool pool(4);
+    calculator.SetThreadPool(&pool);
+    const double threadedMax = calculator.CalculateForces(threaded);
+
+    CHECK(threadedMax == serialMax);
+    CHECK(calculator.GetLastVirial() == serialVirial);
+    CHECK(std::equal(serial.GetFX(), serial.GetFX() + serial.size(), threaded.GetFX()));
+    CHECK(std::equal(serial.GetFY(), serial.GetFY() + serial.size(), threaded.GetFY()));
+}
+
+TEST_CASE("Determinism: 1 and 4 threads give identical state hashes, and a nudge is located")
+{
+    auto run = [](const size_t threads, const uint64_t nudgeAfter) {
+        SimulationSpace space(IntegrationMethod::Langevin);
+        AddDeterminismGrid(space, 300);
+        space.SetTargetTemperature(0.5);
+        space.SetFriction(2.0);
+        space.SetRandomSeed(99);
+        space.SetReorderInterval(8);
+        space.SetThreadCount(threads);
+        space.SetFixedTimeStep(1e-3);
+        space.SetStateHashing(true);
+        space.StartSimulation();
+        for (uint64_t step = 1; step <= 30; ++step) {
+            // The frame time varies like wall-clock time would; the fixed step wins
+            space.Update(Timestep(0.01f * static_cast<float>(step % 3 + 1)), kLargeBox);
+            if (step == nudgeAfter) {
+                double& x = space.GetObjectsMutable().GetX()[7];
+                x = std::nextafter(x, 1e9);
+            }
+        }
+        return space.GetStateHashes();
+    };
+
+    const std::vector<StateHashEntry> serial = run(1, 0);
+    const std::vector<StateHashEntry> threaded = run(4, 0);
+    REQUIRE(serial.size() == 30);
+    CHECK(serial.back().step == 30);
+    CHECK_FALSE(FindFirstDivergence(serial, threaded).diverged);
+
+    // One ulp in one coordinate after step 12 shows up at step 13
+    const Divergence divergence = FindFirstDivergence(serial, run(4, 12));
+    CHECK(divergence.diverged);
+    CHECK(divergence.step == 13);
+    CHECK(divergence.comparedSteps == 12);
+
+    // A log that stops early diverges where it stops
+    const std::vector<StateHashEntry> shorter(serial.begin(), serial.begin() + 20);
+    CHECK(FindFirstDivergence(serial, shorter).step == 21);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "physics2d_hashes.txt").string();
+    WriteStateHashLog(path, serial);
+    CHECK_FALSE(FindFirstDivergence(serial, ReadStateHashLog(path)).diverged);
+    std::filesystem::remove(path);
+
+    CHECK_THROWS_AS(SimulationSpace().SetFixedTimeStep(-1.0), std::invalid_argument);
+}
+
+// ---------------------------------------------------------------------------
+// Batch scenarios
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Scenario: files parse into settings and set up a space")
+{
+    std::istringstream text(
+        "# two water-ish atoms and a hydrogen grid\n"
+        "integrator langevin\n"
+        "dt 2e-3   # fixed\n"
+        "steps 50\n"
+        "box -3 -3 3 3\n"
+        "seed 7\n"
+        "temperature 0.25\n"
+        "threads 2\n"
+        "atom O 0.1 0.2 1.0 -1.0 -0.4\n"
+        "atom H 0.5 0.2\n"
+        "grid H 3 2 0.5 -2 -2\n"
+        "\n"
+        "trajectory run.moltraj 25\n"
+        "hash-log run.hashes\n");
+    const Scenario scenario = ParseScenario(text, "test");
+
+    CHECK(scenario.method == IntegrationMethod::Langevin);
+    CHECK(scenario.timeStep == std::optional<double>(2e-3));
+    CHECK(scenario.steps == 50);
+    CHECK(scenario.box.GetMaxPoint().x == 3.0);
+    CHECK(scenario.seed == std::optional<uint64_t>(7));
+    CHECK(scenario.thermostat.targetTemperature == 0.25);
+    REQUIRE(scenario.atoms.size() == 8);
+    CHECK(scenario.atoms[0].GetVelocityD().y == -1.0);
+    CHECK(scenario.atoms[0].GetCharge() == -0.4);
+    CHECK(scenario.atoms[7].GetPositionD() == glm::dvec2(-1.0, -1.5));
+    CHECK(scenario.trajectory.interval == 25);
+
+    SimulationSpace space;
+    space.AddObject(Atom("C", glm::dvec2(0.0)));
+    Scenario quiet = scenario;
+    quiet.trajectoryPath.clear();
+    ApplyScenario(quiet, space);
+    CHECK(space.GetObjects().size() == 8);
+    CHECK(space.GetThreadCount() == 2);
+    CHECK(space.GetFixedTimeStep() == 2e-3);
+    CHECK(space.IsStateHashing());
+    CHECK(space.GetIntegrationMethod() == IntegrationMethod::Langevin);
+
+    // A restart without `dt` or `hash-log` keeps what the checkpoint saved
+    const std::string path = (std::filesystem::temp_directory_path() / "physics2d_scenario.molckpt").string();
+    space.SetFixedTimeStep(5e-4);
+    space.SaveCheckpoint(path);
+    std::istringstream restartText("restart " + path + "\nsteps 10\n");
+    const Scenario restart = ParseScenario(restartText, "restart");
+    CHECK_FALSE(restart.timeStep.has_value());
+    SimulationSpace restarted;
+    ApplyScenario(restart, restarted);
+    CHECK(restarted.GetObjects().size() == 8);
+    CHECK(restarted.GetFixedTimeStep() == 5e-4);
+    CHECK(restarted.IsStateHashing());
+
+    Scenario overridden = restart;
+    overridden.timeStep = 2e-4;
+    ApplyScenario(overridden, restarted);
+    CHECK(restarted.GetFixedTimeStep() == 2e-4);
+    std::filesystem::remove(path);
+
+    // Without a checkpoint the step defaults to 1e-3
+    std::istringstream plainText("atom H 0 0\n");
+    SimulationSpace plain;
+    ApplyScenario(ParseScenario(plainText, "plain"), plain);
+    CHECK(plain.GetFixedTimeStep() == 1e-3);
+    CHECK_FALSE(plain.IsStateHashing());
+
+    auto parseError = [](const std::string& source) -> std::string {
+        std::istringstream input(source);
+        try {
+            static_cast<void>(ParseScenario(input, "bad"));
+        } catch (const std::runtime_error& e) {
+            return e.what();
+        }
+        return "";
+    };
+    CHECK(parseError("atom H 0 0\nintegrator midpoint\n") == "bad:2: unknown integrator 'midpoint'");
+    CHECK(parseError("atom Xx 0 0\n") == "bad:1: unknown element 'Xx'");
+    CHECK(parseError("atom H 0\n") == "bad:1: missing y");
+    CHECK(parseError("atom H 0 0\nsteps -1\n") == "bad:2: '-1' is not a valid step count");
+    CHECK(parseError("atom H 0 0\ndt 1e-3 extra\n") == "bad:2: unexpected 'extra'");
+    CHECK(parseError("steps 10\n") == "bad: no atoms and no restart checkpoint");
+}